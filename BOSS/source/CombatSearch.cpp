@@ -6,6 +6,8 @@ using namespace BOSS;
 // function which is called to do the actual search
 void CombatSearch::search()
 {
+    PROFILE_FUNCTION();
+
     _searchTimer.start();
 
     // apply the opening build order to the initial state
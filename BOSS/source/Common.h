@@ -12,4 +12,16 @@
 
 #include "BOSSAssert.h"
 #include "BaseTypes.h"
-#include "Constants.h"
\ No newline at end of file
+#include "Constants.h"
+
+// Searches show up on the bot's profiler timeline when BOSS is built with BOSS_PROFILING
+// defined and UAlbertaBot/Source on the include path, which BOSS.vcxproj does in Debug and
+// Release. Builds without it, like the Makefile one, compile profiled scopes to nothing.
+#ifdef BOSS_PROFILING
+#include "Profiler.hpp"
+#endif
+
+#ifndef PROFILE_FUNCTION
+#define PROFILE_FUNCTION()
+#define PROFILE_SCOPE(name)
+#endif
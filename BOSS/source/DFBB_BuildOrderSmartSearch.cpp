@@ -13,6 +13,8 @@ DFBB_BuildOrderSmartSearch::DFBB_BuildOrderSmartSearch(const RaceID race)
 
 void DFBB_BuildOrderSmartSearch::doSearch()
 {
+    PROFILE_FUNCTION();
+
     BOSS_ASSERT(_initialState.getRace() != Races::None, "Must set initial state before performing search");
 
     // if we are resuming a search
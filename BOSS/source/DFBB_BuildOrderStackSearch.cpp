@@ -20,6 +20,8 @@ void DFBB_BuildOrderStackSearch::setTimeLimit(double ms)
 // function which is called to do the actual search
 void DFBB_BuildOrderStackSearch::search()
 {
+    PROFILE_FUNCTION();
+
     _searchTimer.start();
 
     if (!_results.solved)
@@ -33,6 +33,12 @@ TTBestMove::TTBestMove(const AlphaBetaMove & first,const AlphaBetaMove & second)
 {
 }
 
+void TTBestMove::set(const AlphaBetaMove & first, const AlphaBetaMove & second)
+{
+    _firstMove = first;
+    _secondMove = second;
+}
+
 const AlphaBetaMove & TTBestMove::firstMove() const 
 { 
     return _firstMove; 
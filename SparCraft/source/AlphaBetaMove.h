@@ -33,6 +33,9 @@ public:
 
 	TTBestMove(const AlphaBetaMove & first, const AlphaBetaMove & second);
 
+	// copies the moves over the ones held, reusing their storage
+	void set(const AlphaBetaMove & first, const AlphaBetaMove & second);
+
 	const AlphaBetaMove & firstMove() const;
 	const AlphaBetaMove & secondMove() const;
 };
@@ -2,10 +2,31 @@
 
 using namespace SparCraft;
 
+static const bool SameMoveVec(const std::vector<Action> & a, const std::vector<Action> & b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+
+    for (size_t i(0); i<a.size(); ++i)
+    {
+        if (a[i].unit() != b[i].unit() || a[i].type() != b[i].type() || a[i].index() != b[i].index())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 AlphaBetaSearch::AlphaBetaSearch(const AlphaBetaSearchParameters & params, TTPtr TT) 
 	: _params(params)
 	, _currentRootDepth(0)
-	, _TT(TT ? TT : TTPtr(new TranspositionTable()))
+	, _historyType(256, 0)
+	, _numHistoryTypes(1)
+	, _TT(TT ? TT : TTPtr(new TranspositionTable(params.transpositionTableSize())))
+	, _playout(new Playout())
 {
     for (size_t p(0); p<Constants::Num_Players; ++p)
     {
@@ -25,8 +46,38 @@ AlphaBetaSearch::AlphaBetaSearch(const AlphaBetaSearchParameters & params, TTPtr
 
 void AlphaBetaSearch::doSearch(GameState & initialState)
 {
+	PROFILE_FUNCTION();
+
 	_searchTimer.start();
 
+	// entries left from earlier searches are replaced before this search's
+	_TT->newGeneration();
+
+	// killers and history are learned over the iterations of one search, the history only
+	// spans the unit types in the state since no units are made during the search
+	std::fill(_historyType.begin(), _historyType.end(), 0);
+	_numHistoryTypes = 1;
+	for (size_t p(0); p < Constants::Num_Players; ++p)
+	{
+		for (size_t u(0); u < initialState.numUnits(p); ++u)
+		{
+			unsigned char & type(_historyType[initialState.getUnit(p, u).type().getID()]);
+			if (type == 0)
+			{
+				type = (unsigned char)_numHistoryTypes++;
+			}
+		}
+	}
+
+	_history.assign(_numHistoryTypes * (ActionTypes::HEAL + 1) * _numHistoryTypes, 0);
+	for (size_t d(0); d < Constants::Max_Search_Depth; ++d)
+	{
+		for (size_t k(0); k < Constants::Num_Killer_Moves; ++k)
+		{
+			_killerMoves[d][k].clear();
+		}
+	}
+
 	StateEvalScore alpha(-10000000, 1000000);
 	StateEvalScore beta	( 10000000, 1000000);
 
@@ -49,6 +100,8 @@ AlphaBetaValue AlphaBetaSearch::IDAlphaBeta(GameState & initialState, const size
 	AlphaBetaValue val;
 	_results.nodesExpanded = 0;
 	_results.maxDepthReached = 0;
+	_results.maxDepthCompleted = 0;
+	_results.depthNodes.clear();
 
 	for (size_t d(1); d < maxDepth; ++d)
 	{
@@ -66,6 +119,8 @@ AlphaBetaValue AlphaBetaSearch::IDAlphaBeta(GameState & initialState, const size
 
 			_results.bestMoves = val.abMove().moveVec();
 			_results.abValue = val.score().val();
+			_results.maxDepthCompleted = d;
+			_results.depthNodes.push_back(_results.nodesExpanded);
 		}
 		// if we do time-out
 		catch (int e)
@@ -100,7 +155,7 @@ void AlphaBetaSearch::TTsave(	GameState & state, const StateEvalScore & value, c
 						const size_t & firstPlayer, const AlphaBetaMove & bestFirstMove, const AlphaBetaMove & bestSecondMove) 
 {
 	// IF THE DEPTH OF THE ENTRY IS BIGGER THAN CURRENT DEPTH, DO NOTHING
-	TTEntry * entry = _TT->lookupScan(state.calculateHash(0), state.calculateHash(1));
+	TTEntry * entry = _TT->lookup(state.calculateHash(0), state.calculateHash(1));
 	bool valid = entry && entry->isValid();
 	size_t edepth = entry ? entry->getDepth() : 0;
 
@@ -124,7 +179,7 @@ void AlphaBetaSearch::TTsave(	GameState & state, const StateEvalScore & value, c
 // Transposition Table look up + alpha/beta update
 TTLookupValue AlphaBetaSearch::TTlookup(const GameState & state, StateEvalScore & alpha, StateEvalScore & beta, const size_t & depth)
 {
-	TTEntry * entry = _TT->lookupScan(state.calculateHash(0), state.calculateHash(1));
+	TTEntry * entry = _TT->lookup(state.calculateHash(0), state.calculateHash(1));
 	if (entry && (entry->getDepth() == depth)) 
 	{
 		// get the value and type of the entry
@@ -189,14 +244,14 @@ const AlphaBetaMove & AlphaBetaSearch::getAlphaBetaMove(const TTLookupValue & TT
 	const size_t enemyPlayer(getEnemy(playerToMove));
 
 	// if we have a valid first move for this player, use it
-	if (TTval.entry()->getBestMove(playerToMove).firstMove().isValid())
+	if (_TT->getBestMove(TTval.entry(), playerToMove).firstMove().isValid())
 	{
-		return TTval.entry()->getBestMove(playerToMove).firstMove();
+		return _TT->getBestMove(TTval.entry(), playerToMove).firstMove();
 	}
 	// otherwise return the response to an opponent move, if it doesn't exist it will just be invalid
 	else
 	{
-		return TTval.entry()->getBestMove(enemyPlayer).secondMove();
+		return _TT->getBestMove(TTval.entry(), enemyPlayer).secondMove();
 	}
 }
 
@@ -261,6 +316,108 @@ void AlphaBetaSearch::generateOrderedMoves(GameState & state, MoveArray & moves,
         {
             int a = 6;
         }
+
+        if (_params.killerHistoryOrdering())
+        {
+            // killer moves that can be played here and aren't already a script move go next
+            for (size_t k(0); k<Constants::Num_Killer_Moves && orderedMoves.size() + 1 < orderedMoves.capacity(); ++k)
+            {
+                std::vector<Action> & killerVec = orderedMoves[orderedMoves.size()];
+
+                if (getKillerMove(moves, _killerMoves[depth][k], killerVec))
+                {
+                    bool duplicate(false);
+                    for (size_t o(0); o<orderedMoves.size() && !duplicate; ++o)
+                    {
+                        duplicate = SameMoveVec(orderedMoves[o], killerVec);
+                    }
+
+                    if (!duplicate)
+                    {
+                        orderedMoves.inc();
+                        _results.killerMoveOrders++;
+                    }
+                }
+            }
+
+            // then the enumerated moves, with each unit's actions in order of history
+            moves.sortMoves([this, &state](const Action & action) { return _history[getHistoryIndex(state, action)]; });
+        }
+    }
+}
+
+const size_t AlphaBetaSearch::getHistoryIndex(const GameState & state, const Action & action) const
+{
+    const Unit & unit(state.getUnit(action.player(), action.unit()));
+    size_t targetType(0);
+
+    if (action.type() == ActionTypes::ATTACK)
+    {
+        targetType = _historyType[state.getUnit(state.getEnemy(action.player()), action.index()).type().getID()];
+    }
+    else if (action.type() == ActionTypes::HEAL)
+    {
+        targetType = _historyType[state.getUnit(action.player(), action.index()).type().getID()];
+    }
+
+    return ((size_t)_historyType[unit.type().getID()] * (ActionTypes::HEAL + 1) + action.type()) * _numHistoryTypes + targetType;
+}
+
+// a killer move is played here if every unit to move has the same action in moves, which
+// are copied into moveVec since a MOVE's destination depends on where the unit is now
+const bool AlphaBetaSearch::getKillerMove(const MoveArray & moves, const std::vector<Action> & killer, std::vector<Action> & moveVec) const
+{
+    if (killer.empty() || killer.size() != moves.numUnits())
+    {
+        return false;
+    }
+
+    moveVec.clear();
+    for (size_t u(0); u<moves.numUnits(); ++u)
+    {
+        const Action & killerAction(killer[u]);
+        if (killerAction.unit() != moves.getUnitID(u))
+        {
+            return false;
+        }
+
+        for (size_t m(0); m<moves.numMoves(u); ++m)
+        {
+            const Action & action(moves.getMove(u, m));
+            if (action.type() == killerAction.type() && action.index() == killerAction.index())
+            {
+                moveVec.push_back(action);
+                break;
+            }
+        }
+
+        if (moveVec.size() != u + 1)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AlphaBetaSearch::updateKillerHistory(const GameState & state, const std::vector<Action> & moveVec, const size_t & depth)
+{
+    Array<std::vector<Action>, Constants::Num_Killer_Moves> & killers(_killerMoves[depth]);
+
+    // the newest killer goes first, pushing the oldest out
+    if (!SameMoveVec(killers[0], moveVec))
+    {
+        for (size_t k(Constants::Num_Killer_Moves - 1); k > 0; --k)
+        {
+            killers[k].swap(killers[k-1]);
+        }
+
+        killers[0].assign(moveVec.begin(), moveVec.end());
+    }
+
+    for (size_t a(0); a<moveVec.size(); ++a)
+    {
+        _history[getHistoryIndex(state, moveVec[a])] += (unsigned int)(depth * depth);
     }
 }
 
@@ -377,7 +534,7 @@ AlphaBetaValue AlphaBetaSearch::alphaBeta(GameState & state, size_t depth, const
 	if (terminalState(state, depth))
 	{
 		// return the value, but the move will not be valid since none was performed
-        StateEvalScore evalScore = state.eval(_params.maxPlayer(), _params.evalMethod(), _params.simScript(Players::Player_One), _params.simScript(Players::Player_Two));
+        StateEvalScore evalScore = state.eval(_params.maxPlayer(), _params.evalMethod(), _params.simScript(Players::Player_One), _params.simScript(Players::Player_Two), _playout.get());
 		
 		return AlphaBetaValue(StateEvalScore(evalScore.val(), state.getNumMovements(_params.maxPlayer()) + evalScore.numMoves() ), AlphaBetaMove());
 	}
@@ -486,6 +643,11 @@ AlphaBetaValue AlphaBetaSearch::alphaBeta(GameState & state, size_t depth, const
 		// alpha-beta cut
 		if (alpha >= beta) 
 		{ 
+			if (_params.killerHistoryOrdering())
+			{
+				updateKillerHistory(state, moveVec, depth);
+			}
+
 			break; 
 		}
 
@@ -8,6 +8,7 @@
 #include "Action.h"
 #include "Array.hpp"
 #include "MoveArray.h"
+#include "Playout.h"
 #include "TranspositionTable.h"
 #include "Player.h"
 
@@ -38,11 +39,26 @@ class AlphaBetaSearch
 			Constants::Max_Search_Depth, 
 			Constants::Max_Ordered_Moves>   _orderedMoves;
 
+	// the last moves to cause a cut at each depth, tried right after the script moves
+	Array2D<std::vector<Action>, 
+			Constants::Max_Search_Depth, 
+			Constants::Num_Killer_Moves>    _killerMoves;
+
+	// how much each (unit type, action type, target type) has caused cuts this search, weighted
+	// by depth, enumerated moves try the unit actions with the most history first. Unit types
+	// are numbered by _historyType over the types in the searched state, index 0 being None
+	std::vector<unsigned int>               _history;
+	std::vector<unsigned char>              _historyType;
+	size_t                                  _numHistoryTypes;
+
     std::vector<PlayerPtr>					_allScripts[Constants::Num_Players];
     PlayerPtr                               _playerModels[Constants::Num_Players];
 
 	TTPtr                                   _TT;
 
+	// plays out the leaves when they are evaluated by playout
+	PlayoutPtr                              _playout;
+
 public:
 
 	AlphaBetaSearch(const AlphaBetaSearchParameters & params, TTPtr TT = TTPtr((TranspositionTable *)NULL));
@@ -74,6 +90,11 @@ public:
 	const bool terminalState(GameState & state, const size_t & depth) const;
 	const bool isTranspositionLookupState(GameState & state, const std::vector<Action> * firstSimMove) const;
 
+	// killer moves and history heuristic
+	const size_t getHistoryIndex(const GameState & state, const Action & action) const;
+	const bool getKillerMove(const MoveArray & moves, const std::vector<Action> & killer, std::vector<Action> & moveVec) const;
+	void updateKillerHistory(const GameState & state, const std::vector<Action> & moveVec, const size_t & depth);
+
 	void printTTResults() const;
 };
 }
\ No newline at end of file
@@ -20,6 +20,8 @@ class SparCraft::AlphaBetaSearchParameters
     size_t          _simScripts[2];                 // NOKDPS               Policy to use for playouts
 	size_t		    _playerToMoveMethod;		    // Alternate			The player to move policy
 	size_t		    _playerModel[2];                // None                 Player model to use for each player
+    size_t          _transpositionTableSize;        // 100000               Entries in the transposition table the search makes
+    bool            _killerHistoryOrdering;         // false                Try killer moves after the scripts, enumerate moves by history
 
     std::string     _graphVizFilename;              // ""                   File name to output graph viz file
 
@@ -39,6 +41,8 @@ public:
         , _moveOrdering         (MoveOrderMethod::ScriptFirst)
         , _evalMethod           (SparCraft::EvaluationMethods::Playout)
 	    , _playerToMoveMethod   (SparCraft::PlayerToMove::Alternate)
+        , _transpositionTableSize(Constants::Transposition_Table_Size)
+        , _killerHistoryOrdering(false)
     {
 	    setPlayerModel(Players::Player_One, PlayerModels::None);
 	    setPlayerModel(Players::Player_Two, PlayerModels::None);
@@ -55,6 +59,8 @@ public:
     const size_t & simScript(const size_t & player)             const   { return _simScripts[player]; }
     const size_t & playerToMoveMethod()				            const   { return _playerToMoveMethod; }
     const size_t & playerModel(const size_t & player)	        const   { return _playerModel[player]; }
+    const size_t & transpositionTableSize()                     const   { return _transpositionTableSize; }
+    const bool & killerHistoryOrdering()                        const   { return _killerHistoryOrdering; }
     const std::string & graphVizFilename()                      const   { return _graphVizFilename; }
     const std::vector<size_t> & getOrderedMoveScripts()         const   { return _orderedMoveScripts; }
 	
@@ -71,6 +77,8 @@ public:
     void setGraphVizFilename(const std::string & filename)              { _graphVizFilename = filename; }
     void addOrderedMoveScript(const size_t & script)                    { _orderedMoveScripts.push_back(script); }
     void setPlayerModel(const size_t & player, const size_t & model)	{ _playerModel[player] = model; }	
+    void setTranspositionTableSize(const size_t & entries)              { _transpositionTableSize = entries; }
+    void setKillerHistoryOrdering(const bool & ordering)                { _killerHistoryOrdering = ordering; }
 
     std::vector<std::vector<std::string> > & getDescription()
     {
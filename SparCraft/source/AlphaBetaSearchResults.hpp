@@ -22,6 +22,9 @@ public:
 	ScoreType			abValue;
 	unsigned long long  ttcuts;
 	size_t				maxDepthReached;	
+	size_t				maxDepthCompleted;	// deepest ID-AB iteration finished within the time limit
+
+	std::vector<unsigned long long> depthNodes;	// nodes expanded when each ID-AB depth was finished, from depth 1
 
 	size_t				ttMoveOrders;
 	size_t				ttFoundButNoMove;
@@ -29,6 +32,7 @@ public:
 	size_t				ttFoundCheck;
 	size_t				ttFoundLessDepth;
 	size_t				ttSaveAttempts;
+	size_t				killerMoveOrders;
 
     std::vector<std::vector<std::string> > _desc;    // 2-column description vector
 	
@@ -41,12 +45,14 @@ public:
 		, abValue(0)
 		, ttcuts(0)
 		, maxDepthReached(0)
+		, maxDepthCompleted(0)
 		, ttMoveOrders(0)
 		, ttFoundButNoMove(0)
 		, ttFoundNoCut(0)
 		, ttFoundCheck(0)
 		, ttFoundLessDepth(0)
 		, ttSaveAttempts(0)
+		, killerMoveOrders(0)
 	{
 	}
 
@@ -61,10 +67,12 @@ public:
         _desc[0].push_back("Nodes Searched: ");
         _desc[0].push_back("AB Value: ");
         _desc[0].push_back("Max Depth: ");
+        _desc[0].push_back("Depth Completed: ");
 
         ss << nodesExpanded;       _desc[1].push_back(ss.str()); ss.str(std::string());
         ss << abValue;              _desc[1].push_back(ss.str()); ss.str(std::string());
         ss << maxDepthReached;     _desc[1].push_back(ss.str()); ss.str(std::string());
+        ss << maxDepthCompleted;   _desc[1].push_back(ss.str()); ss.str(std::string());
         
         return _desc;
     }
@@ -15,6 +15,18 @@
 #include "Logger.h"
 #include "SparCraftAssert.h"
 
+// Searches show up on the bot's profiler timeline when SparCraft is built with SPARCRAFT_PROFILING
+// defined and UAlbertaBot/Source on the include path, which SparCraft.vcxproj does in Debug and
+// Release. Builds without it, like the Makefile one, compile profiled scopes to nothing.
+#ifdef SPARCRAFT_PROFILING
+#include "Profiler.hpp"
+#endif
+
+#ifndef PROFILE_FUNCTION
+#define PROFILE_FUNCTION()
+#define PROFILE_SCOPE(name)
+#endif
+
 extern char SPARCRAFT_LOGFILE[100];
 
 namespace SparCraft
@@ -37,6 +49,9 @@ namespace SparCraft
 		// max number of ordered moves in a search depth
 		const size_t Max_Ordered_Moves			= 10;
 
+		// number of killer moves kept for each search depth
+		const size_t Num_Killer_Moves			= 2;
+
 		// distance moved for a 'move' command
 		const size_t Move_Distance				= 16;
 
@@ -56,7 +71,6 @@ namespace SparCraft
 		// whether to use transposition table in search
 		const bool   Use_Transposition_Table	= true;
 		const size_t Transposition_Table_Size	= 100000;
-		const size_t Transposition_Table_Scan	= 10;
 		const size_t Num_Hashes					= 2;
         
         // UCT options
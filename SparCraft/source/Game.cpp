@@ -27,6 +27,8 @@ Game::Game(const GameState & initialState, PlayerPtr & p1, PlayerPtr & p2, const
 // play the game until there is a winner
 void Game::play()
 {
+    PROFILE_FUNCTION();
+
     scriptMoves[Players::Player_One] = std::vector<Action>(state.numUnits(Players::Player_One));
     scriptMoves[Players::Player_Two] = std::vector<Action>(state.numUnits(Players::Player_Two));
 
@@ -1,6 +1,11 @@
 #include "GameState.h"
 #include "Player.h"
 #include "Game.h"
+#include "Playout.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 using namespace SparCraft;
 
@@ -26,8 +31,124 @@ public:
     }
 };
 
+// LTD and LTD2 are summed in fixed point, so taking a unit's share back out of the
+// sum when it is hit leaves no rounding error behind
+const double LTDScale = 1 << 20;
+
+static long long LTDShare(const Unit & unit, const HealthType & hp)
+{
+    return hp > 0 ? (long long)(hp * unit.dpf() * LTDScale + 0.5) : 0;
+}
+
+static long long LTD2Share(const Unit & unit, const HealthType & hp)
+{
+    return hp > 0 ? (long long)(UnitProperties::GetSqrtHP(hp) * unit.dpf() * LTDScale + 0.5) : 0;
+}
+
+// index of the lowest set bit, bits can't be 0
+static size_t LowestBit(const unsigned long long bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)bits))
+    {
+        return index;
+    }
+
+    _BitScanForward(&index, (unsigned long)(bits >> 32));
+    return 32 + index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// the furthest any detector can see, which bounds the detectors isDetected has to check
+static PositionType MaxDetectorSightRange()
+{
+    // initialized once in a thread safe way, states are evaluated from several threads
+    static const PositionType maxSight = []()
+    {
+        PositionType sight(0);
+        for (const BWAPI::UnitType & type : BWAPI::UnitTypes::allUnitTypes())
+        {
+            if (type.isDetector())
+            {
+                sight = std::max(sight, (PositionType)type.sightRange());
+            }
+        }
+
+        return sight;
+    }();
+
+    return maxSight;
+}
+
+UnitMask::UnitMask()
+{
+    clear();
+}
+
+void UnitMask::clear()
+{
+    std::fill(_bits, _bits + Words, 0ULL);
+}
+
+void UnitMask::set(const size_t & unit)
+{
+    _bits[unit / 64] |= 1ULL << (unit % 64);
+}
+
+void UnitMask::setFirst(const size_t & numUnits)
+{
+    for (size_t w(0); w < Words; ++w)
+    {
+        const size_t first(w * 64);
+        _bits[w] = numUnits >= first + 64 ? ~0ULL : (numUnits > first ? (1ULL << (numUnits - first)) - 1 : 0ULL);
+    }
+}
+
+UnitMask & UnitMask::operator |= (const UnitMask & rhs)
+{
+    for (size_t w(0); w < Words; ++w)
+    {
+        _bits[w] |= rhs._bits[w];
+    }
+
+    return *this;
+}
+
+UnitMask & UnitMask::operator &= (const UnitMask & rhs)
+{
+    for (size_t w(0); w < Words; ++w)
+    {
+        _bits[w] &= rhs._bits[w];
+    }
+
+    return *this;
+}
+
+const bool UnitMask::operator == (const UnitMask & rhs) const
+{
+    return std::equal(_bits, _bits + Words, rhs._bits);
+}
+
+const size_t UnitMask::next(const size_t & unit) const
+{
+    for (size_t w(unit / 64); w < Words; ++w)
+    {
+        const unsigned long long bits(w == unit / 64 ? _bits[w] & (~0ULL << (unit % 64)) : _bits[w]);
+
+        if (bits)
+        {
+            return w * 64 + LowestBit(bits);
+        }
+    }
+
+    return Constants::Max_Units;
+}
+
 // default constructor
-GameState::GameState()
+GameStateData::GameStateData()
 	: _map(NULL)
 	, _currentTime(0)
 	, _maxUnits(Constants::Max_Units)
@@ -37,6 +158,17 @@ GameState::GameState()
 	_prevNumUnits.fill(0);
 	_numMovements.fill(0);
     _prevHPSum.fill(0);
+    _totalLTD.fill(0);
+    _totalSumSQRT.fill(0);
+    _currentLTD.fill(0);
+    _currentLTD2.fill(0);
+    _currentHPSum.fill(0);
+}
+
+GameState::GameState()
+{
+    _touched.fill(false);
+    invalidateGrid();
 
     _units[0] = std::vector<Unit>(Constants::Max_Units, Unit());
     _units[1] = std::vector<Unit>(Constants::Max_Units, Unit());
@@ -53,6 +185,8 @@ GameState::GameState()
 // construct state from a save file
 GameState::GameState(const std::string & filename)
 {
+    _touched.fill(false);
+    invalidateGrid();
     read(filename);
 }
 
@@ -65,20 +199,11 @@ void GameState::finishedMoving()
 	// update the current time of the state
 	updateGameTime();
 
-    // calculate the hp sum of each player
-    int hpSum[2];
-    for (size_t p(0); p<Constants::Num_Players; ++p)
-	{
-		hpSum[p] = 0;
-
-		for (size_t u(0); u<numUnits(p); ++u)
-		{ 
-            hpSum[p] += getUnit(p, u).currentHP();
-        }
-    }
+    // units have been sorted and time has passed, so the grid is out of date
+    invalidateGrid();
 
     // if the hp sums match the last hp sum
-    if (hpSum[0] == _prevHPSum[0] && hpSum[1] == _prevHPSum[1])
+    if (_currentHPSum[0] == _prevHPSum[0] && _currentHPSum[1] == _prevHPSum[1])
     {
         _sameHPFrames++;
     }
@@ -89,7 +214,7 @@ void GameState::finishedMoving()
 
     for (size_t p(0); p<Constants::Num_Players; ++p)
 	{
-        _prevHPSum[p] = hpSum[p];
+        _prevHPSum[p] = _currentHPSum[p];
     }
 }
 
@@ -122,6 +247,9 @@ void GameState::generateMoves(MoveArray & moves, const size_t & playerIndex) con
         System::FatalError("GameState Error - Called generateMoves() for a player that cannot currently move");
     }
 
+	// the actions themselves are generated by generateNextMove as the MoveArray needs them
+	moves.setState(this, playerIndex);
+
 	// we are interested in all simultaneous moves
 	// so return all units which can move at the same time as the first
 	TimeType firstUnitMoveTime = getUnit(playerIndex, 0).firstTimeFree();
@@ -144,116 +272,155 @@ void GameState::generateMoves(MoveArray & moves, const size_t & playerIndex) con
 		}
 
 		moves.addUnit();
+	}
 
-		// generate attack moves
-		if (unit.canAttackNow())
-		{
-			for (size_t u(0); u<_numUnits[enemyPlayer]; ++u)
-			{
-				const Unit & enemyUnit(getUnit(enemyPlayer, u));
-				bool invisible = false;
-				if (enemyUnit.type().hasPermanentCloak())
-				{
-					invisible = true;
-					for (size_t detectorIndex(0); detectorIndex < _numUnits[playerIndex]; ++detectorIndex)
-					{
-						// unit reference
-						const Unit & detector(getUnit(playerIndex, detectorIndex));
-						if (detector.type().isDetector() && detector.canSeeTarget(enemyUnit, _currentTime))
-						{
-							invisible = false;
-							break;
-						}
-					}
-				}
-				if (!invisible && unit.canAttackTarget(enemyUnit, _currentTime) && enemyUnit.isAlive())
-				{
-					moves.add(Action(unitIndex, playerIndex, ActionTypes::ATTACK, u));
-                    //moves.add(Action(unitIndex, playerIndex, ActionTypes::ATTACK, unit.ID()));
-				}
-			}
-		}
-		else if (unit.canHealNow())
-		{
-			for (size_t u(0); u<_numUnits[playerIndex]; ++u)
-			{
-				// units cannot heal themselves in broodwar
-				if (u == unitIndex)
-				{
-					continue;
-				}
-
-				const Unit & ourUnit(getUnit(playerIndex, u));
-				if (unit.canHealTarget(ourUnit, _currentTime) && ourUnit.isAlive())
-				{
-					moves.add(Action(unitIndex, playerIndex, ActionTypes::HEAL, u));
-                    //moves.add(Action(unitIndex, playerIndex, ActionTypes::HEAL, unit.ID()));
-				}
-			}
-		}
-		// generate the wait move if it can't attack yet
-		else
-		{
-			if (!unit.canHeal())
-			{
-				moves.add(Action(unitIndex, playerIndex, ActionTypes::RELOAD, 0));
-			}
-		}
-		
-		// generate movement moves
-		if (unit.isMobile())
-		{
-            // In order to not move when we could be shooting, we want to move for the minimum of:
-            // 1) default move distance move time
-            // 2) time until unit can attack, or if it can attack, the next cooldown
-            double timeUntilAttack          = unit.nextAttackActionTime() - getTime();
-            timeUntilAttack                 = timeUntilAttack == 0 ? unit.attackCooldown() : timeUntilAttack;
-
-            // the default move duration
-            double defaultMoveDuration      = (double)Constants::Move_Distance / unit.speed();
-
-            // if we can currently attack
-			double chosenTime = timeUntilAttack != 0 ? std::min(timeUntilAttack, defaultMoveDuration) : defaultMoveDuration;
+    moves.resetMoveIterator();
+}
 
-            // the chosen movement distance
-            PositionType moveDistance       = (PositionType)(chosenTime * unit.speed());
+// generates the unit's next action after the ones the generator has already given, in the
+// order attacks or heals, reload, movement, and a pass if the unit had nothing else to do
+const bool GameState::generateNextMove(MoveGenerator & generator, const size_t & playerIndex, const size_t & unitIndex, Action & move) const
+{
+    const Unit & unit(getUnit(playerIndex, unitIndex));
+	const size_t enemyPlayer(getEnemy(playerIndex));
 
-            // DEBUG: If chosen move distance is ever 0, something is wrong
-            if (moveDistance == 0)
+    while (true)
+    {
+        switch (generator.stage)
+        {
+            case MoveGenerator::Targets:
             {
-                System::FatalError("Move Action with distance 0 generated. timeUntilAttack:"+
-					std::to_string(timeUntilAttack)+", speed:"+std::to_string(unit.speed()));
+		        // generate attack moves
+		        if (unit.canAttackNow())
+		        {
+                    // only the enemies near enough to be in range need to be checked
+                    const UnitMask targets(getUnitsInRange(enemyPlayer, unit.currentPosition(_currentTime), unit.range()));
+
+			        for (size_t u(targets.next(generator.next)); u < _numUnits[enemyPlayer]; u = targets.next(u + 1))
+			        {
+                        generator.next = (unsigned char)(u + 1);
+				        const Unit & enemyUnit(getUnit(enemyPlayer, u));
+				        bool invisible = enemyUnit.type().hasPermanentCloak() && !isDetected(playerIndex, enemyUnit);
+				        if (!invisible && unit.canAttackTarget(enemyUnit, _currentTime) && enemyUnit.isAlive())
+				        {
+					        move = Action(unitIndex, playerIndex, ActionTypes::ATTACK, u);
+                            generator.numMoves++;
+                            return true;
+				        }
+			        }
+		        }
+		        else if (unit.canHealNow())
+		        {
+                    const UnitMask targets(getUnitsInRange(playerIndex, unit.currentPosition(_currentTime), unit.healRange()));
+
+			        for (size_t u(targets.next(generator.next)); u < _numUnits[playerIndex]; u = targets.next(u + 1))
+			        {
+                        generator.next = (unsigned char)(u + 1);
+
+				        // units cannot heal themselves in broodwar
+				        if (u == unitIndex)
+				        {
+					        continue;
+				        }
+
+				        const Unit & ourUnit(getUnit(playerIndex, u));
+				        if (unit.canHealTarget(ourUnit, _currentTime) && ourUnit.isAlive())
+				        {
+					        move = Action(unitIndex, playerIndex, ActionTypes::HEAL, u);
+                            generator.numMoves++;
+                            return true;
+				        }
+			        }
+		        }
+		        // generate the wait move if it can't attack yet
+		        else if (!unit.canHeal())
+		        {
+                    generator.stage = MoveGenerator::Movement;
+                    generator.next = 0;
+                    move = Action(unitIndex, playerIndex, ActionTypes::RELOAD, 0);
+                    generator.numMoves++;
+                    return true;
+		        }
+
+                generator.stage = MoveGenerator::Movement;
+                generator.next = 0;
+                break;
             }
+            case MoveGenerator::Movement:
+            {
+		        // generate movement moves
+		        if (unit.isMobile())
+		        {
+                    // the move distance is the same for every direction, so work it out with the first
+                    if (generator.moveDistance == 0)
+                    {
+                        // In order to not move when we could be shooting, we want to move for the minimum of:
+                        // 1) default move distance move time
+                        // 2) time until unit can attack, or if it can attack, the next cooldown
+                        double timeUntilAttack          = unit.nextAttackActionTime() - getTime();
+                        timeUntilAttack                 = timeUntilAttack == 0 ? unit.attackCooldown() : timeUntilAttack;
+
+                        // the default move duration
+                        double defaultMoveDuration      = (double)Constants::Move_Distance / unit.speed();
+
+                        // if we can currently attack
+                        double chosenTime = timeUntilAttack != 0 ? std::min(timeUntilAttack, defaultMoveDuration) : defaultMoveDuration;
+
+                        // the chosen movement distance
+                        generator.moveDistance          = (PositionType)(chosenTime * unit.speed());
+
+                        // DEBUG: If chosen move distance is ever 0, something is wrong
+                        if (generator.moveDistance == 0)
+                        {
+                            System::FatalError("Move Action with distance 0 generated. timeUntilAttack:"+
+                                std::to_string(timeUntilAttack)+", speed:"+std::to_string(unit.speed()));
+                        }
+                    }
+
+                    // we are only generating moves in the cardinal direction specified in common.h
+			        while (generator.next < Constants::Num_Directions)
+			        {			
+                        const size_t d(generator.directions[generator.next++]);
+
+                        // the direction of this movement
+              	        Position dir(Constants::Move_Dir[d][0], Constants::Move_Dir[d][1]);
+
+                        // the final destination position of the unit
+                        Position dest = unit.pos() + Position(generator.moveDistance*dir.x(), generator.moveDistance*dir.y());
+
+                        // if that poisition on the map is walkable
+                        if (isWalkable(dest) || (unit.type().isFlyer() && isFlyable(dest)))
+				        {
+					        move = Action(unitIndex, playerIndex, ActionTypes::MOVE, d, dest);
+                            generator.numMoves++;
+                            return true;
+				        }
+			        }
+		        }
+
+                generator.stage = MoveGenerator::Pass;
+                break;
+            }
+            case MoveGenerator::Pass:
+            {
+                generator.stage = MoveGenerator::Done;
 
-            // we are only generating moves in the cardinal direction specified in common.h
-			for (size_t d(0); d<Constants::Num_Directions; ++d)
-			{			
-                // the direction of this movement
-              	Position dir(Constants::Move_Dir[d][0], Constants::Move_Dir[d][1]);
-            
-                if (moveDistance == 0)
-                {
-                    printf("%lf %lf %lf\n", timeUntilAttack, defaultMoveDuration, chosenTime);
-                }
-
-                // the final destination position of the unit
-                Position dest = unit.pos() + Position(moveDistance*dir.x(), moveDistance*dir.y());
-
-                // if that poisition on the map is walkable
-                if (isWalkable(dest) || (unit.type().isFlyer() && isFlyable(dest)))
-				{
-                    // add the move to the MoveArray
-					moves.add(Action(unitIndex, playerIndex, ActionTypes::MOVE, d, dest));
-				}
-			}
-		}
+		        // if no moves were generated for this unit, it must be issued a 'PASS' move
+		        if (generator.numMoves == 0)
+		        {
+			        move = Action(unitIndex, playerIndex, ActionTypes::PASS, 0);
+                    generator.numMoves++;
+                    return true;
+		        }
 
-		// if no moves were generated for this unit, it must be issued a 'PASS' move
-		if (moves.numMoves(unitIndex) == 0)
-		{
-			moves.add(Action(unitIndex, playerIndex, ActionTypes::PASS, 0));
-		}
-	}
+                break;
+            }
+            default:
+            {
+                return false;
+            }
+        }
+    }
 }
 
 
@@ -281,6 +448,10 @@ void GameState::performAction(const Action & move)
 	size_t player		= ourUnit.player();
 	size_t enemyPlayer  = getEnemy(player);
 
+    // whatever the action is, it changes when the unit is next free
+    unitChanged(player, move.unit());
+    unitTouched(player, move.unit());
+
 	if (move.type() == ActionTypes::ATTACK)
 	{
 		Unit & enemyUnit(getUnit(enemyPlayer,move.index()));
@@ -292,13 +463,17 @@ void GameState::performAction(const Action & move)
 		// enemy unit takes damage if it is alive
 		if (enemyUnit.isAlive())
 		{				
+            const HealthType previousHP(enemyUnit.currentHP());
+            unitTouched(enemyPlayer, move.index());
 			enemyUnit.takeAttack(ourUnit);
+            unitHPChanged(enemyPlayer, enemyUnit, previousHP);
 
 			// check to see if enemy unit died
 			if (!enemyUnit.isAlive())
 			{
 				// if it died, remove it
 				_numUnits[enemyPlayer]--;
+                unitChanged(enemyPlayer, move.index());
 			}
 		}			
 	}
@@ -317,7 +492,10 @@ void GameState::performAction(const Action & move)
 			
 		if (ourOtherUnit.isAlive())
 		{
+            const HealthType previousHP(ourOtherUnit.currentHP());
+            unitTouched(player, move.index());
 			ourOtherUnit.takeHeal(ourUnit);
+            unitHPChanged(player, ourOtherUnit, previousHP);
 		}
 	}
 	else if (move.type() == ActionTypes::RELOAD)
@@ -402,6 +580,9 @@ const size_t GameState::getEnemy(const size_t & player) const
 	return (player + 1) % 2;
 }
 
+// The closest unit queries look at the units within a square around the unit, growing it until
+// the closest unit found is inside the circle it covers (so no unit outside it can be closer)
+// or it covers every unit. They pick the same unit as checking every unit would.
 const Unit & GameState::getClosestOurUnit(const size_t & player, const size_t & unitIndex)
 {
 	const Unit & myUnit(getUnit(player,unitIndex));
@@ -411,22 +592,38 @@ const Unit & GameState::getClosestOurUnit(const size_t & player, const size_t &
 
 	Position currentPos = myUnit.currentPosition(_currentTime);
 
-	for (size_t u(0); u<_numUnits[player]; ++u)
-	{
-		if (u == unitIndex || getUnit(player, u).canHeal())
-		{
-			continue;
-		}
+    UnitMask allUnits;
+    allUnits.setFirst(_numUnits[player]);
 
-		//size_t distSq(myUnit.distSq(getUnit(enemyPlayer,u)));
-		size_t distSq(currentPos.getDistanceSq(getUnit(player, u).currentPosition(_currentTime)));
+    for (PositionType range(Grid_Min_Cell_Size); ; range *= 2)
+    {
+        const UnitMask nearby(getUnitsInRange(player, currentPos, range));
 
-		if (distSq < minDist)
-		{
-			minDist = distSq;
-			minUnitInd = u;
-		}
-	}
+        minDist = 1000000;
+        minUnitInd = 0;
+
+	    for (size_t u(nearby.next(0)); u<_numUnits[player]; u = nearby.next(u + 1))
+	    {
+		    if (u == unitIndex || getUnit(player, u).canHeal())
+		    {
+			    continue;
+		    }
+
+		    //size_t distSq(myUnit.distSq(getUnit(enemyPlayer,u)));
+		    size_t distSq(currentPos.getDistanceSq(getUnit(player, u).currentPosition(_currentTime)));
+
+		    if (distSq < minDist)
+		    {
+			    minDist = distSq;
+			    minUnitInd = u;
+		    }
+	    }
+
+        if (minDist <= (size_t)(range * range) || nearby == allUnits)
+        {
+            break;
+        }
+    }
 
 	return getUnit(player, minUnitInd);
 }
@@ -442,42 +639,46 @@ const Unit & GameState::getClosestEnemyUnit(const size_t & player, const size_t
 
 	Position currentPos = myUnit.currentPosition(_currentTime);
 
-	for (size_t u(0); u<_numUnits[enemyPlayer]; ++u)
-	{
-        Unit & enemyUnit(getUnit(enemyPlayer, u));
-		if (checkCloaked&& enemyUnit.type().hasPermanentCloak())
-		{
-			bool invisible = true;
-			for (size_t detectorIndex(0); detectorIndex < _numUnits[player]; ++detectorIndex)
-			{
-				// unit reference
-				const Unit & detector(getUnit(player, detectorIndex));
-				if (detector.type().isDetector() && detector.canSeeTarget(enemyUnit, _currentTime))
-				{
-					invisible = false;
-					break;
-				}
-			}
-			if (invisible)
-			{
-				continue;
-			}
-		}
-        PositionType distSq = myUnit.getDistanceSqToUnit(enemyUnit, _currentTime);
+    UnitMask allUnits;
+    allUnits.setFirst(_numUnits[enemyPlayer]);
 
-		if ((distSq < minDist))// || ((distSq == minDist) && (enemyUnit.ID() < minUnitID)))
-		{
-			minDist = distSq;
-			minUnitInd = u;
-            minUnitID = enemyUnit.ID();
-		}
-        else if ((distSq == minDist) && (enemyUnit.ID() < minUnitID))
+    for (PositionType range(Grid_Min_Cell_Size); ; range *= 2)
+    {
+        const UnitMask nearby(getUnitsInRange(enemyPlayer, currentPos, range));
+
+        minDist = 1000000;
+        minUnitInd = 0;
+        minUnitID = 255;
+
+	    for (size_t u(nearby.next(0)); u<_numUnits[enemyPlayer]; u = nearby.next(u + 1))
+	    {
+            Unit & enemyUnit(getUnit(enemyPlayer, u));
+		    if (checkCloaked && enemyUnit.type().hasPermanentCloak() && !isDetected(player, enemyUnit))
+		    {
+			    continue;
+		    }
+
+            PositionType distSq = myUnit.getDistanceSqToUnit(enemyUnit, _currentTime);
+
+		    if ((distSq < minDist))// || ((distSq == minDist) && (enemyUnit.ID() < minUnitID)))
+		    {
+			    minDist = distSq;
+			    minUnitInd = u;
+                minUnitID = enemyUnit.ID();
+		    }
+            else if ((distSq == minDist) && (enemyUnit.ID() < minUnitID))
+            {
+                minDist = distSq;
+			    minUnitInd = u;
+                minUnitID = enemyUnit.ID();
+            }
+	    }
+
+        if (minDist <= range * range || nearby == allUnits)
         {
-            minDist = distSq;
-			minUnitInd = u;
-            minUnitID = enemyUnit.ID();
+            break;
         }
-	}
+    }
 
 	return getUnit(enemyPlayer, minUnitInd);
 }
@@ -509,6 +710,8 @@ void GameState::addUnit(const Unit & u)
     // Set the unit and it's unitID
 	getUnit(u.player(), _numUnits[u.player()]) = u;
     getUnit(u.player(), _numUnits[u.player()]).setUnitID(unitID);
+    unitChanged(u.player(), _numUnits[u.player()]);
+    unitHPChanged(u.player(), getUnit(u.player(), _numUnits[u.player()]), 0);
 
     // Increment the number of units this player has
 	_numUnits[u.player()]++;
@@ -538,6 +741,8 @@ void GameState::addUnit(const BWAPI::UnitType type, const size_t playerID, const
     // Set the unit and it's unitID
 	getUnit(playerID, _numUnits[playerID]) = Unit(type, playerID, pos);
     getUnit(playerID, _numUnits[playerID]).setUnitID(unitID);
+    unitChanged(playerID, _numUnits[playerID]);
+    unitHPChanged(playerID, getUnit(playerID, _numUnits[playerID]), 0);
 
     // Increment the number of units this player has
 	_numUnits[playerID]++;
@@ -562,6 +767,8 @@ void GameState::addUnitWithID(const Unit & u)
 
     // Simply add the unit to the array
 	getUnit(u.player(), _numUnits[u.player()]) = u;
+    unitChanged(u.player(), _numUnits[u.player()]);
+    unitHPChanged(u.player(), u, 0);
 
     // Increment the number of units this player has
 	_numUnits[u.player()]++;
@@ -577,45 +784,155 @@ void GameState::addUnitWithID(const Unit & u)
     }
 }
 
+void GameState::unitTouched(const size_t & player, const size_t & unitIndex)
+{
+    const int slot(_unitIndex[player][unitIndex]);
+
+    if (!_touched[player][slot])
+    {
+        _touched[player][slot] = true;
+        _touchedSlots[player].add(slot);
+    }
+}
+
+// everything copyFrom and restoreFrom copy apart from the units and their order
+void GameState::copyAllButUnits(const GameState & state)
+{
+    static_cast<GameStateData &>(*this) = state;
+
+    // only copy grids that are built, an invalid grid is rebuilt before it is used
+    for (size_t p(0); p < Constants::Num_Players; ++p)
+    {
+        _gridValid[p] = state._gridValid[p];
+
+        if (_gridValid[p])
+        {
+            _gridOrigin[p]      = state._gridOrigin[p];
+            _gridCellSize[p]    = state._gridCellSize[p];
+            _gridRows[p]        = state._gridRows[p];
+            _gridCols[p]        = state._gridCols[p];
+        }
+    }
+}
+
+void GameState::copyFrom(const GameState & state)
+{
+    copyAllButUnits(state);
+
+    for (size_t p(0); p < Constants::Num_Players; ++p)
+    {
+        _unitIndex[p] = state._unitIndex[p];
+
+        // units past _numUnits are dead, but stay in the order until the next sortUnits
+        const size_t numUnits(std::max(state._numUnits[p], state._prevNumUnits[p]));
+        for (size_t u(0); u < numUnits; ++u)
+        {
+            const int slot(_unitIndex[p][u]);
+            _units[p][slot] = state._units[p][slot];
+        }
+
+        for (size_t t(0); t < _touchedSlots[p].size(); ++t)
+        {
+            _touched[p][_touchedSlots[p][t]] = false;
+        }
+
+        _touchedSlots[p].clear();
+    }
+}
+
+void GameState::restoreFrom(const GameState & state)
+{
+    copyAllButUnits(state);
+
+    for (size_t p(0); p < Constants::Num_Players; ++p)
+    {
+        // units are only ever reordered among the ones state had, so the rest of the order is still the same
+        const size_t numUnits(std::max(state._numUnits[p], state._prevNumUnits[p]));
+        std::copy(state._unitIndex[p].begin(), state._unitIndex[p].begin() + numUnits, _unitIndex[p].begin());
+
+        for (size_t t(0); t < _touchedSlots[p].size(); ++t)
+        {
+            const int slot(_touchedSlots[p][t]);
+            _units[p][slot] = state._units[p][slot];
+            _touched[p][slot] = false;
+        }
+
+        _touchedSlots[p].clear();
+    }
+}
+
+void GameState::unitChanged(const size_t & player, const size_t & unitIndex)
+{
+    // once the list is full sortUnits treats every unit as changed
+    if (_changedUnits[player].size() < _changedUnits[player].capacity() - 1)
+    {
+        _changedUnits[player].add((int)unitIndex);
+    }
+}
+
+// Keeps each player's unit index sorted by time free (see Unit::operator <), so the units
+// which move next are at the front. Only the units which acted, died or were added since
+// the last sort can be out of place, which is usually just the few units that moved this
+// turn, so those are taken out, sorted, and merged back into the rest of the order with
+// a binary search each rather than sorting every unit again.
 void GameState::sortUnits()
 {
-	// sort the units based on time free
 	for (size_t p(0); p<Constants::Num_Players; ++p)
 	{
-		if (_prevNumUnits[p] <= 1)
+        Array<int, Constants::Max_Units> & changed = _changedUnits[p];
+        const size_t numSorted = _prevNumUnits[p];
+        int * index = &_unitIndex[p][0];
+
+		if (numSorted <= 1 || changed.size() == 0)
 		{
 			_prevNumUnits[p] = _numUnits[p];
+            changed.clear();
 			continue;
 		}
-		else
-		{
-			/*for (int i=1; i<_prevNumUnits[p]; ++i)
-			{
-				// A[ i ] is added in the sorted sequence A[0, .. i-1]
-				// save A[i] to make a hole at index iHole
-				//Unit * item = _unitPtrs[p][i];
-                int itemIndex = _unitIndex[p][i];
-                Unit & itemUnit = getUnit(p, i);
-                int iHole = i;
-				// keep moving the hole to next smaller index until A[iHole - 1] is <= item
-				//while ((iHole > 0) && (*item < *(_unitPtrs[p][iHole - 1])))
-                while ((iHole > 0) && (itemUnit < getUnit(p, iHole-1)))
-				{
-					// move hole to next smaller index
-					//_unitPtrs[p][iHole] = _unitPtrs[p][iHole - 1];
-                    _unitIndex[p][iHole] = _unitIndex[p][iHole - 1];
-					iHole = iHole - 1;
-				}
-				// put item in the hole
-                _unitIndex[p][iHole] = itemIndex;
-				//_unitPtrs[p][iHole] = item;
-			}*/
-	
-			
-			//_unitPtrs[p].sort(_prevNumUnits[p], UnitPtrCompare());
-            std::sort(&_unitIndex[p][0], &_unitIndex[p][0] + _prevNumUnits[p], UnitIndexCompare(*this, p));
+
+        // a unit can be in the list twice, say when it moved and then was killed the same turn
+        std::sort(&changed[0], &changed[0] + changed.size());
+        const size_t numChanged = std::unique(&changed[0], &changed[0] + changed.size()) - &changed[0];
+
+        // with many units out of place a full sort is quicker
+        if (changed.size() >= changed.capacity() - 1 || numChanged * 4 >= numSorted)
+        {
+            std::sort(index, index + numSorted, UnitIndexCompare(*this, p));
 			_prevNumUnits[p] = _numUnits[p];
-		}
+            changed.clear();
+            continue;
+        }
+
+        // take the changed units out, the others stay in order at the front
+        int moved[Constants::Max_Units];
+        size_t numMoved(0), numKept(0), c(0);
+        for (size_t u(0); u<numSorted; ++u)
+        {
+            if (c < numChanged && (size_t)changed[c] == u)
+            {
+                moved[numMoved++] = index[u];
+                c++;
+            }
+            else
+            {
+                index[numKept++] = index[u];
+            }
+        }
+
+        std::sort(moved, moved + numMoved, UnitIndexCompare(*this, p));
+
+        // merge them back from the back, so each unit that stayed is shifted once at most
+        size_t end(numKept);
+        for (size_t m(numMoved); m > 0; --m)
+        {
+            int * pos = std::upper_bound(index, index + end, moved[m-1], UnitIndexCompare(*this, p));
+            std::copy_backward(pos, index + end, index + end + m);
+            *(pos + m - 1) = moved[m-1];
+            end = pos - index;
+        }
+
+		_prevNumUnits[p] = _numUnits[p];
+        changed.clear();
 	}	
 }
 
@@ -726,7 +1043,7 @@ void GameState::updateGameTime()
 	}
 }
 
-const StateEvalScore GameState::eval(const size_t & player, const size_t & evalMethod, const size_t p1Script, const size_t p2Script) const
+const StateEvalScore GameState::eval(const size_t & player, const size_t & evalMethod, const size_t p1Script, const size_t p2Script, Playout * playout) const
 {
 	StateEvalScore score;
 	const size_t enemyPlayer(getEnemy(player));
@@ -749,7 +1066,7 @@ const StateEvalScore GameState::eval(const size_t & player, const size_t & evalM
 	}
 	else if (evalMethod == SparCraft::EvaluationMethods::Playout)
 	{
-		score = evalSim(player, p1Script, p2Script);
+		score = evalSim(player, p1Script, p2Script, playout);
 	}
 
 	if (score.val() == 0)
@@ -787,34 +1104,37 @@ const ScoreType GameState::evalLTD2(const size_t & player) const
 	return LTD2(player) - LTD2(enemyPlayer);
 }
 
-const StateEvalScore GameState::evalSim(const size_t & player, const size_t & p1Script, const size_t & p2Script) const
+// searches pass in their own playout, everyone else shares one per thread
+const StateEvalScore GameState::evalSim(const size_t & player, const size_t & p1Script, const size_t & p2Script, Playout * playout) const
 {
-	const size_t p1Model = (p1Script == PlayerModels::Random) ? PlayerModels::NOKDPS : p1Script;
-	const size_t p2Model = (p2Script == PlayerModels::Random) ? PlayerModels::NOKDPS : p2Script;
+	static thread_local std::unique_ptr<Playout> threadPlayout;
 
-	PlayerPtr p1(AllPlayers::getPlayerPtr(Players::Player_One, p1Model));
-	PlayerPtr p2(AllPlayers::getPlayerPtr(Players::Player_Two, p2Model));
-
-	Game game(*this, p1, p2, 200);
-
-	game.play();
+	if (!playout)
+	{
+		if (!threadPlayout)
+		{
+			threadPlayout.reset(new Playout());
+		}
 
-	ScoreType evalReturn = game.getState().evalLTD2(player);
+		playout = threadPlayout.get();
+	}
 
-	return StateEvalScore(evalReturn, game.getState().getNumMovements(player));
+	return playout->eval(*this, player, p1Script, p2Script);
 }
 
 void GameState::calculateStartingHealth()
 {
 	for (size_t p(0); p<Constants::Num_Players; ++p)
 	{
-		float totalHP(0);
-		float totalSQRT(0);
+		long long totalHP(0);
+		long long totalSQRT(0);
 
 		for (size_t u(0); u<_numUnits[p]; ++u)
 		{
-			totalHP += getUnit(p, u).maxHP() * getUnit(p, u).dpf();
-			totalSQRT += sqrtf(getUnit(p,u).maxHP()) * getUnit(p, u).dpf();;
+			const Unit & unit(getUnit(p, u));
+
+			totalHP += LTDShare(unit, unit.maxHP());
+			totalSQRT += LTD2Share(unit, unit.maxHP());
 		}
 
 		_totalLTD[p] = totalHP;
@@ -822,44 +1142,61 @@ void GameState::calculateStartingHealth()
 	}
 }
 
-const ScoreType	GameState::LTD2(const size_t & player) const
+// keeps the running LTD and LTD2 sums up to date when a unit's hp changes, a unit at 0 hp counts for nothing
+void GameState::unitHPChanged(const size_t & player, const Unit & unit, const HealthType & previousHP)
 {
-	if (numUnits(player) == 0)
-	{
-		return 0;
-	}
-
-	float sum(0);
+    _currentLTD[player] += LTDShare(unit, unit.currentHP()) - LTDShare(unit, previousHP);
+    _currentLTD2[player] += LTD2Share(unit, unit.currentHP()) - LTD2Share(unit, previousHP);
+    _currentHPSum[player] += std::max(unit.currentHP(), (HealthType)0) - std::max(previousHP, (HealthType)0);
+}
 
-	for (size_t u(0); u<numUnits(player); ++u)
+// debug builds check the running sums against the units every time they are used
+void GameState::checkLTD() const
+{
+	for (size_t p(0); p<Constants::Num_Players; ++p)
 	{
-		const Unit & unit(getUnit(player, u));
+        long long ltd(0), ltd2(0);
+        int hpSum(0);
 
-		sum += sqrtf(unit.currentHP()) * unit.dpf();
-	}
+		for (size_t u(0); u<numUnits(p); ++u)
+		{
+            const Unit & unit(getUnit(p, u));
 
-	ScoreType ret = (ScoreType)(1000 * sum / _totalSumSQRT[player]);
+            ltd += LTDShare(unit, unit.currentHP());
+            ltd2 += LTD2Share(unit, unit.currentHP());
+            hpSum += std::max(unit.currentHP(), (HealthType)0);
+        }
 
-	return ret;
+        SPARCRAFT_ASSERT(ltd == _currentLTD[p] && ltd2 == _currentLTD2[p] && hpSum == _currentHPSum[p], "Running LTD sums of player %d are out of date", (int)p);
+    }
 }
 
-const ScoreType GameState::LTD(const size_t & player) const
+const ScoreType	GameState::LTD2(const size_t & player) const
 {
 	if (numUnits(player) == 0)
 	{
 		return 0;
 	}
 
-	float sum(0);
+#ifdef _DEBUG
+    checkLTD();
+#endif
 
-	for (size_t u(0); u<numUnits(player); ++u)
-	{
-		const Unit & unit(getUnit(player, u));
+	return _totalSumSQRT[player] > 0 ? (ScoreType)(1000 * _currentLTD2[player] / _totalSumSQRT[player]) : 0;
+}
 
-		sum += unit.currentHP() * unit.dpf();
+const ScoreType GameState::LTD(const size_t & player) const
+{
+	if (numUnits(player) == 0)
+	{
+		return 0;
 	}
 
-	return (ScoreType)(1000 * sum / _totalLTD[player]);
+#ifdef _DEBUG
+    checkLTD();
+#endif
+
+	return _totalLTD[player] > 0 ? (ScoreType)(1000 * _currentLTD[player] / _totalLTD[player]) : 0;
 }
 
 void GameState::setMap(Map * map)
@@ -906,6 +1243,106 @@ const bool GameState::bothCanMove() const
 void GameState::setTime(const TimeType & time)
 {
 	_currentTime = time;
+    invalidateGrid();
+}
+
+void GameState::invalidateGrid()
+{
+    _gridValid.fill(false);
+}
+
+void GameState::buildGrid(const size_t & player) const
+{
+    PositionType minX(std::numeric_limits<PositionType>::max()), minY(minX);
+    PositionType maxX(std::numeric_limits<PositionType>::min()), maxY(maxX);
+
+    for (size_t u(0); u < _numUnits[player]; ++u)
+    {
+        const Position & pos(getUnit(player, u).currentPosition(_currentTime));
+        minX = std::min(minX, pos.x());
+        minY = std::min(minY, pos.y());
+        maxX = std::max(maxX, pos.x());
+        maxY = std::max(maxY, pos.y());
+    }
+
+    // cells are made big enough that the units span at most Grid_Cells of them in each direction
+    const PositionType cellSize(std::max((PositionType)Grid_Min_Cell_Size, std::max(maxX - minX, maxY - minY) / Grid_Cells + 1));
+    _gridOrigin[player] = Position(minX, minY);
+    _gridCellSize[player] = cellSize;
+    _gridRows[player].fill(UnitMask());
+    _gridCols[player].fill(UnitMask());
+
+    for (size_t u(0); u < _numUnits[player]; ++u)
+    {
+        const Position & pos(getUnit(player, u).currentPosition(_currentTime));
+        _gridRows[player][(pos.y() - minY) / cellSize].set(u);
+        _gridCols[player][(pos.x() - minX) / cellSize].set(u);
+    }
+
+    _gridValid[player] = true;
+}
+
+// The units in the cells the square around pos covers, which are all the units within range
+// of pos. Players with few units just get all of their units back.
+const UnitMask GameState::getUnitsInRange(const size_t & player, const Position & pos, const PositionType & range) const
+{
+    UnitMask units;
+
+    if (_numUnits[player] < Grid_Min_Units)
+    {
+        units.setFirst(_numUnits[player]);
+        return units;
+    }
+
+    if (!_gridValid[player])
+    {
+        buildGrid(player);
+    }
+
+    const PositionType cellSize(_gridCellSize[player]);
+    const PositionType left(pos.x() - range - _gridOrigin[player].x());
+    const PositionType right(pos.x() + range - _gridOrigin[player].x());
+    const PositionType top(pos.y() - range - _gridOrigin[player].y());
+    const PositionType bottom(pos.y() + range - _gridOrigin[player].y());
+
+    if (right < 0 || bottom < 0)
+    {
+        return units;
+    }
+
+    const PositionType x0(std::max(left, 0) / cellSize), x1(std::min(right / cellSize, (PositionType)Grid_Cells - 1));
+    const PositionType y0(std::max(top, 0) / cellSize), y1(std::min(bottom / cellSize, (PositionType)Grid_Cells - 1));
+
+    UnitMask cols;
+    for (PositionType y(y0); y <= y1; ++y)
+    {
+        units |= _gridRows[player][y];
+    }
+
+    for (PositionType x(x0); x <= x1; ++x)
+    {
+        cols |= _gridCols[player][x];
+    }
+
+    units &= cols;
+    return units;
+}
+
+const bool GameState::isDetected(const size_t & player, const Unit & unit) const
+{
+    const UnitMask nearby(getUnitsInRange(player, unit.currentPosition(_currentTime), MaxDetectorSightRange()));
+
+    for (size_t detectorIndex(nearby.next(0)); detectorIndex < _numUnits[player]; detectorIndex = nearby.next(detectorIndex + 1))
+    {
+        // unit reference
+        const Unit & detector(getUnit(player, detectorIndex));
+        if (detector.type().isDetector() && detector.canSeeTarget(unit, _currentTime))
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 const int & GameState::getNumMovements(const size_t & player) const
@@ -918,20 +1355,20 @@ const TimeType GameState::getTime() const
 	return _currentTime;
 }
 
-const float & GameState::getTotalLTD(const size_t & player) const
+const float GameState::getTotalLTD(const size_t & player) const
 {
-	return _totalLTD[player];
+	return (float)(_totalLTD[player] / LTDScale);
 }
 
-const float & GameState::getTotalLTD2(const size_t & player)	const
+const float GameState::getTotalLTD2(const size_t & player)	const
 {
-	return _totalSumSQRT[player];
+	return (float)(_totalSumSQRT[player] / LTDScale);
 }
 
 void GameState::setTotalLTD(const float & p1, const float & p2)
 {
-	_totalLTD[Players::Player_One] = p1;
-	_totalLTD[Players::Player_Two] = p2;
+	_totalLTD[Players::Player_One] = (long long)(p1 * LTDScale + 0.5);
+	_totalLTD[Players::Player_Two] = (long long)(p2 * LTDScale + 0.5);
 }
 
 // detect if there is a deadlock, such that no team can possibly win
@@ -985,8 +1422,8 @@ const bool GameState::isTerminal() const
 
 void GameState::setTotalLTD2(const float & p1, const float & p2)
 {
-	_totalSumSQRT[Players::Player_One] = p1;
-	_totalSumSQRT[Players::Player_Two] = p2;
+	_totalSumSQRT[Players::Player_One] = (long long)(p1 * LTDScale + 0.5);
+	_totalSumSQRT[Players::Player_Two] = (long long)(p2 * LTDScale + 0.5);
 }
 
 Map * GameState::getMap() const
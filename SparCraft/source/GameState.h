@@ -15,22 +15,57 @@ typedef std::shared_ptr<SparCraft::Map> MapPtr;
 
 namespace SparCraft
 {
-class GameState 
+class Playout;
+
+// a set of one player's unit indices, which the spatial queries in GameState return
+class UnitMask
 {
-    Map *                                                           _map;               
+    enum { Words = (Constants::Max_Units + 63) / 64 };
 
-    std::vector<Unit> _units[Constants::Num_Players];
-    std::vector<int>  _unitIndex[Constants::Num_Players];
+    unsigned long long  _bits[Words];
+
+public:
+
+    UnitMask();
+
+    void                clear();
+    void                set(const size_t & unit);
+
+    // sets units 0 to numUnits-1
+    void                setFirst(const size_t & numUnits);
+
+    UnitMask &          operator |= (const UnitMask & rhs);
+    UnitMask &          operator &= (const UnitMask & rhs);
+    const bool          operator == (const UnitMask & rhs)                                      const;
+
+    // the lowest unit in the set at or after unit, or Constants::Max_Units if there isn't one
+    const size_t        next(const size_t & unit)                                               const;
+};
+
+// The members of GameState that copyFrom and restoreFrom copy as a whole. Anything added to a
+// state that should be the same after copying it belongs here, GameState itself only holds the
+// units and the caches copyFrom and restoreFrom handle one by one.
+struct GameStateData
+{
+    Map *                                                           _map;               
 
-    Array2D<Unit, Constants::Num_Players, Constants::Max_Units>     _units2;             
-    Array2D<int, Constants::Num_Players, Constants::Max_Units>      _unitIndex2;        
     Array<Unit, 1>                                                  _neutralUnits;
 
     Array<size_t, Constants::Num_Players>                    _numUnits;
     Array<size_t, Constants::Num_Players>                    _prevNumUnits;
 
-    Array<float, Constants::Num_Players>                            _totalLTD;
-    Array<float, Constants::Num_Players>                            _totalSumSQRT;
+    // positions in the sorted unit order of units which acted, died or were added since the last sortUnits
+    Array2D<int, Constants::Num_Players, Constants::Max_Units>      _changedUnits;
+
+    // the same sums as _currentLTD and _currentLTD2 at each unit's max hp, in the same fixed point
+    Array<long long, Constants::Num_Players>                        _totalLTD;
+    Array<long long, Constants::Num_Players>                        _totalSumSQRT;
+
+    // sums over each player's living units of currentHP * dpf and sqrt(currentHP) * dpf in
+    // fixed point, and of currentHP, kept up to date by performAction as units take damage
+    Array<long long, Constants::Num_Players>                        _currentLTD;
+    Array<long long, Constants::Num_Players>                        _currentLTD2;
+    Array<int, Constants::Num_Players>                              _currentHPSum;
 
     Array<int, Constants::Num_Players>                              _numMovements;
     Array<int, Constants::Num_Players>                              _prevHPSum;
@@ -39,17 +74,58 @@ class GameState
     size_t                                                          _maxUnits;
     TimeType                                                        _sameHPFrames;
 
+    GameStateData();
+};
+
+class GameState : private GameStateData
+{
+    std::vector<Unit> _units[Constants::Num_Players];
+    std::vector<int>  _unitIndex[Constants::Num_Players];
+
+    // A uniform grid over each player's unit positions at the current time, kept as the set of
+    // units in each row and each column of cells, so the units within a square are the rows it
+    // covers intersected with the columns. It's built the first time a query needs it after
+    // finishedMoving or setTime, and only for players with at least Grid_Min_Units units.
+    enum { Grid_Cells = 16, Grid_Min_Cell_Size = 64, Grid_Min_Units = 16 };
+
+    mutable Array<bool, Constants::Num_Players>                     _gridValid;
+    mutable Array<Position, Constants::Num_Players>                 _gridOrigin;
+    mutable Array<PositionType, Constants::Num_Players>             _gridCellSize;
+    mutable Array2D<UnitMask, Constants::Num_Players, Grid_Cells>   _gridRows;
+    mutable Array2D<UnitMask, Constants::Num_Players, Grid_Cells>   _gridCols;
+
+    // slots in _units of the units performAction has changed since copyFrom or restoreFrom
+    Array2D<int, Constants::Num_Players, Constants::Max_Units + 1>  _touchedSlots;
+    Array2D<bool, Constants::Num_Players, Constants::Max_Units>     _touched;
+
+    void                    invalidateGrid();
+    void                    buildGrid(const size_t & player)                                        const;
+
     // checks to see if the unit array is full before adding a unit to the state
     const bool              checkFull(const size_t & player)                                        const;
     const bool              checkUniqueUnitIDs()                                                    const;
 
     void                    performAction(const Action & theMove);
+    void                    unitChanged(const size_t & player, const size_t & unitIndex);
+    void                    unitTouched(const size_t & player, const size_t & unitIndex);
+    void                    copyAllButUnits(const GameState & state);
+    void                    unitHPChanged(const size_t & player, const Unit & unit, const HealthType & previousHP);
+    void                    checkLTD()                                                              const;
 
 public:
 
     GameState();
     GameState(const std::string & filename);
 
+    // Makes this state the same as state while only copying its living units, reusing this
+    // state's memory. Keep one state to search from and copyFrom the root into it once.
+    void                    copyFrom(const GameState & state);
+
+    // Makes this state the same as state again by copying back only the units that changed since
+    // the last copyFrom or restoreFrom, which must have been from the same unchanged state, and
+    // this state must only have been changed by makeMoves and finishedMoving since.
+    void                    restoreFrom(const GameState & state);
+
 	// misc functions
     void                    finishedMoving();
     void                    updateGameTime();
@@ -62,6 +138,12 @@ public:
     const size_t            numNeutralUnits()                                                       const;
     const size_t            closestEnemyUnitDistance(const Unit & unit)                             const;
 
+    // every unit of the player within range of pos, along with some further away
+    const UnitMask          getUnitsInRange(const size_t & player, const Position & pos, const PositionType & range) const;
+
+    // whether one of the player's detectors can see the unit
+    const bool              isDetected(const size_t & player, const Unit & unit)                    const;
+
     // Unit functions
     void                    sortUnits();
     void                    addUnit(const Unit & u);
@@ -85,23 +167,25 @@ public:
     // evaluation functions
     const StateEvalScore    eval(   const size_t & player, const size_t & evalMethod, 
                                     const size_t p1Script = PlayerModels::NOKDPS,
-                                    const size_t p2Script = PlayerModels::NOKDPS)                   const;
+                                    const size_t p2Script = PlayerModels::NOKDPS,
+                                    Playout * playout = NULL)                                       const;
     const ScoreType         evalLTD(const size_t & player)                                        const;
     const ScoreType         evalLTD2(const size_t & player)                                       const;
     const ScoreType         LTD(const size_t & player)                                            const;
     const ScoreType         LTD2(const size_t & player)                                           const;
-    const StateEvalScore    evalSim(const size_t & player, const size_t & p1, const size_t & p2)    const;
+    const StateEvalScore    evalSim(const size_t & player, const size_t & p1, const size_t & p2, Playout * playout = NULL) const;
     const size_t            getEnemy(const size_t & player)                                         const;
 
     // unit hitpoint calculations, needed for LTD2 evaluation
     void                    calculateStartingHealth();
     void                    setTotalLTD(const float & p1, const float & p2);
     void                    setTotalLTD2(const float & p1, const float & p2);
-    const float &           getTotalLTD(const size_t & player)                                    const;
-    const float &           getTotalLTD2(const size_t & player)                                   const;
+    const float             getTotalLTD(const size_t & player)                                    const;
+    const float             getTotalLTD2(const size_t & player)                                   const;
 
     // move related functions
     void                    generateMoves(MoveArray & moves, const size_t & playerIndex)            const;
+    const bool              generateNextMove(MoveGenerator & generator, const size_t & playerIndex, const size_t & unitIndex, Action & move) const;
     void                    makeMoves(const std::vector<Action> & moves);
     const int &             getNumMovements(const size_t & player)                                  const;
     const size_t            whoCanMove()                                                            const;
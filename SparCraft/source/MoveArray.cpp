@@ -1,9 +1,12 @@
 #include "MoveArray.h"
+#include "GameState.h"
 
 using namespace SparCraft;
 
 MoveArray::MoveArray(const size_t maxUnits) 
-	: _numUnits(0)
+	: _state(NULL)
+    , _player(0)
+    , _numUnits(0)
 	, _maxUnits(Constants::Max_Units)
     , _hasMoreMoves(true)
 {
@@ -20,62 +23,71 @@ void MoveArray::clear()
         return;
     }
 
+    for (size_t u(0); u<_numUnits; ++u)
+    {
+	    _numMoves[u] = 0;
+    }
+
 	_numUnits = 0;
-	_numMoves.fill(0);
+    _state = NULL;
     resetMoveIterator();
 }
 
 // shuffle the MOVE unit actions to prevent bias in experiments
-// this function assumes that all MOVE actions are contiguous in the moves array
-// this should be the case unless you change the move generation ordering
+// a unit that hasn't generated a movement action yet only has its direction order shuffled, so
+// its actions stay lazy. a unit that has is finished through its movement stage and its MOVE
+// actions, which are contiguous, are shuffled in place
 void MoveArray::shuffleMoveActions()
 {
-    // for each unit
+    bool shuffledInPlace(false);
+
     for (size_t u(0); u<numUnits(); ++u)
     {
-        int moveEnd(-1);
-        int moveBegin(-1);
+        MoveGenerator & generator(_generators[u]);
 
-        // reverse through the list of actions for this unit
-        for (int a(numMoves(u)-1); a >= 0; --a)
+        if (generator.stage == MoveGenerator::Targets || (generator.stage == MoveGenerator::Movement && generator.next == 0))
         {
-            size_t moveType(getMove(u, a).type());
-
-            // mark the end of the move actions
-            if (moveEnd == -1 && (moveType == ActionTypes::MOVE))
-            {
-                moveEnd = a;
-            }
-            // mark the beginning of the MOVE unit actions
-            else if ((moveEnd != -1) && (moveBegin == -1) && (moveType != ActionTypes::MOVE))
-            {
-                moveBegin = a;
-            }
-            else if (moveBegin != -1)
-            {
-                break;
-            }
+            std::random_shuffle(&generator.directions[0], &generator.directions[0] + Constants::Num_Directions);
+            continue;
         }
 
-        // if we found the end but didn't find the beginning
-        if (moveEnd != -1 && moveBegin == -1)
+        while (generator.stage == MoveGenerator::Movement && generateMove(u, _numMoves[u]))
         {
-            // then the move actions begin at the beginning of the array
-            moveBegin = 0;
         }
 
-        // shuffle the movement actions for this unit
-        if (moveEnd != -1 && moveBegin != -1 && moveEnd != moveBegin)
+        size_t moveBegin(0);
+        while (moveBegin < _numMoves[u] && _moves[u][moveBegin].type() != ActionTypes::MOVE)
         {
-            std::random_shuffle(&_moves[u][moveBegin], &_moves[u][moveEnd]);
-            resetMoveIterator();
+            ++moveBegin;
+        }
+
+        size_t moveEnd(moveBegin);
+        while (moveEnd < _numMoves[u] && _moves[u][moveEnd].type() == ActionTypes::MOVE)
+        {
+            ++moveEnd;
+        }
+
+        if (moveEnd - moveBegin > 1)
+        {
+            std::random_shuffle(&_moves[u][moveBegin], &_moves[u][moveBegin] + (moveEnd - moveBegin));
+            shuffledInPlace = true;
         }
     }
+
+    if (shuffledInPlace)
+    {
+        resetMoveIterator();
+    }
 }
 
 // returns a given move from a unit
 const Action & MoveArray::getMove(const size_t & unit, const size_t & move) const
 {
+    if (move >= _numMoves[unit])
+    {
+        generateMove(unit, move);
+    }
+
     assert(_moves[unit][(size_t)move].unit() != 255);
 
     return _moves[unit][(size_t)move];
@@ -93,30 +105,23 @@ void MoveArray::printCurrentMoveIndex()
 
 void MoveArray::incrementMove(const size_t & unit)
 {
-    // increment the index for this unit
-    _currentMovesIndex[unit] = (_currentMovesIndex[unit] + 1) % _numMoves[unit];
-
-    // if the value rolled over, we need to do the carry calculation
-    if (_currentMovesIndex[unit] == 0)
+    for (size_t u(unit); u<_numUnits; ++u)
     {
-        // the next unit index
-        size_t nextUnit = unit + 1;
-
-        // if we have space left to increment, do it
-        if (nextUnit < _numUnits)
+        // increment the index for this unit, generating its next action if there is one
+        if (generateMove(u, _currentMovesIndex[u] + 1))
         {
-            incrementMove(nextUnit);
-        }
-        // otherwise we have no more moves
-        else
-        {
-            // stop
-            _hasMoreMoves = false;
+            _currentMovesIndex[u]++;
+            _currentMoves[u] = _moves[u][_currentMovesIndex[u]];
+            return;
         }
+
+        // the value rolled over, so carry into the next unit
+        _currentMovesIndex[u] = 0;
+        _currentMoves[u] = _moves[u][0];
     }
 
-    _currentMoves[unit] = _moves[unit][_currentMovesIndex[unit]];
-    //_currentMovesVec[unit] = _moves[unit][_currentMovesIndex[unit]];
+    // every unit rolled over, we have no more moves
+    _hasMoreMoves = false;
 }
 
 const bool MoveArray::hasMoreMoves() const
@@ -131,6 +136,7 @@ void MoveArray::resetMoveIterator()
 
     for (size_t u(0); u<numUnits(); ++u)
     {
+        generateMove(u, 0);
         _currentMoves[u] = _moves[u][_currentMovesIndex[u]];
         //_currentMovesVec[u] = _moves[u][_currentMovesIndex[u]];
     }
@@ -189,8 +195,43 @@ const size_t MoveArray::getPlayerID(const size_t & unit) const
 	return getMove(unit, 0).player();
 }
 
-void MoveArray::addUnit() 											{ _numUnits++; }
+const bool MoveArray::generateMove(const size_t & unit, const size_t & move) const
+{
+    MoveGenerator & generator(_generators[unit]);
+
+    while (_numMoves[unit] <= move)
+    {
+        Action action;
+        if (generator.stage == MoveGenerator::Done || !_state->generateNextMove(generator, _player, unit, action))
+        {
+            return false;
+        }
+
+        _moves[unit][_numMoves[unit]] = action;
+        _numMoves[unit]++;
+    }
+
+    return true;
+}
+
+void MoveArray::generateAll(const size_t & unit) const
+{
+    generateMove(unit, Constants::Max_Moves);
+}
+
+void MoveArray::setState(const GameState * state, const size_t & player)
+{
+    _state = state;
+    _player = player;
+}
+
+// units added without a state only have the actions given to add()
+void MoveArray::addUnit()
+{
+    _generators[_numUnits] = MoveGenerator(_state ? MoveGenerator::Targets : MoveGenerator::Done);
+    _numUnits++;
+}
 
 const size_t & MoveArray::numUnits()						const	{ return _numUnits; }
 const size_t & MoveArray::numUnitsInTuple()				const	{ return numUnits(); }
-const size_t & MoveArray::numMoves(const size_t & unit)	const	{ return _numMoves[unit]; }
\ No newline at end of file
+const size_t & MoveArray::numMoves(const size_t & unit)	const	{ if (_generators[unit].stage != MoveGenerator::Done) { generateAll(unit); } return _numMoves[unit]; }
\ No newline at end of file
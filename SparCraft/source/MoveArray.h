@@ -7,13 +7,52 @@
 
 namespace SparCraft
 {
+class GameState;
+
+// how far GameState::generateNextMove has got through the actions of one unit
+class MoveGenerator
+{
+public:
+
+    enum { Targets, Movement, Pass, Done };
+
+    unsigned char   stage;      // which kind of action is generated next
+    unsigned char   next;       // the next target or direction to try in that stage
+    unsigned char   numMoves;   // how many actions have been generated
+    PositionType    moveDistance;
+
+    // the order the movement stage tries the directions in, shuffled by MoveArray::shuffleMoveActions
+    unsigned char   directions[Constants::Num_Directions];
+
+    MoveGenerator(const unsigned char s = Targets)
+        : stage(s)
+        , next(0)
+        , numMoves(0)
+        , moveDistance(0)
+    {
+        for (size_t d(0); d<Constants::Num_Directions; ++d)
+        {
+            directions[d] = (unsigned char)d;
+        }
+    }
+};
+
+// The moves of a player's units, generated lazily: GameState::generateMoves only records which
+// units move, and each unit's actions are generated from the state as they're first asked for,
+// so iterating the first few move tuples only generates the first few actions. The state must
+// not change while the MoveArray is being used.
 class MoveArray
 {
 	// the array which contains all the moves
-	Array2D<Action, Constants::Max_Units, Constants::Max_Moves> _moves;
+	mutable Array2D<Action, Constants::Max_Units, Constants::Max_Moves> _moves;
 
-	// how many moves each unit has
-	Array<size_t, Constants::Max_Units>                         _numMoves;
+	// how many moves each unit has been generated so far
+	mutable Array<size_t, Constants::Max_Units>                 _numMoves;
+
+    // the state the moves are generated from and where each unit's generation is up to
+    const GameState *                                           _state;
+    size_t                                                      _player;
+    mutable Array<MoveGenerator, Constants::Max_Units>          _generators;
 
     // the current move array, used for the 'iterator'
     //std::vector<Action> _currentMoves;
@@ -26,6 +65,12 @@ class MoveArray
 	size_t                                                              _maxUnits;
     bool                                                                _hasMoreMoves;
 
+    // generates the unit's actions until it has the given move, returns whether it does
+    const bool generateMove(const size_t & unit, const size_t & move) const;
+
+    // generates all of the unit's actions
+    void generateAll(const size_t & unit) const;
+
 public:
 
 	MoveArray(const size_t maxUnits = 0);
@@ -58,8 +103,50 @@ public:
 
 	void addUnit();
 
+    // units added after this generate their actions from the state
+    void setState(const GameState * state, const size_t & player);
+
+    // shuffles each unit's MOVE actions, without generating the actions of units that haven't
+    // started their movement yet
     void shuffleMoveActions();
 
+    // orders each unit's actions by score(action), highest first, leaving actions with
+    // equal scores in the order they were in
+    template <class ActionScore>
+    void sortMoves(const ActionScore & score)
+    {
+        size_t scores[Constants::Max_Moves];
+
+        for (size_t u(0); u<_numUnits; ++u)
+        {
+            generateAll(u);
+
+            for (size_t m(0); m<_numMoves[u]; ++m)
+            {
+                scores[m] = score(_moves[u][m]);
+            }
+
+            // insertion sort, units have few actions
+            for (size_t m(1); m<_numMoves[u]; ++m)
+            {
+                const Action move(_moves[u][m]);
+                const size_t moveScore(scores[m]);
+                size_t hole(m);
+
+                for (; hole > 0 && scores[hole-1] < moveScore; --hole)
+                {
+                    _moves[u][hole] = _moves[u][hole-1];
+                    scores[hole] = scores[hole-1];
+                }
+
+                _moves[u][hole] = move;
+                scores[hole] = moveScore;
+            }
+        }
+
+        resetMoveIterator();
+    }
+
 	const size_t & numUnits()						const;
 	const size_t & numUnitsInTuple()				const;
 	const size_t & numMoves(const size_t & unit)	const;
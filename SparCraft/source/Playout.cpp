@@ -0,0 +1,142 @@
+#include "Playout.h"
+
+using namespace SparCraft;
+
+// every pair of scripts gets its own instantiation of the playout loop
+#define PLAYOUT_ROW(P1)                                     \
+    {                                                       \
+        &Playout::playScripts<P1, Player_AttackClosest>,    \
+        &Playout::playScripts<P1, Player_AttackDPS>,        \
+        &Playout::playScripts<P1, Player_AttackWeakest>,    \
+        &Playout::playScripts<P1, Player_Kiter>,            \
+        &Playout::playScripts<P1, Player_KiterDPS>,         \
+        &Playout::playScripts<P1, Player_NOKDPS>,           \
+        &Playout::playScripts<P1, Player_Kiter_NOKDPS>,     \
+        &Playout::playScripts<P1, Player_Cluster>           \
+    }
+
+const Playout::PlayFunction Playout::PlayFunctions[Playout::NumScripts][Playout::NumScripts] =
+{
+    PLAYOUT_ROW(Player_AttackClosest),
+    PLAYOUT_ROW(Player_AttackDPS),
+    PLAYOUT_ROW(Player_AttackWeakest),
+    PLAYOUT_ROW(Player_Kiter),
+    PLAYOUT_ROW(Player_KiterDPS),
+    PLAYOUT_ROW(Player_NOKDPS),
+    PLAYOUT_ROW(Player_Kiter_NOKDPS),
+    PLAYOUT_ROW(Player_Cluster)
+};
+
+#undef PLAYOUT_ROW
+
+Playout::Playout()
+    : _rounds(0)
+{
+    for (size_t p(0); p < Constants::Num_Players; ++p)
+    {
+        _scriptMoves[p].reserve(Constants::Max_Units);
+    }
+}
+
+const size_t Playout::ScriptIndex(const size_t & playerModel)
+{
+    switch (playerModel)
+    {
+        case PlayerModels::AttackClosest:   return 0;
+        case PlayerModels::AttackDPS:       return 1;
+        case PlayerModels::AttackWeakest:   return 2;
+        case PlayerModels::Kiter:           return 3;
+        case PlayerModels::KiterDPS:        return 4;
+        case PlayerModels::Kiter_NOKDPS:    return 6;
+        case PlayerModels::Cluster:         return 7;
+        default:                            return 5;
+    }
+}
+
+template <class ScriptType>
+ScriptType & Playout::getScript(const size_t & player)
+{
+    return PlayoutScripts<ScriptType>::get(player);
+}
+
+// the same turns as Game::play and Game::playNextTurn
+template <class P1, class P2>
+void Playout::playScripts(const size_t & moveLimit)
+{
+    P1 & one = getScript<P1>(Players::Player_One);
+    P2 & two = getScript<P2>(Players::Player_Two);
+
+    while (!_state.isTerminal())
+    {
+        if (moveLimit && _rounds >= moveLimit)
+        {
+            break;
+        }
+
+        const size_t whoCanMove(_state.whoCanMove());
+        const size_t playerToMove((whoCanMove == Players::Player_Both) ? (size_t)Players::Player_One : whoCanMove);
+        const size_t enemyPlayer(_state.getEnemy(playerToMove));
+
+        _scriptMoves[0].clear();
+        _scriptMoves[1].clear();
+
+        _state.generateMoves(_moves[playerToMove], playerToMove);
+
+        if (playerToMove == Players::Player_One)
+        {
+            one.P1::getMoves(_state, _moves[playerToMove], _scriptMoves[playerToMove]);
+        }
+        else
+        {
+            two.P2::getMoves(_state, _moves[playerToMove], _scriptMoves[playerToMove]);
+        }
+
+        if (_state.bothCanMove())
+        {
+            _state.generateMoves(_moves[enemyPlayer], enemyPlayer);
+
+            if (enemyPlayer == Players::Player_One)
+            {
+                one.P1::getMoves(_state, _moves[enemyPlayer], _scriptMoves[enemyPlayer]);
+            }
+            else
+            {
+                two.P2::getMoves(_state, _moves[enemyPlayer], _scriptMoves[enemyPlayer]);
+            }
+
+            _state.makeMoves(_scriptMoves[enemyPlayer]);
+        }
+
+        _state.makeMoves(_scriptMoves[playerToMove]);
+        _state.finishedMoving();
+        _rounds++;
+    }
+}
+
+void Playout::play(const GameState & state, const size_t & p1Script, const size_t & p2Script, const size_t & moveLimit)
+{
+    PROFILE_FUNCTION();
+
+    // only the living units are copied, into the state's existing memory
+    _state.copyFrom(state);
+    _rounds = 0;
+
+    (this->*PlayFunctions[ScriptIndex(p1Script)][ScriptIndex(p2Script)])(moveLimit);
+}
+
+const StateEvalScore Playout::eval(const GameState & state, const size_t & player, const size_t & p1Script, const size_t & p2Script, const size_t & moveLimit)
+{
+    play(state, p1Script, p2Script, moveLimit);
+
+    return StateEvalScore(_state.evalLTD2(player), _state.getNumMovements(player));
+}
+
+const GameState & Playout::getState() const
+{
+    return _state;
+}
+
+const size_t Playout::getRounds() const
+{
+    return _rounds;
+}
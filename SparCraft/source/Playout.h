@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "MoveArray.h"
+#include "Action.h"
+#include <memory>
+
+#include "Player_AttackClosest.h"
+#include "Player_AttackDPS.h"
+#include "Player_AttackWeakest.h"
+#include "Player_Kiter.h"
+#include "Player_KiterDPS.h"
+#include "Player_NOKDPS.h"
+#include "Player_Kiter_NOKDPS.h"
+#include "Player_Cluster.h"
+
+namespace SparCraft
+{
+
+// both script players of one type, made once and reused by every playout
+template <class ScriptType>
+class PlayoutScripts
+{
+    ScriptType _one;
+    ScriptType _two;
+
+public:
+
+    PlayoutScripts()
+        : _one(Players::Player_One)
+        , _two(Players::Player_Two)
+    {
+    }
+
+    ScriptType & get(const size_t & player)
+    {
+        return player == Players::Player_One ? _one : _two;
+    }
+};
+
+/*----------------------------------------------------------------------
+ | Script Playout
+ |----------------------------------------------------------------------
+ | Plays two scripts against each other from a state, which is what
+ | EvaluationMethods::Playout evaluates a state with. It plays exactly
+ | like a Game with the same two script players, without allocating:
+ | the players, move arrays, move vectors and the state being played
+ | out are made once and reused. The loop is a template instantiated
+ | for every pair of scripts and picked from a table, so the script
+ | moves are direct calls rather than virtual ones.
+ |
+ | Keep one per search (or thread), a Playout is not thread safe. It
+ | holds two MoveArrays, so keep it on the heap rather than the stack.
+ `----------------------------------------------------------------------*/
+class Playout :
+    PlayoutScripts<Player_AttackClosest>,
+    PlayoutScripts<Player_AttackDPS>,
+    PlayoutScripts<Player_AttackWeakest>,
+    PlayoutScripts<Player_Kiter>,
+    PlayoutScripts<Player_KiterDPS>,
+    PlayoutScripts<Player_NOKDPS>,
+    PlayoutScripts<Player_Kiter_NOKDPS>,
+    PlayoutScripts<Player_Cluster>
+{
+public:
+
+    enum { NumScripts = 8, DefaultMoveLimit = 200 };
+
+private:
+
+    typedef void (Playout::*PlayFunction)(const size_t & moveLimit);
+
+    static const PlayFunction   PlayFunctions[NumScripts][NumScripts];
+
+    GameState                   _state;
+    MoveArray                   _moves[Constants::Num_Players];
+    std::vector<Action>         _scriptMoves[Constants::Num_Players];
+    size_t                      _rounds;
+
+    template <class ScriptType>
+    ScriptType &                getScript(const size_t & player);
+
+    template <class P1, class P2>
+    void                        playScripts(const size_t & moveLimit);
+
+public:
+
+    Playout();
+
+    // the index of the script in the play table, models which aren't scripts play as NOKDPS like they do in a Game
+    static const size_t         ScriptIndex(const size_t & playerModel);
+
+    // plays the state out, the final state is left in getState()
+    void                        play(const GameState & state, const size_t & p1Script, const size_t & p2Script, const size_t & moveLimit = DefaultMoveLimit);
+
+    // plays the state out and scores the final state with LTD2 for the player, like GameState::evalSim
+    const StateEvalScore        eval(const GameState & state, const size_t & player, const size_t & p1Script, const size_t & p2Script, const size_t & moveLimit = DefaultMoveLimit);
+
+    const GameState &           getState() const;
+    const size_t                getRounds() const;
+};
+
+typedef std::shared_ptr<Playout> PlayoutPtr;
+
+}
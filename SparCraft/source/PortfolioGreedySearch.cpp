@@ -8,6 +8,7 @@ PortfolioGreedySearch::PortfolioGreedySearch(const size_t & player, const size_t
 	, _iterations(iter)
     , _responses(responses)
     , _totalEvals(0)
+    , _cacheHits(0)
     , _timeLimit(timeLimit)
 {
 	_playerScriptPortfolio.push_back(PlayerModels::NOKDPS);
@@ -16,11 +17,19 @@ PortfolioGreedySearch::PortfolioGreedySearch(const size_t & player, const size_t
 
 std::vector<Action> PortfolioGreedySearch::search(const size_t & player, const GameState & state)
 {
+    PROFILE_FUNCTION();
+
     Timer t;
     t.start();
 
     const size_t enemyPlayer(state.getEnemy(player));
 
+    // cached scores are only good for the state they were played out from
+    _totalEvals = 0;
+    _cacheHits = 0;
+    _evalCache[Players::Player_One].clear();
+    _evalCache[Players::Player_Two].clear();
+
     // calculate the seed scripts for each player
     // they will be used to seed the initial root search
     size_t seedScript = calculateInitialSeed(player, state);
@@ -55,11 +64,19 @@ std::vector<Action> PortfolioGreedySearch::search(const size_t & player, const G
     GameState copy(state);
     currentScriptData.calculateMoves(player, moves, copy, moveVec);
 
-    _totalEvals = 0;
-
     return moveVec;
 }
 
+const size_t PortfolioGreedySearch::getTotalEvals() const
+{
+    return _totalEvals;
+}
+
+const size_t PortfolioGreedySearch::getCacheHits() const
+{
+    return _cacheHits;
+}
+
 void PortfolioGreedySearch::doPortfolioSearch(const size_t & player, const GameState & state, UnitScriptData & currentScriptData)
 {
     Timer t;
@@ -145,7 +162,16 @@ size_t PortfolioGreedySearch::calculateInitialSeed(const size_t & player, const
 
 StateEvalScore PortfolioGreedySearch::eval(const size_t & player, const GameState & state, UnitScriptData & playerScriptsChosen)
 {
-    const size_t enemyPlayer(state.getEnemy(player));
+    // the playouts are deterministic and all start from the searched state, so a script
+    // assignment seen before this search scores the same, which in the response rounds is most of them
+    const unsigned long long hash(playerScriptsChosen.getHash());
+    std::map<unsigned long long, StateEvalScore>::const_iterator cached(_evalCache[player].find(hash));
+
+    if (cached != _evalCache[player].end())
+    {
+        _cacheHits++;
+        return cached->second;
+    }
 
 	Game g(state, 100);
 
@@ -153,7 +179,10 @@ StateEvalScore PortfolioGreedySearch::eval(const size_t & player, const GameStat
 
     _totalEvals++;
 
-	return g.getState().eval(player, SparCraft::EvaluationMethods::LTD2);
+	const StateEvalScore score(g.getState().eval(player, SparCraft::EvaluationMethods::LTD2));
+    _evalCache[player][hash] = score;
+
+    return score;
 }
 
 void  PortfolioGreedySearch::setAllScripts(const size_t & player, const GameState & state, UnitScriptData & data, const size_t & script)
@@ -7,6 +7,7 @@
 #include "Action.h"
 #include "UnitScriptData.h"
 #include <memory>
+#include <map>
 
 namespace SparCraft
 {
@@ -23,8 +24,12 @@ protected:
     const size_t                _responses;
     std::vector<size_t>			_playerScriptPortfolio;
     size_t                      _totalEvals;
+    size_t                      _cacheHits;
     size_t                      _timeLimit;
 
+    // playout scores of the script assignments evaluated this search, by player and assignment hash
+    std::map<unsigned long long, StateEvalScore> _evalCache[Constants::Num_Players];
+
     void                        doPortfolioSearch(const size_t & player,const GameState & state,UnitScriptData & currentData);
     std::vector<Action>     getMoveVec(const size_t & player,const GameState & state,const std::vector<size_t> & playerScripts);
     StateEvalScore              eval(const size_t & player,const GameState & state,UnitScriptData & playerScriptsChosen);
@@ -35,6 +40,10 @@ public:
 
     PortfolioGreedySearch(const size_t & player, const size_t & enemyScript, const size_t & iter, const size_t & responses, const size_t & timeLimit);
     std::vector<Action> search(const size_t & player, const GameState & state);
+
+    // playouts done by the last search, and evaluations answered from the cache instead
+    const size_t        getTotalEvals() const;
+    const size_t        getCacheHits() const;
 };
 
 }
\ No newline at end of file
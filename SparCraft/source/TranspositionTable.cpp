@@ -1,4 +1,5 @@
 #include "TranspositionTable.h"
+#include <limits>
 
 using namespace SparCraft;
 
@@ -6,18 +7,21 @@ TTEntry::TTEntry()
 	: _hash2(0)
 	, _depth(0)
 	, _type(TTEntry::NONE)
+	, _firstPlayer(0)
+	, _generation(0)
 {
 
 }
 
 TTEntry::TTEntry(const HashType & hash2, const StateEvalScore & score, const size_t & depth, const int & type, 
-				const size_t & firstPlayer, const AlphaBetaMove & bestFirstMove, const AlphaBetaMove & bestSecondMove)
+				const size_t & firstPlayer, const unsigned short & generation)
 	: _hash2(hash2)
 	, _score(score)
-	, _depth(depth)
-	, _type(type)
+	, _depth((unsigned char)depth)
+	, _type((unsigned char)type)
+	, _firstPlayer((unsigned char)firstPlayer)
+	, _generation(generation)
 {
-	_bestMoves[firstPlayer] = TTBestMove(bestFirstMove, bestSecondMove);
 }
 
 const bool TTEntry::hashMatches(const HashType & hash2) const
@@ -32,81 +36,82 @@ const bool TTEntry::isValid() const
 
 const HashType & TTEntry::getHash()								const { return _hash2; }
 const StateEvalScore & TTEntry::getScore()						const { return _score; }
-const size_t & TTEntry::getDepth()								const { return _depth; }
-const int & TTEntry::getType()									const { return _type;  }
-const TTBestMove & TTEntry::getBestMove(const size_t & player)	const { return _bestMoves[player];  }
-void TTEntry::setBestMove(const size_t &firstPlayer, const AlphaBetaMove & bestFirstMove, const AlphaBetaMove & bestSecondMove)
+const size_t TTEntry::getDepth()								const { return _depth; }
+const int TTEntry::getType()									const { return _type;  }
+const size_t TTEntry::getFirstPlayer()							const { return _firstPlayer; }
+const unsigned short TTEntry::getGeneration()					const { return _generation; }
+void TTEntry::setGeneration(const unsigned short & generation)	{ _generation = generation; }
+
+TranspositionTable::TranspositionTable () 
+	: TranspositionTable(Constants::Transposition_Table_Size)
 {
-	_bestMoves[firstPlayer] = TTBestMove(bestFirstMove, bestSecondMove);
 }
 
-TranspositionTable::TranspositionTable () 
-	: TT(Constants::Transposition_Table_Size, TTEntry())
-	, size(Constants::Transposition_Table_Size)
+TranspositionTable::TranspositionTable (const size_t & numEntries) 
+	: TT(NULL)
+	, size(0)
+	, bucketMask(0)
+	, generation(0)
     , collisions(0)
     , lookups(0)
     , found(0)
     , notFound(0)
 	, saves(0)
-	, minIndex(0)
-	, maxIndex(0)
 	, saveOverwriteSelf(0)
 	, saveOverwriteOther(0)
 	, saveEmpty(0)
 {
-}
-	
-const TTEntry & TranspositionTable::operator [] (const size_t & hash) const
-{
-	return TT[getIndex(hash)];
-}
+	size_t numBuckets(1);
+	while (numBuckets * BucketSize < numEntries)
+	{
+		numBuckets *= 2;
+	}
 
-const TTEntry & TranspositionTable::get(const size_t & hash) const
-{
-	return TT[getIndex(hash)];
+	size = numBuckets * BucketSize;
+	bucketMask = numBuckets - 1;
+
+	// start the entries on a cache line so each bucket sits in exactly one
+	storage.resize(size * sizeof(TTEntry) + CacheLineSize);
+	const size_t misalignment((size_t)&storage[0] % CacheLineSize);
+	TT = (TTEntry *)&storage[misalignment ? CacheLineSize - misalignment : 0];
+
+	clear();
+	bestMoves.resize(size);
 }
-        
-const size_t TranspositionTable::getSaveIndex(const size_t & index, const HashType & hash2, const size_t & depth) const
+
+// the entry to overwrite in the bucket with this state's entry
+const size_t TranspositionTable::getSaveIndex(const size_t & bucket, const HashType & hash2) const
 {
-	size_t worstDepth(1000);
-	size_t worstDepthIndex(index);
+	size_t worstIndex(bucket);
+	int worstValue(std::numeric_limits<int>::max());
 
-	// scan ahead to find the best spot to store this entryw
-	for (size_t i(index); (i<(index+Constants::Transposition_Table_Scan)) && (i <TT.size()); ++i)
+	for (size_t i(bucket); i < bucket + BucketSize; ++i)
 	{
-		// if this index holds worse data about the current state, use it to overwrite
-		if (TT[i].getHash() == hash2 && TT[i].getDepth() < depth)
-		{
-			return i;
-		}
-		else if (TT[i].getHash() == hash2 && TT[i].getDepth() > depth)
-		{
-			printf("We shouldn't get here\n");
-		}
-		// otherwise if this entry is empty, use it
-		else if (!TT[i].isValid())
+		// an entry for the same state or an empty one is always used
+		if (!TT[i].isValid() || TT[i].hashMatches(hash2))
 		{
 			return i;
 		}
-		// otherwise if the hashes don't match, check to see how old the data is
-		else if (TT[i].getHash() != hash2)
+
+		// otherwise the oldest, then shallowest, entry is replaced
+		const unsigned short age(generation - TT[i].getGeneration());
+		const int value((int)TT[i].getDepth() - (int)Constants::Max_Search_Depth * age);
+
+		if (value < worstValue)
 		{
-			if (TT[i].getDepth() < worstDepth)
-			{
-				worstDepth = TT[i].getDepth();
-				worstDepthIndex = i;
-			}
+			worstValue = value;
+			worstIndex = i;
 		}
 	}
 
-	return worstDepthIndex;
+	return worstIndex;
 }
 
 void TranspositionTable::save(	const HashType & hash1, const HashType & hash2, const StateEvalScore & value, const size_t & depth, const int & type,
 			const size_t & firstPlayer, const AlphaBetaMove & bestFirstMove, const AlphaBetaMove & bestSecondMove)
 {
-	size_t indexToSave = getSaveIndex(getIndex(hash1), hash2, depth);
-	TTEntry existing = TT[indexToSave];
+	const size_t indexToSave = getSaveIndex(getBucketIndex(hash1), hash2);
+	const TTEntry & existing = TT[indexToSave];
 
 	if (existing.isValid())
 	{
@@ -126,61 +131,45 @@ void TranspositionTable::save(	const HashType & hash1, const HashType & hash2, c
 
 	saves++;
 	
-	TT[indexToSave] = TTEntry(hash2, value, depth, type, firstPlayer, bestFirstMove, bestSecondMove);
+	TT[indexToSave] = TTEntry(hash2, value, depth, type, firstPlayer, generation);
+	bestMoves[indexToSave].set(bestFirstMove, bestSecondMove);
 }
 
-TTEntry * TranspositionTable::lookupScan(const HashType & hash1, const HashType & hash2)
+// look up a state in the transposition table, return NULL if it isn't there
+TTEntry * TranspositionTable::lookup(const HashType & hash1, const HashType & hash2)
 {
 	lookups++;
-	size_t index = getIndex(hash1);
+	const size_t bucket = getBucketIndex(hash1);
 
-	// scan to see if this exists anywhere in the next few entries
-	for (size_t i(index); (i<(index+Constants::Transposition_Table_Scan)) && (i <TT.size()); ++i)
+	for (size_t i(bucket); i < bucket + BucketSize; ++i)
 	{
-		TTEntry * entry = lookup(i, hash2);
-
-		// if it does, return it
-		if (entry)
+		if (TT[i].isValid() && TT[i].hashMatches(hash2))
 		{
+			// an entry still being used shouldn't age out
+			TT[i].setGeneration(generation);
 			found++;
-			return entry;
+			return &TT[i];
 		}
 	}
 
-	// otherwise return null
 	notFound++;
 	return NULL;
 }
 
-// look up a value in the transposition table, return NULL if not found or collision
-TTEntry * TranspositionTable::lookup(const size_t & index, const HashType & hash2)
+const TTBestMove & TranspositionTable::getBestMove(const TTEntry * entry, const size_t & player) const
 {
-	if (index < minIndex) minIndex = index;
-	if (index > maxIndex) maxIndex = index;
-	
-	TTEntry tte = TT[index];
+	return entry->getFirstPlayer() == player ? bestMoves[entry - TT] : noBestMove;
+}
 
-	// if there is a valid entry at that location
-	if (TT[index].isValid())
-	{
-		// test for matching secondary hash
-		if (TT[index].hashMatches(hash2))
-		{
-			found++;
-			return &TT[index];
-		}
-		// if no match it is a collision
-		else
-		{
-			//collisions++;
-			return NULL;
-		}
-	}
-	else
-	{
-		//notFound++;
-		return NULL;
-	}
+void TranspositionTable::newGeneration()
+{
+	generation++;
+}
+
+void TranspositionTable::clear()
+{
+	std::fill(TT, TT + size, TTEntry());
+	generation = 0;
 }
 	
 const size_t & TranspositionTable::getSize()		const { return size; }
@@ -193,7 +182,7 @@ const size_t & TranspositionTable::numLookups()		const { return lookups; }
 const size_t TranspositionTable::getUsage() const
 {
 	size_t sum(0);
-	for (size_t i(0); i<TT.size(); ++i)
+	for (size_t i(0); i<size; ++i)
 	{
 		if (TT[i].isValid())
 		{
@@ -206,5 +195,5 @@ const size_t TranspositionTable::getUsage() const
 
 void TranspositionTable::print()
 {
-	std::cout << "TT stats: " << lookups << " lookups, " << found << " found, " << notFound << " not found, " << collisions << " collions. " << minIndex << " min, " << maxIndex << " max.\n";
-}
\ No newline at end of file
+	std::cout << "TT stats: " << lookups << " lookups, " << found << " found, " << notFound << " not found, " << collisions << " collions. " << size << " entries, generation " << (int)generation << ".\n";
+}
@@ -10,6 +10,8 @@
 namespace SparCraft
 {
 
+// 16 bytes, so that a bucket of 4 entries fills one 64 byte cache line. The best moves
+// found at the state are kept by the TranspositionTable apart from the entry.
 class TTEntry
 {	
 public:
@@ -20,15 +22,16 @@ private:
 
 	HashType			_hash2;
 	StateEvalScore		_score;
-	size_t				_depth;
-	TTBestMove			_bestMoves[2];
-	int					_type;
+	unsigned char		_depth;
+	unsigned char		_type : 4;
+	unsigned char		_firstPlayer : 4;
+	unsigned short		_generation;
 
 public:
 
 	TTEntry();
 	TTEntry(const HashType & hash2, const StateEvalScore & score, const size_t & depth, const int & type, 
-			const size_t & firstPlayer, const AlphaBetaMove & bestFirstMove, const AlphaBetaMove & bestSecondMove);
+			const size_t & firstPlayer, const unsigned short & generation);
 
 	const bool hashMatches(const HashType & hash2) const;
 
@@ -36,10 +39,11 @@ public:
 
 	const HashType & getHash()									const;
 	const StateEvalScore & getScore()							const;
-	const size_t & getDepth()									const;
-	const int & getType()										const;
-	const TTBestMove & getBestMove(const size_t & player)		const;
-	void setBestMove(const size_t &firstPlayer, const AlphaBetaMove & bestFirstMove, const AlphaBetaMove & bestSecondMove);
+	const size_t getDepth()										const;
+	const int getType()											const;
+	const size_t getFirstPlayer()								const;
+	const unsigned short getGeneration()						const;
+	void setGeneration(const unsigned short & generation);
 
 	void print() const
 	{
@@ -76,22 +80,45 @@ public:
 	TTEntry * entry() const		{ return _entry; }
 };
 
+/*----------------------------------------------------------------------
+ | Transposition Table
+ |----------------------------------------------------------------------
+ | Entries are kept in buckets of BucketSize which line up with cache
+ | lines, and a state's primary hash picks its bucket with a mask, so a
+ | lookup reads one cache line and copies nothing. The number of buckets
+ | is a power of two, enough for at least the number of entries asked
+ | for.
+ |
+ | Every search starts a new generation. When a bucket is full the entry
+ | replaced is the one from the oldest generation, shallowest first, so
+ | a table kept for a whole game isn't crowded out by entries of
+ | decisions long gone. Generations are 16 bits, so ages only wrap
+ | after 65536 searches.
+ `----------------------------------------------------------------------*/
 class TranspositionTable 
 {
-	//Array<TTEntry, Constants::Transposition_Table_Size>	TT;
-	//TTEntry TT[Constants::Transposition_Table_Size];
-	std::vector<TTEntry> TT;
+	enum { BucketSize = 4, CacheLineSize = 64 };
+
+	std::vector<char>		storage;			// the entries, with room to start them on a cache line
+	TTEntry *				TT;
+	std::vector<TTBestMove>	bestMoves;			// the best moves of the entry at the same index of TT
+	TTBestMove				noBestMove;
 
 	size_t			size;
+	size_t			bucketMask;
+	unsigned short	generation;
 
-	size_t			minIndex,
-					maxIndex;
+	// entries point into storage, so the table can't be copied
+	TranspositionTable(const TranspositionTable & rhs);
+	TranspositionTable & operator = (const TranspositionTable & rhs);
 
-	const size_t getIndex(const HashType & hash1) const
+	const size_t getBucketIndex(const HashType & hash1) const
 	{
-		return hash1 % size; 
+		return (hash1 & bucketMask) * BucketSize;
 	}
 
+	const size_t getSaveIndex(const size_t & bucket, const HashType & hash2) const;
+
 public:
 
 	size_t			collisions,
@@ -104,18 +131,19 @@ public:
 					saveEmpty;
 
 	TranspositionTable ();
-	
-	const TTEntry & operator [] (const size_t & hash) const;
-
-	const TTEntry & get(const size_t & hash) const;
-        
-	void save(const HashType & hash1, const TTEntry & entry) ;
+	TranspositionTable (const size_t & numEntries);
 
 	void save(	const HashType & hash1, const HashType & hash2, const StateEvalScore & value, const size_t & depth, const int & type,
 				const size_t & firstPlayer, const AlphaBetaMove & bestFirstMove, const AlphaBetaMove & bestSecondMove);
 
-	TTEntry * lookup(const size_t & index, const HashType & hash2);
-	TTEntry * lookupScan(const HashType & hash1, const HashType & hash2);
+	TTEntry * lookup(const HashType & hash1, const HashType & hash2);
+
+	// the best moves saved with an entry returned by lookup, invalid moves for the player who didn't move first
+	const TTBestMove & getBestMove(const TTEntry * entry, const size_t & player) const;
+
+	// ages every entry in the table by one generation
+	void newGeneration();
+	void clear();
 	
 	const size_t & getSize()		const;
 	const size_t & numFound()		const;	
@@ -126,8 +154,6 @@ public:
 
 	const size_t getUsage() const;
 
-	const size_t getSaveIndex(const size_t & index, const HashType & hash2, const size_t & depth) const;
-
 	void print();
 };
 
@@ -2,10 +2,32 @@
 
 #include "Common.h"
 #include "Action.h"
+#include <algorithm>
+#include <limits>
 
 namespace SparCraft
 {
 
+// all-moves-as-first statistics of one unit action, see UCTSearch::updateRAVE
+class UCTRaveStat
+{
+public:
+
+    unsigned long long          key;                // UCTSearch::getRaveKey of the unit action
+    size_t                      visits;
+    double                      wins;
+    size_t                      lastTraversal;      // so a traversal only counts an action once
+
+    UCTRaveStat(const unsigned long long k = 0)
+        : key(k)
+        , visits(0)
+        , wins(0)
+        , lastTraversal(std::numeric_limits<size_t>::max())
+    {
+    }
+
+    const bool operator < (const UCTRaveStat & rhs) const { return key < rhs.key; }
+};
 
 class UCTNode
 {
@@ -21,6 +43,11 @@ class UCTNode
 
     // holds children
     std::vector<UCTNode>        _children;
+    bool                        _allChildren;       // every move has been made a child, for progressive widening
+
+    // RAVE: the unit actions of _move, and the statistics of the unit actions in the children's moves
+    std::vector<unsigned long long> _raveKeys;
+    std::vector<UCTRaveStat>    _raveStats;         // sorted by key
 
     // nodes for traversing the tree
     UCTNode *                   _parent;
@@ -33,6 +60,7 @@ public:
         , _uctVal               (0)
         , _player               (Players::Player_None)
         , _nodeType             (SearchNodeType::Default)
+        , _allChildren          (false)
         , _parent               (NULL)
     {
 
@@ -45,6 +73,7 @@ public:
         , _player               (player)
         , _nodeType             (nodeType)
         , _move                 (move)
+        , _allChildren          (false)
         , _parent               (parent)
     {
         _children.reserve(maxChildren);
@@ -61,7 +90,10 @@ public:
     UCTNode *       getParent()                 const           { return _parent; }
     UCTNode &       getChild(const size_t & c)                  { return _children[c]; }
 
+    const bool      hasAllChildren()            const           { return _allChildren; }
+
     void            setUCTVal(double val)                       { _uctVal = val; }
+    void            setAllChildren()                            { _allChildren = true; }
     void            incVisits()                                 { _numVisits++; }
     void            addWins(double val)                         { _numWins += val; }
 
@@ -77,6 +109,35 @@ public:
         _move = move;
     }
 
+    const std::vector<unsigned long long> & getRaveKeys() const
+    {
+        return _raveKeys;
+    }
+
+    void setRaveKeys(const std::vector<unsigned long long> & keys)
+    {
+        _raveKeys = keys;
+    }
+
+    // makes sure there are statistics for the unit action
+    void addRaveStat(const unsigned long long & key)
+    {
+        std::vector<UCTRaveStat>::iterator it = std::lower_bound(_raveStats.begin(), _raveStats.end(), UCTRaveStat(key));
+
+        if (it == _raveStats.end() || it->key != key)
+        {
+            _raveStats.insert(it, UCTRaveStat(key));
+        }
+    }
+
+    // the statistics of the unit action, NULL if none of the children have it
+    UCTRaveStat * getRaveStat(const unsigned long long & key)
+    {
+        std::vector<UCTRaveStat>::iterator it = std::lower_bound(_raveStats.begin(), _raveStats.end(), UCTRaveStat(key));
+
+        return (it == _raveStats.end() || it->key != key) ? NULL : &(*it);
+    }
+
     void addChild(UCTNode * parent, const size_t player, const size_t nodeType, const std::vector<Action> & move, const size_t & maxChildren, std::vector<UCTNode> * fromPool = NULL)
     {
         _children.push_back(UCTNode(parent, player, nodeType, move, maxChildren));
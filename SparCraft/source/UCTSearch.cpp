@@ -2,9 +2,28 @@
 
 using namespace SparCraft;
 
+static const bool SameMove(const std::vector<Action> & a, const std::vector<Action> & b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+
+    for (size_t i(0); i<a.size(); ++i)
+    {
+        if (a[i].unit() != b[i].unit() || a[i].type() != b[i].type() || a[i].index() != b[i].index())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 UCTSearch::UCTSearch(const UCTSearchParameters & params) 
 	: _params(params)
     , _memoryPool(NULL)
+    , _playout(new Playout())
 {
     for (size_t p(0); p<Constants::Num_Players; ++p)
     {
@@ -29,16 +48,28 @@ void UCTSearch::setMemoryPool(UCTMemoryPool * pool)
 
 void UCTSearch::doSearch(GameState & initialState, std::vector<Action> & move)
 {
+    PROFILE_FUNCTION();
+
     Timer t;
     t.start();
 
     _rootNode = UCTNode(NULL, Players::Player_None, SearchNodeType::RootNode, _actionVec, _params.maxChildren(), _memoryPool ? _memoryPool->alloc() : NULL);
 
+    // every traversal starts from a copy of the initial state, which is made once and then
+    // only has the units the previous traversal changed copied back into it
+    _currentState.copyFrom(initialState);
+
     // do the required number of traversals
     for (size_t traversals(0); traversals < _params.maxTraversals(); ++traversals)
     {
-        GameState state(initialState);
-        traverse(_rootNode, state);
+        if (traversals)
+        {
+            _currentState.restoreFrom(initialState);
+        }
+
+        _path.clear();
+
+        traverse(_rootNode, _currentState);
 
         if (traversals && (traversals % 5 == 0))
         {
@@ -253,6 +284,12 @@ UCTNode & UCTSearch::UCTNodeSelect(UCTNode & parent)
 		if (child.numVisits() > 0)
 		{
 			double winRate    = (double)child.numWins() / (double)child.numVisits();
+
+            if (_params.rave())
+            {
+                winRate = getRaveValue(parent, child, winRate);
+            }
+
             double uctVal     = _params.cValue() * sqrt( log( (double)parent.numVisits() ) / ( child.numVisits() ) );
 			currentVal        = maxPlayer ? (winRate + uctVal) : (winRate - uctVal);
             
@@ -315,7 +352,7 @@ StateEvalScore UCTSearch::traverse(UCTNode & node, GameState & currentState)
         updateState(node, currentState, true);
 
         // do the playout
-        playoutVal = currentState.eval(_params.maxPlayer(), _params.evalMethod(), _params.simScript(Players::Player_One), _params.simScript(Players::Player_Two));
+        playoutVal = currentState.eval(_params.maxPlayer(), _params.evalMethod(), _params.simScript(Players::Player_One), _params.simScript(Players::Player_Two), _playout.get());
 
         _results.nodesVisited++;
     }
@@ -331,14 +368,26 @@ StateEvalScore UCTSearch::traverse(UCTNode & node, GameState & currentState)
         }
         else
         {
-            // if the children haven't been generated yet
-            if (!node.hasChildren())
+            // add children as the node is visited more, or all of them if the children haven't been generated yet
+            if (_params.progressiveWidening())
+            {
+                widenChildren(node, currentState);
+            }
+            else if (!node.hasChildren())
             {
                 generateChildren(node, currentState);
             }
 
             UCTNode & next = UCTNodeSelect(node);
+            const size_t pathIndex(_path.size());
+            _path.push_back(&next);
+
             playoutVal = traverse(next, currentState);
+
+            if (_params.rave())
+            {
+                updateRAVE(node, pathIndex, playoutVal);
+            }
         }
     }
 
@@ -373,9 +422,152 @@ void UCTSearch::generateChildren(UCTNode & node, GameState & state)
     // for each child of this state, add a child to the current node
     for (size_t child(0); (child < _params.maxChildren()) && getNextMove(playerToMove, _moveArray, child, _actionVec); ++child)
     {
-        // add the child to the tree
-        node.addChild(&node, playerToMove, getChildNodeType(node, state), _actionVec, _params.maxChildren(), _memoryPool ? _memoryPool->alloc() : NULL);
-        _results.nodesCreated++;
+        addChild(node, state, playerToMove);
+    }
+}
+
+// Progressive widening: a node visited n times can have ceil(C * n^exponent) children, and each
+// new child is the first move generateChildren would make that isn't a child yet. The script
+// moves come first, so the few children a node starts with are the best informed ones.
+void UCTSearch::widenChildren(UCTNode & node, GameState & state)
+{
+    const double allowedChildren(std::ceil(_params.wideningConstant() * pow((double)node.numVisits(), _params.wideningExponent())));
+    const size_t maxChildren(std::min(_params.maxChildren(), (size_t)std::max(1.0, allowedChildren)));
+
+    if (node.hasAllChildren() || (node.numChildren() >= maxChildren))
+    {
+        return;
+    }
+
+    // the children have to be moves of the same player whichever way the player to move is chosen
+    const size_t playerToMove(node.hasChildren() ? node.getChild(0).getPlayer() : getPlayerToMove(node, state));
+
+    state.generateMoves(_moveArray, playerToMove);
+    _moveArray.shuffleMoveActions();
+    generateOrderedMoves(state, _moveArray, playerToMove);
+
+    for (size_t move(0); node.numChildren() < maxChildren; ++move)
+    {
+        if (!getNextMove(playerToMove, _moveArray, move, _actionVec))
+        {
+            // getNextMove also stops at maxChildren moves, which after skipping the moves that are
+            // children already doesn't mean there are no others, the next call shuffles again
+            if (!_moveArray.hasMoreMoves() || (_params.playerModel(playerToMove) != PlayerModels::None))
+            {
+                node.setAllChildren();
+            }
+
+            return;
+        }
+
+        bool isChild(false);
+        for (size_t c(0); c < node.numChildren() && !isChild; ++c)
+        {
+            isChild = SameMove(node.getChild(c).getMove(), _actionVec);
+        }
+
+        if (!isChild)
+        {
+            addChild(node, state, playerToMove);
+        }
+    }
+}
+
+// adds _actionVec as a child of the node
+void UCTSearch::addChild(UCTNode & node, GameState & state, const size_t & playerToMove)
+{
+    // add the child to the tree
+    node.addChild(&node, playerToMove, getChildNodeType(node, state), _actionVec, _params.maxChildren(), _memoryPool ? _memoryPool->alloc() : NULL);
+    _results.nodesCreated++;
+
+    if (_params.rave())
+    {
+        _raveKeys.clear();
+        for (size_t a(0); a < _actionVec.size(); ++a)
+        {
+            _raveKeys.push_back(getRaveKey(state, _actionVec[a]));
+            node.addRaveStat(_raveKeys.back());
+        }
+
+        node.getChildren().back().setRaveKeys(_raveKeys);
+    }
+}
+
+// Unit actions are identified by unit IDs rather than indices, which change as units are sorted,
+// so the same action means the same thing in every state below a node
+const unsigned long long UCTSearch::getRaveKey(const GameState & state, const Action & action) const
+{
+    const Unit & unit(state.getUnit(action.player(), action.unit()));
+    unsigned long long target(action.index());
+
+    if (action.type() == ActionTypes::ATTACK)
+    {
+        target = state.getUnit(state.getEnemy(action.player()), action.index()).ID();
+    }
+    else if (action.type() == ActionTypes::HEAL)
+    {
+        target = state.getUnit(action.player(), action.index()).ID();
+    }
+
+    return ((unsigned long long)unit.ID() << 32) | ((unsigned long long)action.type() << 24) | (target & 0xFFFFFF);
+}
+
+// the child's win rate blended with the RAVE win rate of its unit actions, which is trusted less
+// the more the child itself has been visited
+const double UCTSearch::getRaveValue(UCTNode & parent, UCTNode & child, const double & winRate) const
+{
+    double raveWins(0), raveVisits(0);
+
+    const std::vector<unsigned long long> & keys(child.getRaveKeys());
+    for (size_t k(0); k < keys.size(); ++k)
+    {
+        const UCTRaveStat * stat(parent.getRaveStat(keys[k]));
+
+        if (stat)
+        {
+            raveWins += stat->wins;
+            raveVisits += stat->visits;
+        }
+    }
+
+    if (raveVisits == 0)
+    {
+        return winRate;
+    }
+
+    const double equivalence(_params.raveEquivalence());
+    const double beta(sqrt(equivalence / (3 * child.numVisits() + equivalence)));
+
+    return (1 - beta) * winRate + beta * (raveWins / raveVisits);
+}
+
+// All moves as first: each unit action the children's player made anywhere below the node in
+// this traversal gets the traversal's result at the node, so sibling moves which share unit
+// actions share what has been learned about them
+void UCTSearch::updateRAVE(UCTNode & node, const size_t & pathIndex, const StateEvalScore & playoutVal)
+{
+    const size_t player(_path[pathIndex]->getPlayer());
+    const double wins(playoutVal.val() > 0 ? 1 : (playoutVal.val() == 0 ? 0.5 : 0));
+
+    for (size_t n(pathIndex); n < _path.size(); ++n)
+    {
+        if (_path[n]->getPlayer() != player)
+        {
+            continue;
+        }
+
+        const std::vector<unsigned long long> & keys(_path[n]->getRaveKeys());
+        for (size_t k(0); k < keys.size(); ++k)
+        {
+            UCTRaveStat * stat(node.getRaveStat(keys[k]));
+
+            if (stat && (stat->lastTraversal != (size_t)_results.traversals))
+            {
+                stat->lastTraversal = (size_t)_results.traversals;
+                stat->visits++;
+                stat->wins += wins;
+            }
+        }
     }
 }
 
@@ -384,7 +576,7 @@ StateEvalScore UCTSearch::performPlayout(GameState & state)
     GameState copy(state);
     copy.finishedMoving();
 
-    return copy.eval(_params.maxPlayer(), _params.evalMethod(), _params.simScript(Players::Player_One), _params.simScript(Players::Player_Two));
+    return copy.eval(_params.maxPlayer(), _params.evalMethod(), _params.simScript(Players::Player_One), _params.simScript(Players::Player_Two), _playout.get());
 }
 
 const bool UCTSearch::isRoot(UCTNode & node) const
@@ -8,6 +8,7 @@
 #include "GraphViz.hpp"
 #include "Array.hpp"
 #include "MoveArray.h"
+#include "Playout.h"
 #include "UCTSearchParameters.hpp"
 #include "UCTSearchResults.hpp"
 #include "Player.h"
@@ -42,6 +43,13 @@ class UCTSearch
     std::vector<PlayerPtr>					_allScripts[Constants::Num_Players];
     PlayerPtr                               _playerModels[Constants::Num_Players];
 
+    // plays out the new nodes when they are evaluated by playout
+    PlayoutPtr                              _playout;
+
+    // the nodes below the root this traversal went through, and the unit action keys of a new child
+    std::vector<UCTNode *>                  _path;
+    std::vector<unsigned long long>         _raveKeys;
+
 public:
 
 	UCTSearch(const UCTSearchParameters & params);
@@ -56,6 +64,8 @@ public:
     
     // Move and Child generation functions
     void            generateChildren(UCTNode & node, GameState & state);
+    void            widenChildren(UCTNode & node, GameState & state);
+    void            addChild(UCTNode & node, GameState & state, const size_t & playerToMove);
 	void            generateOrderedMoves(GameState & state, MoveArray & moves, const size_t & playerToMove);
     void            makeMove(UCTNode & node, GameState & state);
 	const bool      getNextMove(size_t playerToMove, MoveArray & moves, const size_t & moveNumber, std::vector<Action> & actionVec);
@@ -70,6 +80,11 @@ public:
     const bool      isSecondSimMove(UCTNode & node, GameState & state);
     StateEvalScore  performPlayout(GameState & state);
     void            updateState(UCTNode & node, GameState & state, bool isLeaf);
+
+    // RAVE functions
+    const unsigned long long getRaveKey(const GameState & state, const Action & action) const;
+    const double    getRaveValue(UCTNode & parent, UCTNode & child, const double & winRate) const;
+    void            updateRAVE(UCTNode & node, const size_t & pathIndex, const StateEvalScore & playoutVal);
     void            setMemoryPool(UCTMemoryPool * pool);
     UCTSearchResults & getResults();
 
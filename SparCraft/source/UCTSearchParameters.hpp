@@ -27,6 +27,12 @@ class SparCraft::UCTSearchParameters
 	size_t		    _playerToMoveMethod;		    // Alternate			The player to move policy
 	size_t		    _playerModel[2];                // None                 Player model to use for each player
 
+    bool            _progressiveWidening;           // false                Add children as a node is visited rather than all at once
+    double          _wideningConstant;              // 1                    A node visited n times has up to ceil(C * n^exponent) children
+    double          _wideningExponent;              // 0.5
+    bool            _rave;                          // false                Blend child values with the RAVE values of their unit actions
+    double          _raveEquivalence;               // 300                  Visits at which the child and RAVE values are weighted equally
+
     std::string     _graphVizFilename;              // ""                   File name to output graph viz file
 
     std::vector<size_t> _orderedMoveScripts;
@@ -46,6 +52,11 @@ public:
         , _moveOrdering         (MoveOrderMethod::ScriptFirst)
         , _evalMethod           (SparCraft::EvaluationMethods::Playout)
 	    , _playerToMoveMethod   (SparCraft::PlayerToMove::Alternate)
+        , _progressiveWidening  (false)
+        , _wideningConstant     (1)
+        , _wideningExponent     (0.5)
+        , _rave                 (false)
+        , _raveEquivalence      (300)
     {
 	    setPlayerModel(Players::Player_One, PlayerModels::None);
 	    setPlayerModel(Players::Player_Two, PlayerModels::None);
@@ -65,6 +76,11 @@ public:
     const size_t & rootMoveSelectionMethod()                    const   { return _rootMoveSelection; }
     const std::string & graphVizFilename()                      const   { return _graphVizFilename; }
     const std::vector<size_t> & getOrderedMoveScripts()         const   { return _orderedMoveScripts; }
+    const bool & progressiveWidening()                          const   { return _progressiveWidening; }
+    const double & wideningConstant()                           const   { return _wideningConstant; }
+    const double & wideningExponent()                           const   { return _wideningExponent; }
+    const bool & rave()                                         const   { return _rave; }
+    const double & raveEquivalence()                            const   { return _raveEquivalence; }
 	
     void setMaxPlayer(const size_t & player)					        { _maxPlayer = player; }
     void setTimeLimit(const size_t & timeLimit)					        { _timeLimit = timeLimit; }  
@@ -79,6 +95,10 @@ public:
     void setGraphVizFilename(const std::string & filename)              { _graphVizFilename = filename; }
     void addOrderedMoveScript(const size_t & script)                    { _orderedMoveScripts.push_back(script); }
     void setPlayerModel(const size_t & player, const size_t & model)	{ _playerModel[player] = model; }	
+    void setProgressiveWidening(const bool & widening)                  { _progressiveWidening = widening; }
+    void setWidening(const double & constant, const double & exponent)  { _wideningConstant = constant; _wideningExponent = exponent; }
+    void setRAVE(const bool & rave)                                     { _rave = rave; }
+    void setRAVEEquivalence(const double & equivalence)                 { _raveEquivalence = equivalence; }
 
     std::vector<std::vector<std::string> > & getDescription()
     {
@@ -97,6 +117,7 @@ public:
             _desc[0].push_back("Move Ordering:");
             _desc[0].push_back("Player To Move:");
             _desc[0].push_back("Opponent Model:");
+            _desc[0].push_back("Children:");
 
             ss << "UCT";                                                _desc[1].push_back(ss.str()); ss.str(std::string());
             ss << timeLimit() << "ms";                                  _desc[1].push_back(ss.str()); ss.str(std::string());
@@ -106,6 +127,7 @@ public:
             ss << MoveOrderMethod::getName(moveOrderingMethod());         _desc[1].push_back(ss.str()); ss.str(std::string());
             ss << PlayerToMove::getName(playerToMoveMethod());            _desc[1].push_back(ss.str()); ss.str(std::string());
             ss << PlayerModels::getName(playerModel((maxPlayer()+1)%2));  _desc[1].push_back(ss.str()); ss.str(std::string());
+            ss << (progressiveWidening() ? "Widening" : "All") << (rave() ? " RAVE" : "");  _desc[1].push_back(ss.str()); ss.str(std::string());
         }
         
         return _desc;
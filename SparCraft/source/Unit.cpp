@@ -482,7 +482,7 @@ const HealthType Unit::healCost() const
 
 const float Unit::dpf() const 
 { 
-    return (float)std::max(Constants::Min_Unit_DPF, (float)damage() / ((float)attackCooldown() + 1)); 
+    return UnitProperties::Get(_unitType).GetDPF(); 
 }
 
 const TimeType Unit::moveCooldown() const 
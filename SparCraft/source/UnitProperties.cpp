@@ -4,6 +4,7 @@ using namespace SparCraft;
 using namespace BWAPI::UpgradeTypes;
 
 UnitProperties UnitProperties::props[256];
+float UnitProperties::sqrtHP[1024];
 
 UnitProperties::UnitProperties() : 
 	capacityUpgrade(BWAPI::UpgradeTypes::None),
@@ -22,6 +23,10 @@ void UnitProperties::SetType(BWAPI::UnitType type)
 	sightRange[0]	= sightRange[1]		= type.sightRange() << pixelShift;
 	extraArmor[0]	= extraArmor[1]		= 0;
 	speed[0]		= speed[1]			= static_cast<int>((1 << pixelShift) * type.topSpeed());
+
+	// damage per frame of the ground weapon, a zealot hits twice per attack
+	const HealthType damage			= (HealthType)type.groundWeapon().damageAmount() * (type == BWAPI::UnitTypes::Protoss_Zealot ? 2 : 1);
+	dpf								= (float)std::max(Constants::Min_Unit_DPF, (float)damage / ((float)type.groundWeapon().damageCooldown() + 1));
 }
 
 void UnitProperties::SetSpeedUpgrade(BWAPI::UpgradeType upgrade, double rate)
@@ -64,6 +69,11 @@ void UnitProperties::Init()
 		props[type.getID()].SetType(type);
 	}
 
+	for (int hp(0); hp < 1024; ++hp)
+	{
+		sqrtHP[hp] = sqrtf((float)hp);
+	}
+
 	const double standardSpeed(Terran_SCV.topSpeed());
 
 	props[BWAPI::UnitTypes::Terran_Ghost.getID()            ].SetEnergyUpgrade(Moebius_Reactor);
@@ -12,6 +12,7 @@ class PlayerProperties;
 class UnitProperties
 {
 	static UnitProperties		props[256];
+	static float				sqrtHP[1024];
 
 	BWAPI::UnitType				type;
 
@@ -26,6 +27,7 @@ class UnitProperties
 	int							maxEnergy[2];
 	int							sightRange[2];
 	int							speed[2];
+	float						dpf;
 
 	void						SetCapacityUpgrade(BWAPI::UpgradeType upgrade, int capacity0, int capacity1);
 	void						SetEnergyUpgrade(BWAPI::UpgradeType upgrade);
@@ -43,10 +45,13 @@ public:
 	int							GetSight(const PlayerProperties & player) const		{ return sightRange[player.GetUpgradeLevel(sightUpgrade)]; }
 	int							GetSpeed(const PlayerProperties & player) const		{ return speed[player.GetUpgradeLevel(speedUpgrade)]; }
 
+	float						GetDPF() const										{ return dpf; }
+
 	const WeaponProperties &			GetGroundWeapon() const						{ return WeaponProperties::Get(type.groundWeapon()); }
 	const WeaponProperties &			GetAirWeapon() const						{ return WeaponProperties::Get(type.airWeapon()); }
 
 	static const UnitProperties &	Get(BWAPI::UnitType type)					{ return props[type.getID()]; }
+	static float				GetSqrtHP(HealthType hp)					{ return hp >= 0 && hp < 1024 ? sqrtHP[hp] : sqrtf(hp); }
 	static void					Init();
 };
 }
\ No newline at end of file
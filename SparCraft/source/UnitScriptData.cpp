@@ -2,7 +2,24 @@
 
 using namespace SparCraft;
 
+// a well mixed 64 bit key for one unit playing one script, the hash of a whole
+// script assignment is these xor'ed together so it doesn't depend on the order
+// the scripts were set in
+static const unsigned long long ScriptKey(const size_t & player, const int & id, const size_t & script)
+{
+    unsigned long long key(((unsigned long long)player << 56) ^ ((unsigned long long)(unsigned int)id << 16) ^ (unsigned long long)script);
+
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+
+    return key;
+}
+
 UnitScriptData::UnitScriptData() 
+    : _hash(0)
 {
 }
 
@@ -79,8 +96,25 @@ void UnitScriptData::setUnitScript(const size_t & player, const int & id, const
         _scriptVec[player].push_back(script);
         _playerPtrVec[player].push_back(PlayerPtr(AllPlayers::getPlayerPtr(player, script)));
     }
-        
-    _unitScriptMap[player][id] = script;
+
+    std::map<int, size_t>::iterator it(_unitScriptMap[player].find(id));
+
+    if (it == _unitScriptMap[player].end())
+    {
+        _unitScriptMap[player][id] = script;
+    }
+    else
+    {
+        _hash ^= ScriptKey(player, id, it->second);
+        it->second = script;
+    }
+
+    _hash ^= ScriptKey(player, id, script);
+}
+
+const unsigned long long UnitScriptData::getHash() const
+{
+    return _hash;
 }
 
 void UnitScriptData::setUnitScript(const Unit & unit, const size_t & script)
@@ -21,6 +21,9 @@ class UnitScriptData
     std::set<size_t>        _scriptSet[2];
     std::vector<size_t>     _scriptVec[2];
     std::vector<PlayerPtr>  _playerPtrVec[2];
+
+    // hash of every unit's script for both players, kept up to date by setUnitScript
+    unsigned long long      _hash;
     
    
     std::vector<Action>       _allScriptMoves[2][PlayerModels::Size];
@@ -42,5 +45,6 @@ public:
     const size_t &      getScript(const size_t & player, const size_t & index);
     const PlayerPtr &   getPlayerPtr(const size_t & player, const size_t & index);
     const size_t        getNumScripts(const size_t & player) const;
+    const unsigned long long getHash() const;
 };
 }
\ No newline at end of file
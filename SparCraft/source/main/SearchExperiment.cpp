@@ -620,6 +620,24 @@ void SearchExperiment::addPlayer(const std::string & line)
         params.setPlayerToMoveMethod(playerToMoveID);
         //params.setGraphVizFilename("__uct.txt");
 
+        // optional trailing options
+        std::string option;
+        while (iss >> option)
+        {
+            if (option.compare("ProgressiveWidening") == 0)
+            {
+                params.setProgressiveWidening(true);
+            }
+            else if (option.compare("RAVE") == 0)
+            {
+                params.setRAVE(true);
+            }
+            else
+            {
+                System::FatalError("Invalid UCT option in Configuration File: " + option);
+            }
+        }
+
         // add scripts for move ordering
         if (moveOrderingID == MoveOrderMethod::ScriptFirst)
         {
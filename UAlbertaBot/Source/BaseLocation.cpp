@@ -10,6 +10,21 @@ using namespace UAlbertaBot;
 
 const int NearBaseLocationTileDistance = 20;
 
+// the pixel bounding box around a set of resources, top and bottom are flipped to match BaseLocation::draw
+static void GetResourceBox(const std::vector<BWAPI::Unit> &resources, int &left, int &right, int &top, int &bottom)
+{
+	const int resWidth = 32;
+	const int resHeight = 32;
+
+	for (auto &resource : resources)
+	{
+		left = std::min(left, resource->getPosition().x - resWidth);
+		right = std::max(right, resource->getPosition().x + resWidth);
+		top = std::max(top, resource->getPosition().y + resHeight);
+		bottom = std::min(bottom, resource->getPosition().y - resHeight);
+	}
+}
+
 BaseLocation::BaseLocation(int baseID, const std::vector<BWAPI::Unit> &resources)
 	: m_baseID(baseID)
 {
@@ -44,21 +59,15 @@ BaseLocation::BaseLocation(int baseID, const std::vector<BWAPI::Unit> &resources
 			resourceCenterX += resource->getPosition().x;
 			resourceCenterY += resource->getPosition().y;
 		}
-
-		// set the limits of the base location bounding box
-		const int resWidth = 32;
-		const int resHeight = 32;
-
-		m_left = std::min(m_left, resource->getPosition().x - resWidth);
-		m_right = std::max(m_right, resource->getPosition().x + resWidth);
-		m_top = std::max(m_top, resource->getPosition().y + resHeight);
-		m_bottom = std::min(m_bottom, resource->getPosition().y - resHeight);
 	}
 
+	// set the limits of the base location bounding box
+	GetResourceBox(resources, m_left, m_right, m_top, m_bottom);
+
 	// calculate the center of the resources
 	const size_t numResources = m_minerals.size() + m_geysers.size();
 
-	m_centerOfResources = BWAPI::Position(m_left + (m_right - m_left) / 2, m_top + (m_bottom - m_top) / 2);
+	m_centerOfResources = GetResourceCenter(resources);
 
 	// compute this BaseLocation's DistanceMap, which will compute the ground distance
 	// from the center of its recourses to every other tile on the map
@@ -118,6 +127,19 @@ BaseLocation::BaseLocation(int baseID, const std::vector<BWAPI::Unit> &resources
 	}
 }
 
+// the center of the resources bounding box, which is where the base location's distance map is computed from
+BWAPI::Position BaseLocation::GetResourceCenter(const std::vector<BWAPI::Unit> &resources)
+{
+	int left = std::numeric_limits<int>::max();
+	int right = std::numeric_limits<int>::lowest();
+	int top = std::numeric_limits<int>::lowest();
+	int bottom = std::numeric_limits<int>::max();
+
+	GetResourceBox(resources, left, right, top, bottom);
+
+	return BWAPI::Position(left + (right - left) / 2, top + (bottom - top) / 2);
+}
+
 // TODO: calculate the actual depot position
 const BWAPI::TilePosition &BaseLocation::getDepotPosition() const
 {
@@ -33,6 +33,8 @@ namespace UAlbertaBot
 	public:
 		BaseLocation(int baseID, const std::vector<BWAPI::Unit> &resources);
 
+		static BWAPI::Position GetResourceCenter(const std::vector<BWAPI::Unit> &resources);
+
 		bool isConnected(const BWAPI::Position &pos) const;
 		int getGroundDistance(const BWAPI::Position &pos) const;
 		int getGroundDistance(const BWAPI::TilePosition &pos) const;
@@ -42,12 +42,13 @@ void BaseLocationManager::onStart()
 
 	// Use StarDraft to find the borders of the bases on the map
 	m_baseBorders = BaseBorderFinder(Global::Map().getStarDraftMap());
+	std::vector<std::vector<BWAPI::Unit>> baseResources(m_baseBorders.getBaseBorders().size());
 	for (size_t baseID = 0; baseID < m_baseBorders.getBaseBorders().size(); baseID++)
 	{
 		const auto &border = m_baseBorders.getBaseBorders()[baseID];
 
 		// fill a vector with all the resource units in the border
-		std::vector<BWAPI::Unit> resources;
+		std::vector<BWAPI::Unit> &resources = baseResources[baseID];
 
 		// for each static unit on the map
 		for (auto unit : BWAPI::Broodwar->getStaticNeutralUnits())
@@ -64,9 +65,22 @@ void BaseLocationManager::onStart()
 				}
 			}
 		}
+	}
 
-		// add a baselocation containing these resources
-		m_baseLocationData.push_back(BaseLocation(baseID, resources));
+	// compute every base location's distance map in parallel up front, rather than one at a time in the constructors
+	// if this map has been played before they are all loaded from the saved distance atlas instead
+	std::vector<BWAPI::TilePosition> distanceMapTiles;
+	for (auto &resources : baseResources)
+	{
+		distanceMapTiles.push_back(BWAPI::TilePosition(BaseLocation::GetResourceCenter(resources)));
+	}
+
+	Global::Map().precomputeDistanceMaps(distanceMapTiles);
+
+	// add a baselocation containing each set of resources
+	for (size_t baseID = 0; baseID < baseResources.size(); baseID++)
+	{
+		m_baseLocationData.push_back(BaseLocation(baseID, baseResources[baseID]));
 	}
 
 	// construct the vectors of base location pointers, this is safe since they will never change
@@ -92,6 +106,21 @@ void BaseLocationManager::onStart()
 		}
 	}
 
+	// building placement searches outward from depots and start locations, so precompute those too and save the atlas
+	distanceMapTiles.clear();
+	for (auto &baseLocation : m_baseLocationData)
+	{
+		distanceMapTiles.push_back(baseLocation.getDepotPosition());
+	}
+
+	for (auto &startTile : BWAPI::Broodwar->getStartLocations())
+	{
+		distanceMapTiles.push_back(startTile);
+	}
+
+	Global::Map().precomputeDistanceMaps(distanceMapTiles);
+	Global::Map().saveDistanceAtlas();
+
 	// construct the map of tile positions to base locations
 	for (int x = 0; x < BWAPI::Broodwar->mapWidth(); ++x)
 	{
@@ -0,0 +1,164 @@
+#include "CombatEstimator.h"
+
+using namespace UAlbertaBot;
+
+const double CombatEstimator::DefaultExponent = 1.5;
+const double CombatEstimator::DefaultBand = 2.0;
+
+CombatEstimator::CombatEstimator(double exponent, double band)
+	: m_exponent(exponent)
+	, m_band(band)
+{
+}
+
+void CombatEstimator::setBand(double band)
+{
+	m_band = band;
+}
+
+void CombatEstimator::setExponent(double exponent)
+{
+	m_exponent = exponent;
+}
+
+void CombatEstimator::GroupUnits(const SparCraft::GameState &state, size_t player, Side &side)
+{
+	for (size_t u(0); u < state.numUnits(player); ++u)
+	{
+		const SparCraft::Unit &unit = state.getUnit(player, u);
+		if (!unit.isAlive())
+		{
+			continue;
+		}
+
+		// there are only a handful of types in a fight, a linear search beats a map
+		size_t g = 0;
+		while (g < side.type.size() && side.type[g].type() != unit.type())
+		{
+			++g;
+		}
+
+		if (g == side.type.size())
+		{
+			side.type.push_back(unit);
+			side.count.push_back(0);
+			side.hp.push_back(0);
+		}
+
+		side.hasDetector |= unit.type().isDetector();
+		side.hasCloaked |= unit.type().hasPermanentCloak();
+		side.count[g] += 1;
+		side.hp[g] += unit.currentHP();
+		side.totalCount += 1;
+		side.totalHP += unit.currentHP();
+	}
+}
+
+// the damage rules of SparCraft::Unit::takeAttack, spread over the weapon cooldown
+float CombatEstimator::DamagePerFrame(const SparCraft::Unit &attacker, const SparCraft::Unit &target)
+{
+	if (attacker.getWeapon(target.type()).damageAmount() == 0)
+	{
+		return 0;
+	}
+
+	const SparCraft::PlayerWeapon weapon(attacker.getWeapon(target));
+
+	int damage = std::max((int)((weapon.GetDamageBase() - target.getArmor()) * weapon.GetDamageMultiplier(target.getSize())), 2);
+	if (attacker.type() == BWAPI::UnitTypes::Protoss_Zealot || attacker.type() == BWAPI::UnitTypes::Terran_Firebat)
+	{
+		damage *= 2;
+	}
+
+	return (float)damage / (weapon.GetCooldown() + 1);
+}
+
+// total enemy HP over the frames needed to kill it all, each enemy group taking the whole army's fire in turn
+float CombatEstimator::EffectiveDamage(const Side &attackers, const Side &targets)
+{
+	const size_t numAttackers = attackers.type.size();
+	std::vector<float> damage(numAttackers);
+	float frames = 0;
+
+	for (size_t t(0); t < targets.type.size(); ++t)
+	{
+		// the playout never targets a permanently cloaked unit no detector can see
+		const bool hidden = targets.type[t].type().hasPermanentCloak() && !attackers.hasDetector;
+
+		for (size_t a(0); a < numAttackers; ++a)
+		{
+			damage[a] = hidden ? 0 : DamagePerFrame(attackers.type[a], targets.type[t]);
+		}
+
+		float groupDamage = 0;
+		for (size_t a(0); a < numAttackers; ++a)
+		{
+			groupDamage += attackers.count[a] * damage[a];
+		}
+
+		// a group nobody can hit can never be killed
+		if (groupDamage <= 0)
+		{
+			return 0;
+		}
+
+		frames += targets.hp[t] / groupDamage;
+	}
+
+	return frames > 0 ? targets.totalHP / frames : 0;
+}
+
+CombatEstimate CombatEstimator::estimate(const SparCraft::GameState &state) const
+{
+	PROFILE_FUNCTION();
+
+	CombatEstimate estimate;
+	Side sides[2];
+
+	for (size_t p(0); p < 2; ++p)
+	{
+		GroupUnits(state, p, sides[p]);
+	}
+
+	for (size_t p(0); p < 2; ++p)
+	{
+		const Side &side = sides[p];
+		const Side &enemy = sides[1 - p];
+
+		if (side.totalCount > 0)
+		{
+			const double damage = enemy.totalCount > 0 ? EffectiveDamage(side, enemy) : 1;
+			estimate.strength[p] = damage * side.totalHP * std::pow((double)side.totalCount, m_exponent - 2);
+		}
+	}
+
+	const double ours = estimate.strength[SparCraft::Players::Player_One];
+	const double theirs = estimate.strength[SparCraft::Players::Player_Two];
+
+	// neither side can hurt the other, leave it to the simulation
+	if (ours <= 0 && theirs <= 0)
+	{
+		return estimate;
+	}
+
+	const double winner = std::max(ours, theirs);
+	const double loser = std::min(ours, theirs);
+
+	estimate.remaining = std::pow(1 - loser / winner, 1 / m_exponent);
+	estimate.confident = m_band > 1 && (loser <= 0 || winner / loser >= m_band);
+
+	// a detector only reveals cloaked units near it, which depends on positions the estimate ignores
+	for (size_t p(0); p < 2; ++p)
+	{
+		if (sides[p].hasCloaked && sides[1 - p].hasDetector)
+		{
+			estimate.confident = false;
+		}
+	}
+
+	// on the same scale as the LTD2 eval, 1000 is the winner losing nothing
+	const SparCraft::ScoreType magnitude = std::max(1, (int)(1000 * estimate.remaining));
+	estimate.score = ours >= theirs ? magnitude : -magnitude;
+
+	return estimate;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Common.h"
+
+#include "..\..\SparCraft\source\GameState.h"
+
+namespace UAlbertaBot
+{
+	struct CombatEstimate
+	{
+		double strength[2] = { 0, 0 };	// fighting strength of each SparCraft player
+		double remaining = 0;			// fraction of the winning army expected to survive
+		SparCraft::ScoreType score = 0;	// > 0 if Player_One is expected to win, same sign convention as the LTD2 eval
+		bool confident = false;			// the strength ratio is outside the band, the playout can be skipped
+	};
+
+	// Closed form estimate of a fight, used to skip the SparCraft playout when a fight is lopsided
+	//
+	// Units are grouped by type and every group's damage per frame against every enemy group is
+	// computed with the same weapon, armor, size and upgrade rules SparCraft uses. Each side's
+	// effective damage is its total HP to kill over the time it takes to kill it, one enemy group
+	// after the other, so units it can't hit at all make it unable to win. Permanently cloaked units
+	// can't be hit by a side without a detector. The fight is then solved
+	// with a generalized Lanchester model:
+	//
+	//   strength = DPF * HP * N^(exponent - 2)
+	//
+	// exponent 1 is the linear law (one on one melee), 2 the square law (ranged units focusing fire)
+	// and the winner keeps (1 - loserStrength / winnerStrength)^(1 / exponent) of its army
+	class CombatEstimator
+	{
+		// one unit type of one player, kept as parallel arrays so the loops over groups vectorize
+		struct Side
+		{
+			std::vector<SparCraft::Unit> type;	// first unit of each group, used for the weapon rules
+			std::vector<float> count;
+			std::vector<float> hp;
+			float totalCount = 0;
+			float totalHP = 0;
+			bool hasDetector = false;
+			bool hasCloaked = false;	// permanently cloaked units, which SparCraft never targets undetected
+		};
+
+		double m_exponent;
+		double m_band;
+
+		static void GroupUnits(const SparCraft::GameState &state, size_t player, Side &side);
+		static float DamagePerFrame(const SparCraft::Unit &attacker, const SparCraft::Unit &target);
+		static float EffectiveDamage(const Side &attackers, const Side &targets);
+
+	public:
+		// picked by checking the estimate against SparCraft NOKDPS playouts of 400 random armies,
+		// not fitted on real games. refit them from CombatPredictor battle logs with
+		// research/combatsim/CombatEstimatorCalibration once there are some
+		static const double DefaultExponent;
+		static const double DefaultBand;
+
+		CombatEstimator(double exponent = DefaultExponent, double band = DefaultBand);
+
+		// band is the strength ratio beyond which the estimate is trusted, <= 1 never trusts it
+		void setBand(double band);
+		void setExponent(double exponent);
+
+		CombatEstimate estimate(const SparCraft::GameState &state) const;
+	};
+}
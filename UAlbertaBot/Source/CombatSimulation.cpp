@@ -14,8 +14,6 @@ CombatSimulation::CombatSimulation()
 // this center will most likely be the position of the forwardmost combat unit we control
 void CombatSimulation::setCombatUnits(const BWAPI::Position &center, const int radius)
 {
-	SparCraft::GameState s;
-
 	BWAPI::Broodwar->drawCircleMap(center.x, center.y, 10, BWAPI::Colors::Red, true);
 
 	BWAPI::Unitset ourCombatUnits;
@@ -24,124 +22,76 @@ void CombatSimulation::setCombatUnits(const BWAPI::Position &center, const int r
 	Global::Map().getUnits(ourCombatUnits, center, Config::Micro::CombatRegroupRadius, true, false);
 	Global::Info().getNearbyForce(enemyCombatUnits, center, BWAPI::Broodwar->enemy(), Config::Micro::CombatRegroupRadius);
 
+	CombatSnapshot snapshot;
+
 	for (auto &unit : ourCombatUnits)
 	{
-		if (unit->getType().isWorker())
+		if (!Global::Info().isCombatUnit(unit->getType()))
 		{
 			continue;
 		}
 
-		if (Global::Info().isCombatUnit(unit->getType()) && SparCraft::System::isSupportedUnitType(unit->getType()))
-		{
-			try
-			{
-				s.addUnit(getSparCraftUnit(unit));
-			}
-			catch (int e)
-			{
-				e = 1;
-				BWAPI::Broodwar->printf("Problem Adding Self Unit with ID: %d", unit->getID());
-			}
-		}
+		CombatSnapshotUnit snapshotUnit;
+		snapshotUnit.type = unit->getType();
+		snapshotUnit.player = getSparCraftPlayerID(unit->getPlayer());
+		snapshotUnit.unitID = unit->getID();
+		snapshotUnit.x = unit->getPosition().x;
+		snapshotUnit.y = unit->getPosition().y;
+		snapshotUnit.hp = unit->getHitPoints() + unit->getShields();
+		snapshotUnit.completed = unit->isCompleted();
+		snapshot.addUnit(snapshotUnit);
 	}
 
 	for (UnitInfo &ui : enemyCombatUnits)
 	{
-		if (ui.type.isWorker())
-		{
-			continue;
-		}
-
-		if (ui.type == BWAPI::UnitTypes::Terran_Bunker)
-		{
-			double hpRatio = static_cast<double>(ui.lastHealth) / ui.type.maxHitPoints();
-
-			SparCraft::Unit marine(BWAPI::UnitTypes::Terran_Marine,
-								   SparCraft::Position(ui.lastPosition),
-								   ui.unitID,
-								   getSparCraftPlayerID(ui.player),
-								   static_cast<int>(BWAPI::UnitTypes::Terran_Marine.maxHitPoints() * hpRatio),
-								   0,
-								   BWAPI::Broodwar->getFrameCount(),
-								   BWAPI::Broodwar->getFrameCount());
-
-			for (size_t i(0); i < 5; ++i)
-			{
-				s.addUnit(marine);
-			}
-
-			continue;
-		}
-
-		if (!ui.type.isFlyer() && SparCraft::System::isSupportedUnitType(ui.type) && ui.completed)
-		{
-			try
-			{
-				s.addUnit(getSparCraftUnit(ui));
-			}
-			catch (int e)
-			{
-				BWAPI::Broodwar->printf("Problem Adding Enemy Unit with ID: %d %d", ui.unitID, e);
-			}
-		}
+		CombatSnapshotUnit snapshotUnit;
+		snapshotUnit.type = ui.type;
+		snapshotUnit.player = getSparCraftPlayerID(ui.player);
+		snapshotUnit.unitID = ui.unitID;
+		snapshotUnit.x = ui.lastPosition.x;
+		snapshotUnit.y = ui.lastPosition.y;
+		snapshotUnit.hp = ui.lastHealth;
+		snapshotUnit.completed = ui.completed;
+		snapshot.addUnit(snapshotUnit);
 	}
 
-	s.finishedMoving();
-
-	m_state = s;
-}
-
-// Gets a SparCraft unit from a BWAPI::Unit, used for our own units since we have all their info
-const SparCraft::Unit CombatSimulation::getSparCraftUnit(BWAPI::Unit unit) const
-{
-	return SparCraft::Unit(unit->getType(),
-						   SparCraft::Position(unit->getPosition()),
-						   unit->getID(),
-						   getSparCraftPlayerID(unit->getPlayer()),
-						   unit->getHitPoints() + unit->getShields(),
-						   0,
-						   BWAPI::Broodwar->getFrameCount(),
-						   BWAPI::Broodwar->getFrameCount());
-}
-
-// Gets a SparCraft unit from a UnitInfo struct, needed to get units of enemy behind FoW
-const SparCraft::Unit CombatSimulation::getSparCraftUnit(const UnitInfo &ui) const
-{
-	BWAPI::UnitType type = ui.type;
-
-	// this is a hack, treat medics as a marine for now
-	if (type == BWAPI::UnitTypes::Terran_Medic)
+	// the recorded snapshots can be replayed offline by the combat simulation benchmark
+	if (Config::Debug::RecordCombatSnapshots)
 	{
-		type = BWAPI::UnitTypes::Terran_Marine;
+		snapshot.appendToFile(Config::Strategy::WriteDir + "UAlbertaBot_CombatSnapshots.txt");
 	}
 
-	return SparCraft::Unit(ui.type,
-						   SparCraft::Position(ui.lastPosition),
-						   ui.unitID,
-						   getSparCraftPlayerID(ui.player),
-						   ui.lastHealth,
-						   0,
-						   BWAPI::Broodwar->getFrameCount(),
-						   BWAPI::Broodwar->getFrameCount());
+	m_state = snapshot.getSparCraftState(BWAPI::Broodwar->getFrameCount());
 }
 
 SparCraft::ScoreType CombatSimulation::simulateCombat()
 {
 	PROFILE_FUNCTION();
 
-	try
+	// lopsided fights are decided by the closed form estimate, only close ones are played out
+	if (Config::Micro::CombatEstimatorBand > 0)
 	{
-		SparCraft::GameState s1(m_state);
-
-		SparCraft::PlayerPtr selfNOK(new SparCraft::Player_NOKDPS(getSparCraftPlayerID(BWAPI::Broodwar->self())));
+		const CombatEstimator estimator(CombatEstimator::DefaultExponent, Config::Micro::CombatEstimatorBand / 100.0);
+		const CombatEstimate estimate = estimator.estimate(m_state);
 
-		SparCraft::PlayerPtr enemyNOK(new SparCraft::Player_NOKDPS(getSparCraftPlayerID(BWAPI::Broodwar->enemy())));
+		if (estimate.confident)
+		{
+			if (Config::Debug::DrawCombatSimulationInfo)
+			{
+				BWAPI::Broodwar->drawTextScreen(240, 280, "Combat Estimate : %d (%.0lf vs %.0lf)", estimate.score,
+												estimate.strength[SparCraft::Players::Player_One], estimate.strength[SparCraft::Players::Player_Two]);
+			}
 
-		SparCraft::Game g(s1, selfNOK, enemyNOK, 2000);
+			return estimate.score;
+		}
+	}
 
-		g.play();
+	try
+	{
+		SparCraft::GameState s1(m_state);
+		SparCraft::GameState finalState;
 
-		SparCraft::ScoreType eval = g.getState().eval(SparCraft::Players::Player_One, SparCraft::EvaluationMethods::LTD2).val();
+		SparCraft::ScoreType eval = CombatSnapshot::PlayOut(s1, finalState);
 
 		if (Config::Debug::DrawCombatSimulationInfo)
 		{
@@ -152,7 +102,7 @@ SparCraft::ScoreType CombatSimulation::simulateCombat()
 			std::stringstream ss2;
 
 			ss2 << "Predicted Outcome: " << eval << "\n";
-			ss2 << g.getState().toStringCompact() << "\n";
+			ss2 << finalState.toStringCompact() << "\n";
 
 			BWAPI::Broodwar->drawTextScreen(150, 200, "%s", ss1.str().c_str());
 			BWAPI::Broodwar->drawTextScreen(300, 200, "%s", ss2.str().c_str());
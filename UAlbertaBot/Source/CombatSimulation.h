@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Common.h"
+#include "CombatSnapshot.h"
+#include "CombatEstimator.h"
 
 #ifdef USING_VISUALIZATION_LIBRARIES
 #include "Visualizer.h"
@@ -13,7 +15,6 @@
 
 namespace UAlbertaBot
 {
-	struct UnitInfo;
 	class CombatSimulation
 	{
 		SparCraft::GameState m_state;
@@ -24,8 +25,6 @@ namespace UAlbertaBot
 		void setCombatUnits(const BWAPI::Position &center, const int radius);
 
 		SparCraft::ScoreType simulateCombat();
-		const SparCraft::Unit getSparCraftUnit(const UnitInfo &ui) const;
-		const SparCraft::Unit getSparCraftUnit(BWAPI::Unit unit) const;
 		const SparCraft::GameState &getSparCraftState() const;
 		const size_t getSparCraftPlayerID(BWAPI::Player player) const;
 	};
@@ -0,0 +1,213 @@
+#include "CombatSnapshot.h"
+#include "..\..\SparCraft\source\Game.h"
+#include "..\..\SparCraft\source\AllPlayers.h"
+
+#include <fstream>
+
+using namespace UAlbertaBot;
+
+// bunker contents can't be seen, so an enemy bunker is simulated as this many marines
+const size_t MarinesPerBunker = 5;
+
+// upper bound on the number of moves in a simulated combat
+const int PlayOutMoveLimit = 2000;
+
+CombatSnapshot::CombatSnapshot()
+{
+}
+
+void CombatSnapshot::addUnit(const CombatSnapshotUnit &unit)
+{
+	m_units.push_back(unit);
+}
+
+void CombatSnapshot::clear()
+{
+	m_units.clear();
+}
+
+bool CombatSnapshot::empty() const
+{
+	return m_units.empty();
+}
+
+const std::vector<CombatSnapshotUnit> &CombatSnapshot::getUnits() const
+{
+	return m_units;
+}
+
+SparCraft::GameState CombatSnapshot::getSparCraftState(int frame) const
+{
+	SparCraft::GameState state;
+
+	for (auto &unit : m_units)
+	{
+		BWAPI::UnitType type = unit.type;
+
+		if (type.isWorker())
+		{
+			continue;
+		}
+
+		// enemy units are last known information, so leave out the ones we can't simulate reliably
+		if (unit.player == SparCraft::Players::Player_Two)
+		{
+			if (type == BWAPI::UnitTypes::Terran_Bunker)
+			{
+				const double hpRatio = static_cast<double>(unit.hp) / type.maxHitPoints();
+				const SparCraft::Unit marine(BWAPI::UnitTypes::Terran_Marine,
+											 SparCraft::Position(unit.x, unit.y),
+											 unit.unitID,
+											 unit.player,
+											 static_cast<int>(BWAPI::UnitTypes::Terran_Marine.maxHitPoints() * hpRatio),
+											 0,
+											 frame,
+											 frame);
+
+				for (size_t i(0); i < MarinesPerBunker; ++i)
+				{
+					state.addUnit(marine);
+				}
+
+				continue;
+			}
+
+			if (type.isFlyer() || !unit.completed)
+			{
+				continue;
+			}
+		}
+
+		if (!SparCraft::System::isSupportedUnitType(type))
+		{
+			continue;
+		}
+
+		// this is a hack, treat medics as a marine for now
+		if (type == BWAPI::UnitTypes::Terran_Medic)
+		{
+			type = BWAPI::UnitTypes::Terran_Marine;
+		}
+
+		try
+		{
+			state.addUnit(SparCraft::Unit(type, SparCraft::Position(unit.x, unit.y), unit.unitID, unit.player, unit.hp, 0, frame, frame));
+		}
+		catch (int e)
+		{
+			// there is no game to print to when snapshots are replayed offline
+			if (BWAPI::BroodwarPtr)
+			{
+				BWAPI::Broodwar->printf("Problem Adding %s Unit with ID: %d %d", unit.player == SparCraft::Players::Player_One ? "Self" : "Enemy", unit.unitID, e);
+			}
+		}
+	}
+
+	state.finishedMoving();
+
+	return state;
+}
+
+SparCraft::ScoreType CombatSnapshot::PlayOut(const SparCraft::GameState &initialState, SparCraft::GameState &finalState)
+{
+	PROFILE_FUNCTION();
+
+	SparCraft::PlayerPtr selfNOK(new SparCraft::Player_NOKDPS(SparCraft::Players::Player_One));
+	SparCraft::PlayerPtr enemyNOK(new SparCraft::Player_NOKDPS(SparCraft::Players::Player_Two));
+
+	SparCraft::Game g(initialState, selfNOK, enemyNOK, PlayOutMoveLimit);
+	g.play();
+
+	finalState = g.getState();
+
+	return finalState.eval(SparCraft::Players::Player_One, SparCraft::EvaluationMethods::LTD2).val();
+}
+
+std::string CombatSnapshot::toString() const
+{
+	std::stringstream ss;
+
+	for (auto &unit : m_units)
+	{
+		std::string name = unit.type.getName();
+		std::replace(name.begin(), name.end(), ' ', '_');
+
+		ss << name << " " << unit.player << " " << unit.unitID << " " << unit.x << " " << unit.y << " " << unit.hp << " " << (unit.completed ? 1 : 0) << "\n";
+	}
+
+	return ss.str();
+}
+
+bool CombatSnapshot::appendToFile(const std::string &filename) const
+{
+	std::ofstream file(filename, std::ios::app);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file << toString() << "\n";
+	return true;
+}
+
+BWAPI::UnitType CombatSnapshot::GetUnitType(const std::string &name)
+{
+	for (const BWAPI::UnitType &type : BWAPI::UnitTypes::allUnitTypes())
+	{
+		std::string typeName = type.getName();
+		std::replace(typeName.begin(), typeName.end(), ' ', '_');
+
+		if (typeName == name)
+		{
+			return type;
+		}
+	}
+
+	return BWAPI::UnitTypes::None;
+}
+
+std::vector<CombatSnapshot> CombatSnapshot::ReadFile(const std::string &filename)
+{
+	std::vector<CombatSnapshot> snapshots;
+	std::ifstream file(filename);
+	std::string line;
+	CombatSnapshot current;
+
+	while (std::getline(file, line))
+	{
+		line = line.substr(0, line.find('#'));
+
+		std::stringstream ss(line);
+		std::string name;
+		if (!(ss >> name))
+		{
+			// blank lines end the current snapshot
+			if (!current.empty())
+			{
+				snapshots.push_back(current);
+				current.clear();
+			}
+
+			continue;
+		}
+
+		CombatSnapshotUnit unit;
+		int completed = 0;
+		unit.type = GetUnitType(name);
+		const bool valid = (ss >> unit.player >> unit.unitID >> unit.x >> unit.y >> unit.hp) && unit.type != BWAPI::UnitTypes::None;
+
+		// the completed flag is optional, units are completed unless it says otherwise
+		if (valid)
+		{
+			unit.completed = !(ss >> completed) || completed != 0;
+			current.addUnit(unit);
+		}
+	}
+
+	if (!current.empty())
+	{
+		snapshots.push_back(current);
+	}
+
+	return snapshots;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Common.h"
+
+#include "..\..\SparCraft\source\GameState.h"
+
+namespace UAlbertaBot
+{
+	struct CombatSnapshotUnit
+	{
+		BWAPI::UnitType type = BWAPI::UnitTypes::None;
+		size_t player = 0; // SparCraft player, Player_One is us
+		int unitID = 0;
+		int x = 0;
+		int y = 0;
+		int hp = 0; // hit points + shields
+		bool completed = true;
+	};
+
+	// The units that take part in one combat simulation, independent of the running game
+	// CombatSimulation builds its SparCraft state from one of these, and they can be written to a
+	// file during games and read back by the offline batch simulator (research/combatsim)
+	//
+	// File format: one unit per line, snapshots separated by blank lines, # starts a comment
+	//   UnitTypeName Player UnitID X Y HP Completed
+	class CombatSnapshot
+	{
+		std::vector<CombatSnapshotUnit> m_units;
+
+	public:
+		CombatSnapshot();
+
+		void addUnit(const CombatSnapshotUnit &unit);
+		void clear();
+		bool empty() const;
+		const std::vector<CombatSnapshotUnit> &getUnits() const;
+
+		// applies the rules for which units can be simulated and how, eg bunkers become marines
+		SparCraft::GameState getSparCraftState(int frame) const;
+
+		std::string toString() const;
+		bool appendToFile(const std::string &filename) const;
+
+		// plays NOKDPS against itself from the initial state and returns the LTD2 evaluation for Player_One
+		static SparCraft::ScoreType PlayOut(const SparCraft::GameState &initialState, SparCraft::GameState &finalState);
+
+		static BWAPI::UnitType GetUnitType(const std::string &name);
+		static std::vector<CombatSnapshot> ReadFile(const std::string &filename);
+	};
+}
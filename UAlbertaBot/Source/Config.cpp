@@ -62,6 +62,7 @@ namespace Config
 	namespace Tournament
 	{
 		int GameEndFrame = 86400;
+		int FrameTimeBudget = 40; // ms per frame the scheduler tries to stay under
 	}
 
 	namespace Debug
@@ -76,6 +77,7 @@ namespace Config
 		bool DrawModuleTimers = false;
 		bool DrawReservedBuildingTiles = false;
 		bool DrawCombatSimulationInfo = false;
+		bool RecordCombatSnapshots = false; // append every combat simulation to a file for the offline benchmark
 		bool DrawBuildingInfo = false;
 		bool DrawMouseCursorInfo = false;
 		bool DrawEnemyUnitInfo = false;
@@ -91,6 +93,10 @@ namespace Config
 		std::string ErrorLogFilename = "UAB_ErrorLog.txt";
 		bool LogAssertToErrorFile = false;
 
+		std::string ProfileMode = "Off"; // Off, All, EveryNthFrame, OverBudgetFrames
+		int ProfileEveryNthFrame = 24;
+		std::string ProfileFilename = "bwapi-data/write/UAlbertaBot_Trace.json";
+
 		BWAPI::Color ColorLineTarget = BWAPI::Colors::White;
 		BWAPI::Color ColorLineMineral = BWAPI::Colors::Cyan;
 		BWAPI::Color ColorUnitNearEnemy = BWAPI::Colors::Red;
@@ -100,6 +106,7 @@ namespace Config
 	namespace Micro
 	{
 		bool UseSparcraftSimulation = true;
+		int CombatEstimatorBand = 200; // percent, 0 always runs the SparCraft simulation
 		bool KiteWithRangedUnits = true;
 		std::set<BWAPI::UnitType> KiteLongerRangedUnits;
 		bool WorkersDefendRush = false;
@@ -114,6 +121,7 @@ namespace Config
 	{
 		int BOSSFrameLimit = 160;
 		int BOSSTimePerFrame = 30;
+		int BOSSMinTimePerFrame = 3;	// the search gets this much even when the frame has no time left
 		int WorkersPerRefinery = 3;
 		int BuildingSpacing = 1;
 		int PylonSpacing = 3;
@@ -122,5 +130,8 @@ namespace Config
 	namespace Tools
 	{
 		extern int MAP_GRID_SIZE = 320; // size of grid spacing in MapGrid
+		bool UseDistanceAtlas = true;	// load / save precomputed base distance maps per map
+		bool UseRegionGraph = true;		// answer ground distance queries through the region graph
+		bool ExactGroundDistance = true;	// refine region graph distances to the exact BFS distance, unrefined ones can be up to twice it
 	}
 }
\ No newline at end of file
@@ -53,6 +53,7 @@ namespace Config
 	namespace Tournament
 	{
 		extern int GameEndFrame;
+		extern int FrameTimeBudget;
 	}
 
 	namespace Debug
@@ -67,6 +68,7 @@ namespace Config
 		extern bool DrawModuleTimers;
 		extern bool DrawReservedBuildingTiles;
 		extern bool DrawCombatSimulationInfo;
+		extern bool RecordCombatSnapshots;
 		extern bool DrawBuildingInfo;
 		extern bool DrawMouseCursorInfo;
 		extern bool DrawEnemyUnitInfo;
@@ -82,6 +84,10 @@ namespace Config
 		extern std::string ErrorLogFilename;
 		extern bool LogAssertToErrorFile;
 
+		extern std::string ProfileMode;
+		extern int ProfileEveryNthFrame;
+		extern std::string ProfileFilename;
+
 		extern BWAPI::Color ColorLineTarget;
 		extern BWAPI::Color ColorLineMineral;
 		extern BWAPI::Color ColorUnitNearEnemy;
@@ -91,6 +97,7 @@ namespace Config
 	namespace Micro
 	{
 		extern bool UseSparcraftSimulation;
+		extern int CombatEstimatorBand;
 		extern bool KiteWithRangedUnits;
 		extern std::set<BWAPI::UnitType> KiteLongerRangedUnits;
 		extern bool WorkersDefendRush;
@@ -105,6 +112,7 @@ namespace Config
 	{
 		extern int BOSSFrameLimit;
 		extern int BOSSTimePerFrame;
+		extern int BOSSMinTimePerFrame;
 		extern int WorkersPerRefinery;
 		extern int BuildingSpacing;
 		extern int PylonSpacing;
@@ -113,5 +121,8 @@ namespace Config
 	namespace Tools
 	{
 		extern int MAP_GRID_SIZE;
+		extern bool UseDistanceAtlas;
+		extern bool UseRegionGraph;
+		extern bool ExactGroundDistance;
 	}
 }
\ No newline at end of file
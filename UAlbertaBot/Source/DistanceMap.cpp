@@ -46,6 +46,14 @@ void DistanceMap::computeDistanceMap(const BWAPI::TilePosition &startTile)
 	m_dist = Grid<int>(m_width, m_height, -1);
 	m_sortedTiles.reserve(m_width * m_height);
 
+	// if this tile's distances were precomputed we can skip the BFS entirely
+	const int atlasField = Global::Map().getDistanceAtlas().getFieldIndex(startTile.x, startTile.y);
+	if (atlasField != -1)
+	{
+		copyFromAtlas(Global::Map().getDistanceAtlas(), atlasField);
+		return;
+	}
+
 	// the fringe for the BFS we will perform to calculate distances
 	std::vector<BWAPI::TilePosition> fringe;
 	fringe.reserve(m_width * m_height);
@@ -74,6 +82,39 @@ void DistanceMap::computeDistanceMap(const BWAPI::TilePosition &startTile)
 	}
 }
 
+// Fills m_dist and m_sortedTiles from a precomputed atlas field
+// Building placement takes the first suitable tile in the sorted order, so ties have to come out
+// in the same order as the BFS above. The tiles are walked in that BFS order, but a tile is
+// expanded by looking up the atlas distance instead of testing walkability
+void DistanceMap::copyFromAtlas(const DistanceAtlas &atlas, size_t field)
+{
+	PROFILE_FUNCTION();
+
+	const uint16_t *dist = atlas.getField(field);
+
+	m_sortedTiles.push_back(m_startTile);
+	m_dist.set(m_startTile.x, m_startTile.y, 0);
+
+	for (size_t sortedIndex = 0; sortedIndex < m_sortedTiles.size(); ++sortedIndex)
+	{
+		const BWAPI::TilePosition tile = m_sortedTiles[sortedIndex];
+		const int nextDist = m_dist.get(tile.x, tile.y) + 1;
+
+		for (size_t a = 0; a < LegalActions; ++a)
+		{
+			const BWAPI::TilePosition nextTile(tile.x + actionX[a], tile.y + actionY[a]);
+
+			// an unvisited neighbour one step further from the start is exactly what the BFS would add next
+			if (nextTile.x >= 0 && nextTile.y >= 0 && nextTile.x < m_width && nextTile.y < m_height &&
+				dist[nextTile.y * m_width + nextTile.x] == nextDist && getDistance(nextTile) == -1)
+			{
+				m_dist.set(nextTile.x, nextTile.y, nextDist);
+				m_sortedTiles.push_back(nextTile);
+			}
+		}
+	}
+}
+
 void DistanceMap::draw() const
 {
 	const int tilesToDraw = 200;
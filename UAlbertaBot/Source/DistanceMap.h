@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "Grid.hpp"
+#include "stardraft/DistanceAtlas.hpp"
 
 namespace UAlbertaBot
 {
@@ -13,6 +14,8 @@ namespace UAlbertaBot
 		BWAPI::TilePosition m_startTile;
 		std::vector<BWAPI::TilePosition> m_sortedTiles;
 
+		void copyFromAtlas(const DistanceAtlas &atlas, size_t field);
+
 	public:
 		DistanceMap();
 		void computeDistanceMap(const BWAPI::TilePosition &startTile);
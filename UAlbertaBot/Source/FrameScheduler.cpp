@@ -0,0 +1,244 @@
+#include "FrameScheduler.h"
+#include "Config.h"
+
+using namespace UAlbertaBot;
+
+// jobs aren't worth resuming with less time than this
+const double MinJobTime = 1.0;
+
+// a non-essential task is never deferred more than this many times in a row
+const int MaxDeferredInARow = 4;
+
+const size_t HistogramBuckets = 100;
+
+FrameScheduler::FrameScheduler(TimerManager &timerManager, double frameBudget)
+	: m_timerManager(timerManager), m_frameBudget(frameBudget), m_frameTimeHistogram(HistogramBuckets + 1, 0)
+{
+}
+
+void FrameScheduler::setFrameBudget(double frameBudget)
+{
+	m_frameBudget = frameBudget;
+}
+
+void FrameScheduler::addTask(const std::string &name, TimerManager::Type timer, int cadence, double budget, bool essential, const Task &task)
+{
+	ScheduledTask scheduled;
+	scheduled.name = name;
+	scheduled.timer = timer;
+	scheduled.cadence = std::max(1, cadence);
+	scheduled.budget = budget;
+	scheduled.essential = essential;
+	scheduled.task = task;
+
+	m_tasks.push_back(scheduled);
+}
+
+void FrameScheduler::addJob(const std::string &name, double minTime, const Job &job)
+{
+	ScheduledJob scheduled;
+	scheduled.name = name;
+	scheduled.minTime = minTime;
+	scheduled.job = job;
+
+	m_jobs.push_back(scheduled);
+}
+
+void FrameScheduler::update()
+{
+	PROFILE_FUNCTION();
+
+	const int frame = BWAPI::Broodwar->getFrameCount();
+
+	m_timerManager.startTimer(TimerManager::All);
+
+	for (auto &task : m_tasks)
+	{
+		if (shouldRun(task, frame, m_timerManager.getTotalElapsed()))
+		{
+			runTask(task, frame);
+		}
+	}
+
+	runJobs();
+
+	m_timerManager.stopTimer(TimerManager::All);
+
+	recordFrame(m_timerManager.getTotalElapsed());
+}
+
+bool FrameScheduler::shouldRun(ScheduledTask &task, int frame, double elapsed)
+{
+	if (task.lastRunFrame >= 0 && frame - task.lastRunFrame < task.cadence)
+	{
+		return false;
+	}
+
+	if (task.essential || task.deferredInARow >= MaxDeferredInARow || elapsed + task.budget <= m_frameBudget)
+	{
+		return true;
+	}
+
+	task.deferredInARow++;
+	task.timesDeferred++;
+	return false;
+}
+
+void FrameScheduler::runTask(ScheduledTask &task, int frame)
+{
+	// the All timer is already running for the whole frame, so only start the task's own timer if it has one
+	const bool ownTimer = task.timer != TimerManager::All;
+	const double start = m_timerManager.getTotalElapsed();
+
+	if (ownTimer)
+	{
+		m_timerManager.startTimer(task.timer);
+	}
+
+	task.task();
+
+	if (ownTimer)
+	{
+		m_timerManager.stopTimer(task.timer);
+	}
+
+	const double elapsed = m_timerManager.getTotalElapsed() - start;
+
+	task.lastRunFrame = frame;
+	task.deferredInARow = 0;
+	task.timesRun++;
+	task.totalTime += elapsed;
+	task.maxTime = std::max(task.maxTime, elapsed);
+
+	if (task.budget > 0 && elapsed > task.budget)
+	{
+		task.timesOverBudget++;
+	}
+}
+
+void FrameScheduler::runJobs()
+{
+	for (size_t j(0); j < m_jobs.size();)
+	{
+		ScheduledJob &job = m_jobs[j];
+		const double start = m_timerManager.getTotalElapsed();
+		const double slack = m_frameBudget - start;
+
+		// a job without a minimum waits until a frame with some time to spare
+		if (std::max(slack, job.minTime) < MinJobTime)
+		{
+			m_jobsSkipped++;
+			++j;
+			continue;
+		}
+
+		m_timerManager.startTimer(TimerManager::Search);
+		const bool finished = job.job(std::max(slack, job.minTime));
+		m_timerManager.stopTimer(TimerManager::Search);
+
+		job.framesRun++;
+		job.framesOnMinimum += slack < job.minTime;
+		job.totalTime += m_timerManager.getTotalElapsed() - start;
+
+		if (finished)
+		{
+			m_jobs.erase(m_jobs.begin() + j);
+		}
+		else
+		{
+			++j;
+		}
+	}
+}
+
+void FrameScheduler::recordFrame(double frameTime)
+{
+	m_frames++;
+	m_totalFrameTime += frameTime;
+	m_maxFrameTime = std::max(m_maxFrameTime, frameTime);
+	m_frameTimeHistogram[std::min(HistogramBuckets, (size_t)frameTime)]++;
+
+	if (frameTime > m_frameBudget)
+	{
+		m_overrunFrames++;
+	}
+}
+
+double FrameScheduler::getFrameBudget() const
+{
+	return m_frameBudget;
+}
+
+// upper bound (to the nearest ms) of the given percentile of frame times, eg 0.99
+double FrameScheduler::getFrameTimePercentile(double percentile) const
+{
+	if (m_frames == 0)
+	{
+		return 0;
+	}
+
+	const int rank = std::max(1, (int)std::ceil(percentile * m_frames));
+	int count = 0;
+	for (size_t b(0); b < m_frameTimeHistogram.size(); ++b)
+	{
+		count += m_frameTimeHistogram[b];
+		if (count >= rank)
+		{
+			return b < HistogramBuckets ? (double)(b + 1) : m_maxFrameTime;
+		}
+	}
+
+	return m_maxFrameTime;
+}
+
+int FrameScheduler::getNumOverrunFrames() const
+{
+	return m_overrunFrames;
+}
+
+std::string FrameScheduler::getStatisticsString() const
+{
+	std::stringstream ss;
+	ss << "Frames:           " << m_frames << "\n";
+	ss << "Frame Budget:     " << m_frameBudget << " ms\n";
+	ss << "Overrun Frames:   " << m_overrunFrames << "\n";
+	ss << "Mean Frame Time:  " << (m_frames > 0 ? m_totalFrameTime / m_frames : 0) << " ms\n";
+	ss << "99th Percentile:  " << getFrameTimePercentile(0.99) << " ms\n";
+	ss << "Max Frame Time:   " << m_maxFrameTime << " ms\n";
+	ss << "Jobs Skipped:     " << m_jobsSkipped << "\n\n";
+
+	ss << "Task Runs Deferred OverBudget MeanMS MaxMS\n";
+	for (auto &task : m_tasks)
+	{
+		ss << task.name << " " << task.timesRun << " " << task.timesDeferred << " " << task.timesOverBudget << " "
+		   << (task.timesRun > 0 ? task.totalTime / task.timesRun : 0) << " " << task.maxTime << "\n";
+	}
+
+	for (auto &job : m_jobs)
+	{
+		ss << job.name << " (job) " << job.framesRun << " - - " << (job.framesRun > 0 ? job.totalTime / job.framesRun : 0) << " - "
+		   << job.framesOnMinimum << " frames on its minimum time\n";
+	}
+
+	return ss.str();
+}
+
+void FrameScheduler::drawStatistics(int x, int y) const
+{
+	if (!Config::Debug::DrawModuleTimers)
+	{
+		return;
+	}
+
+	BWAPI::Broodwar->drawTextScreen(x, y, "\x04Budget: %.0lfms  Over: %d / %d  p99: %.0lfms  Max: %.1lfms",
+									m_frameBudget, m_overrunFrames, m_frames, getFrameTimePercentile(0.99), m_maxFrameTime);
+
+	for (auto &task : m_tasks)
+	{
+		if (task.timesDeferred > 0)
+		{
+			y += 10;
+			BWAPI::Broodwar->drawTextScreen(x, y, "\x04 %s deferred %d", task.name.c_str(), task.timesDeferred);
+		}
+	}
+}
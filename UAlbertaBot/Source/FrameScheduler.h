@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Common.h"
+#include "TimerManager.h"
+#include <functional>
+
+namespace UAlbertaBot
+{
+
+	// Runs the bot's manager updates inside a per-frame time budget
+	// Tasks run once every cadence frames in the order they were added. Essential tasks always run,
+	// the others are deferred to a later frame when their budget no longer fits in the frame.
+	// Jobs are resumable pieces of work (build order search, etc) which get the time left over,
+	// but never less than their minimum time so a busy frame can't starve them
+	class FrameScheduler
+	{
+	public:
+		typedef std::function<void()> Task;
+
+		// given the time in ms it may use this frame, returns true once the job is finished
+		typedef std::function<bool(double timeLimit)> Job;
+
+	private:
+		struct ScheduledTask
+		{
+			std::string name;
+			TimerManager::Type timer = TimerManager::All;
+			int cadence = 1;
+			double budget = 0;
+			bool essential = true;
+			Task task;
+
+			int lastRunFrame = -1;
+			int deferredInARow = 0;
+			int timesRun = 0;
+			int timesDeferred = 0;
+			int timesOverBudget = 0;
+			double totalTime = 0;
+			double maxTime = 0;
+		};
+
+		struct ScheduledJob
+		{
+			std::string name;
+			Job job;
+			double minTime = 0;
+			int framesRun = 0;
+			int framesOnMinimum = 0;
+			double totalTime = 0;
+		};
+
+		TimerManager &m_timerManager;
+		double m_frameBudget = 40;
+
+		std::vector<ScheduledTask> m_tasks;
+		std::vector<ScheduledJob> m_jobs;
+
+		int m_frames = 0;
+		int m_overrunFrames = 0;
+		int m_jobsSkipped = 0;
+		double m_maxFrameTime = 0;
+		double m_totalFrameTime = 0;
+		std::vector<int> m_frameTimeHistogram; // 1ms buckets, the last one holds everything longer
+
+		bool shouldRun(ScheduledTask &task, int frame, double elapsed);
+		void runTask(ScheduledTask &task, int frame);
+		void runJobs();
+		void recordFrame(double frameTime);
+
+	public:
+		FrameScheduler(TimerManager &timerManager, double frameBudget);
+
+		void setFrameBudget(double frameBudget);
+		void addTask(const std::string &name, TimerManager::Type timer, int cadence, double budget, bool essential, const Task &task);
+		void addJob(const std::string &name, double minTime, const Job &job);
+
+		// runs the tasks that are due this frame and then the jobs, timing the whole frame with the All timer
+		void update();
+
+		double getFrameBudget() const;
+		double getFrameTimePercentile(double percentile) const;
+		int getNumOverrunFrames() const;
+
+		std::string getStatisticsString() const;
+		void drawStatistics(int x, int y) const;
+	};
+
+}
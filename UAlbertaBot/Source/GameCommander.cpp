@@ -13,57 +13,68 @@
 #include "ScoutManager.h"
 #include "StrategyManager.h"
 #include "Squad.h"
+#include "Logger.h"
+
+#ifdef USING_COMBAT_PREDICTOR
+#include "CombatPredictor.h"
+#endif
 
 using namespace UAlbertaBot;
 
 GameCommander::GameCommander()
-	: m_initialScoutSet(false)
-{
-}
-
-void GameCommander::update()
+	: m_scheduler(m_timerManager, Config::Tournament::FrameTimeBudget), m_initialScoutSet(false)
 {
-	PROFILE_FUNCTION();
-
-	m_timerManager.startTimer(TimerManager::All);
-
+	// tasks run in this order every frame, the essential ones are never deferred
 	// populate the unit vectors we will pass into various managers
-	handleUnitAssignments();
+	m_scheduler.addTask("Assignment", TimerManager::All, 1, 1, true, [this]() { handleUnitAssignments(); });
 
 	// utility managers
-	m_timerManager.startTimer(TimerManager::InformationManager);
-	Global::Info().update();
-	m_timerManager.stopTimer(TimerManager::InformationManager);
-
-	m_timerManager.startTimer(TimerManager::MapTools);
-	Global::Map().onFrame();
-	m_timerManager.stopTimer(TimerManager::MapTools);
+	m_scheduler.addTask("UnitInfo", TimerManager::InformationManager, 1, 2, true, []() { Global::Info().update(); });
+	m_scheduler.addTask("MapTools", TimerManager::MapTools, 1, 2, false, []() { Global::Map().onFrame(); });
 
 	// economy and base managers
-	m_timerManager.startTimer(TimerManager::Worker);
-	Global::Workers().onFrame();
-	m_timerManager.stopTimer(TimerManager::Worker);
-
-	m_timerManager.startTimer(TimerManager::Production);
-	Global::Production().update();
-	m_timerManager.stopTimer(TimerManager::Production);
+	m_scheduler.addTask("Worker", TimerManager::Worker, 1, 2, true, []() { Global::Workers().onFrame(); });
+	m_scheduler.addTask("Production", TimerManager::Production, 1, 5, true, []() { Global::Production().update(); });
 
 	// combat and scouting managers
-	m_timerManager.startTimer(TimerManager::Combat);
-	m_combatCommander.update(m_combatUnits);
-	m_timerManager.stopTimer(TimerManager::Combat);
+	m_scheduler.addTask("Combat", TimerManager::Combat, 1, 10, true, [this]() { m_combatCommander.update(m_combatUnits); });
+	m_scheduler.addTask("Scout", TimerManager::Scout, 1, 2, false, []() { Global::Scout().update(); });
+
+	// the build order search uses whatever time is left in the frame, but runs after production
+	// and combat so it gets a minimum slice every frame or it could starve in long fights.
+	// combat simulation, building placement and distance maps are not jobs: their callers need
+	// the answer in the same frame, and each distance map is only built once and then cached
+	m_scheduler.addJob("BuildOrderSearch", Config::Macro::BOSSMinTimePerFrame, [](double timeLimit)
+	{
+		Global::Production().updateBuildOrderSearch(timeLimit);
+		return false;
+	});
+}
 
-	m_timerManager.startTimer(TimerManager::Scout);
-	Global::Scout().update();
-	m_timerManager.stopTimer(TimerManager::Scout);
+void GameCommander::update()
+{
+	PROFILE_FUNCTION();
 
-	m_timerManager.stopTimer(TimerManager::All);
+	// the config file is parsed after the commander is constructed
+	m_scheduler.setFrameBudget(Config::Tournament::FrameTimeBudget);
+	m_scheduler.update();
 
 	Global::Bases().onFrame();
 
 	drawDebugInterface();
 }
 
+void GameCommander::onEnd()
+{
+	Logger::LogOverwriteToFile(Config::Strategy::WriteDir + "UAlbertaBot_FrameStats.txt", m_scheduler.getStatisticsString());
+
+#ifdef USING_COMBAT_PREDICTOR
+	// the battle dataset's writer thread has to be joined here, not in the singleton's destructor
+	// which runs while the DLL is unloaded under the loader lock and can deadlock
+	CombatPredictor::Instance().onEnd();
+#endif
+}
+
 void GameCommander::drawDebugInterface()
 {
 	Global::Info().drawExtendedInterface();
@@ -74,6 +85,7 @@ void GameCommander::drawDebugInterface()
 
 	m_combatCommander.drawSquadInformation(200, 30);
 	m_timerManager.displayTimers(490, 225);
+	m_scheduler.drawStatistics(490, 335);
 	drawGameInformation(4, 1);
 
 	// draw position of mouse cursor
@@ -206,6 +218,7 @@ void GameCommander::onUnitShow(BWAPI::Unit unit)
 {
 	Global::Info().onUnitShow(unit);
 	Global::Workers().onUnitShow(unit);
+	Global::Map().updateBlockingUnit(unit);
 }
 
 void GameCommander::onUnitHide(BWAPI::Unit unit)
@@ -216,6 +229,7 @@ void GameCommander::onUnitHide(BWAPI::Unit unit)
 void GameCommander::onUnitCreate(BWAPI::Unit unit)
 {
 	Global::Info().onUnitCreate(unit);
+	Global::Map().updateBlockingUnit(unit);
 }
 
 void GameCommander::onUnitComplete(BWAPI::Unit unit)
@@ -233,12 +247,14 @@ void GameCommander::onUnitDestroy(BWAPI::Unit unit)
 	Global::Production().onUnitDestroy(unit);
 	Global::Workers().onUnitDestroy(unit);
 	Global::Info().onUnitDestroy(unit);
+	Global::Map().removeBlockingUnit(unit);
 }
 
 void GameCommander::onUnitMorph(BWAPI::Unit unit)
 {
 	Global::Info().onUnitMorph(unit);
 	Global::Workers().onUnitMorph(unit);
+	Global::Map().updateBlockingUnit(unit);
 }
 
 BWAPI::Unit GameCommander::getClosestUnitToTarget(BWAPI::UnitType type, BWAPI::Position target)
@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "CombatCommander.h"
 #include "TimerManager.h"
+#include "FrameScheduler.h"
 
 namespace UAlbertaBot
 {
@@ -23,6 +24,7 @@ namespace UAlbertaBot
 	{
 		CombatCommander m_combatCommander;
 		TimerManager m_timerManager;
+		FrameScheduler m_scheduler;
 
 		BWAPI::Unitset m_validUnits;
 		BWAPI::Unitset m_combatUnits;
@@ -37,6 +39,7 @@ namespace UAlbertaBot
 		GameCommander();
 
 		void update();
+		void onEnd();
 
 		void handleUnitAssignments();
 		void setValidUnits();
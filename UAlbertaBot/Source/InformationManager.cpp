@@ -330,13 +330,37 @@ bool InformationManager::isCombatUnit(BWAPI::UnitType type) const
 	return false;
 }
 
+// the furthest outside of a getNearbyForce radius that a unit can be and still be included
+static int MaxNearbyForceReach()
+{
+	static int maxReach = 0;
+
+	if (maxReach == 0)
+	{
+		maxReach = 250;
+		for (auto &type : BWAPI::UnitTypes::allUnitTypes())
+		{
+			maxReach = std::max(maxReach, type.groundWeapon().maxRange() + 40);
+		}
+	}
+
+	return maxReach;
+}
+
 void InformationManager::getNearbyForce(std::vector<UnitInfo> &unitInfo, BWAPI::Position p, BWAPI::Player player, int radius)
 {
-	bool hasBunker = false;
+	const UnitData &unitData = getUnitData(player);
+
+	// only units within the largest possible reach of the radius need to be checked
+	// sorted so the units come out in the same order as iterating the unit map
+	std::vector<BWAPI::Unit> nearbyUnits;
+	unitData.getSpatialGrid().getInRadius(p.x, p.y, radius + MaxNearbyForceReach(), nearbyUnits);
+	std::sort(nearbyUnits.begin(), nearbyUnits.end());
+
 	// for each unit we know about for that player
-	for (const auto &kv : getUnitData(player).getUnits())
+	for (auto &unit : nearbyUnits)
 	{
-		const UnitInfo &ui(kv.second);
+		const UnitInfo &ui(unitData.getUnits().at(unit));
 
 		// if it's a combat unit we care about
 		// and it's finished!
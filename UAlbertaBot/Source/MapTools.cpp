@@ -1,6 +1,8 @@
 #include "MapTools.h"
 #include "BaseLocationManager.h"
+#include "InformationManager.h"
 #include "Global.h"
+#include "stardraft/StarDraftMapFile.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -9,10 +11,6 @@
 
 using namespace UAlbertaBot;
 
-const size_t LegalActions = 4;
-const int actionX[LegalActions] = {1, -1, 0, 0};
-const int actionY[LegalActions] = {0, 0, 1, -1};
-
 // constructor for MapTools
 MapTools::MapTools()
 {
@@ -29,7 +27,7 @@ void MapTools::onStart()
 	m_buildable = Grid<int>(m_width, m_height, 0);
 	m_depotBuildable = Grid<int>(m_width, m_height, 0);
 	m_lastSeen = Grid<int>(m_width, m_height, 0);
-	m_sectorNumber = Grid<int>(m_width, m_height, 0);
+	m_blockers = Grid<int>(m_width, m_height, 0);
 
 	// Set the boolean grid data from the Map
 	for (int x(0); x < m_width; ++x)
@@ -79,6 +77,24 @@ void MapTools::onStart()
 	// compute the map connectivity
 	computeConnectivity();
 	computeMap();
+
+	// the distance atlas is only valid for the walkable grid it was computed on, which load() checks
+	std::vector<char> walkable(m_width * m_height, 0);
+	for (int x(0); x < m_width; ++x)
+	{
+		for (int y(0); y < m_height; ++y)
+		{
+			walkable[y * m_width + x] = isWalkable(x, y);
+		}
+	}
+
+	m_distanceAtlas.reset(m_width, m_height, walkable);
+	m_regionGraph.reset(m_width, m_height, walkable);
+
+	if (Config::Tools::UseDistanceAtlas)
+	{
+		m_distanceAtlas.load(Config::Strategy::ReadDir + getDistanceAtlasFileName());
+	}
 }
 
 void MapTools::onFrame()
@@ -96,6 +112,15 @@ void MapTools::onFrame()
 		}
 	}
 
+	// terran buildings lift off and land without an event
+	for (auto &unit : BWAPI::Broodwar->getAllUnits())
+	{
+		if (unit->getType().isFlyingBuilding())
+		{
+			updateBlockingUnit(unit);
+		}
+	}
+
 	m_frame++;
 	draw();
 }
@@ -170,50 +195,103 @@ void MapTools::computeConnectivity()
 {
 	PROFILE_FUNCTION();
 
-	// the fringe data structe we will use to do our BFS searches
-	std::vector<std::array<int, 2>> fringe;
-	fringe.reserve(m_width * m_height);
-	int sectorNumber = 0;
+	// static resources and neutral buildings block the tiles they stand on until they are destroyed
+	for (auto &unit : BWAPI::Broodwar->getStaticNeutralUnits())
+	{
+		const BWAPI::UnitType type = unit->getType();
+		if (!type.isBuilding() && !type.isResourceContainer())
+		{
+			continue;
+		}
+
+		const BWAPI::TilePosition size(type.tileWidth(), type.tileHeight());
+		m_blockingUnits[unit] = std::make_pair(unit->getTilePosition(), size);
 
-	// for every tile on the map, do a connected flood fill using BFS
+		for (int x = 0; x < size.x; ++x)
+		{
+			for (int y = 0; y < size.y; ++y)
+			{
+				const BWAPI::TilePosition tile = unit->getTilePosition() + BWAPI::TilePosition(x, y);
+				if (isValidTile(tile))
+				{
+					m_blockers.set(tile.x, tile.y, m_blockers.get(tile.x, tile.y) + 1);
+				}
+			}
+		}
+	}
+
+	std::vector<char> walkable(m_width * m_height, 0);
 	for (int x = 0; x < m_width; ++x)
 	{
 		for (int y = 0; y < m_height; ++y)
 		{
-			// if the sector is not currently 0, or the map isn't walkable here, then we can skip this tile
-			if (getSectorNumber(x, y) != 0 || !isWalkable(x, y))
+			walkable[y * m_width + x] = isWalkable(x, y) && m_blockers.get(x, y) == 0;
+		}
+	}
+
+	m_sectors.reset(m_width, m_height, walkable);
+}
+
+void MapTools::setBlocked(const BWAPI::TilePosition &topLeft, const BWAPI::TilePosition &size, bool blocked)
+{
+	// only the tiles going from no blockers to one or back change walkability, the rest are updated together
+	std::vector<std::array<int, 2>> changed;
+
+	for (int x = topLeft.x; x < topLeft.x + size.x; ++x)
+	{
+		for (int y = topLeft.y; y < topLeft.y + size.y; ++y)
+		{
+			if (!isValidTile(x, y))
 			{
 				continue;
 			}
 
-			// increase the sector number, so that walkable tiles have sectors 1-N
-			sectorNumber++;
+			const int blockers = std::max(0, m_blockers.get(x, y) + (blocked ? 1 : -1));
+			if ((blockers == 0) != (m_blockers.get(x, y) == 0) && isWalkable(x, y))
+			{
+				changed.push_back({ x, y });
+			}
 
-			// reset the fringe for the search and add the start tile to it
-			fringe.clear();
-			fringe.push_back({x, y});
-			m_sectorNumber.set(x, y, sectorNumber);
+			m_blockers.set(x, y, blockers);
+		}
+	}
 
-			// do the BFS, stopping when we reach the last element of the fringe
-			for (size_t fringeIndex = 0; fringeIndex < fringe.size(); ++fringeIndex)
-			{
-				auto &tile = fringe[fringeIndex];
+	m_sectors.setWalkable(changed, !blocked);
+}
 
-				// check every possible child of this tile
-				for (size_t a = 0; a < LegalActions; ++a)
-				{
-					const int nextX = tile[0] + actionX[a];
-					const int nextY = tile[1] + actionY[a];
+void MapTools::updateBlockingUnit(BWAPI::Unit unit)
+{
+	const BWAPI::UnitType type = unit->getType();
+	const bool blocks = (type.isBuilding() || type.isResourceContainer()) && !unit->isFlying();
+	const BWAPI::TilePosition size(type.tileWidth(), type.tileHeight());
 
-					// if the new tile is inside the map bounds, is walkable, and has not been assigned a sector, add it to the current sector and the fringe
-					if (isValidTile(nextX, nextY) && isWalkable(nextX, nextY) && (getSectorNumber(nextX, nextY) == 0))
-					{
-						m_sectorNumber.set(nextX, nextY, sectorNumber);
-						fringe.push_back({nextX, nextY});
-					}
-				}
-			}
+	auto blocking = m_blockingUnits.find(unit);
+	if (blocking != m_blockingUnits.end())
+	{
+		if (blocks && blocking->second.first == unit->getTilePosition() && blocking->second.second == size)
+		{
+			return;
 		}
+
+		// lifted off, landed somewhere else or morphed
+		setBlocked(blocking->second.first, blocking->second.second, false);
+		m_blockingUnits.erase(blocking);
+	}
+
+	if (blocks)
+	{
+		m_blockingUnits[unit] = std::make_pair(unit->getTilePosition(), size);
+		setBlocked(unit->getTilePosition(), size, true);
+	}
+}
+
+void MapTools::removeBlockingUnit(BWAPI::Unit unit)
+{
+	auto blocking = m_blockingUnits.find(unit);
+	if (blocking != m_blockingUnits.end())
+	{
+		setBlocked(blocking->second.first, blocking->second.second, false);
+		m_blockingUnits.erase(blocking);
 	}
 }
 
@@ -254,6 +332,34 @@ bool MapTools::isPowered(int tileX, int tileY) const
 
 int MapTools::getGroundDistance(const BWAPI::Position &src, const BWAPI::Position &dest) const
 {
+	PROFILE_FUNCTION();
+
+	const BWAPI::TilePosition srcTile(src);
+	const BWAPI::TilePosition destTile(dest);
+
+	// a distance map we already have is exact and costs nothing, otherwise ask the region graph
+	// rather than BFSing the whole map for a destination we may never query again. A destination
+	// asked about over and over, like a squad's target by each of its units every frame, is worth
+	// the BFS after a few queries (a BFS costs about as much as 4 to 8 graph queries)
+	const std::pair<int, int> destPair(destTile.x, destTile.y);
+	const bool cached = m_allMaps.find(destPair) != m_allMaps.end();
+	if (Config::Tools::UseRegionGraph && !cached && isWalkable(srcTile) && isWalkable(destTile))
+	{
+		if (m_graphQueries.size() > 1000)
+		{
+			m_graphQueries.clear();
+		}
+
+		if (++m_graphQueries[destPair] <= GraphQueriesPerDestination)
+		{
+			return Config::Tools::ExactGroundDistance
+				? m_regionGraph.getExactDistance(srcTile.x, srcTile.y, destTile.x, destTile.y)
+				: m_regionGraph.getDistance(srcTile.x, srcTile.y, destTile.x, destTile.y);
+		}
+
+		m_graphQueries.erase(destPair);
+	}
+
 	if (m_allMaps.size() > 50)
 	{
 		m_allMaps.clear();
@@ -280,14 +386,45 @@ const DistanceMap &MapTools::getDistanceMap(const BWAPI::TilePosition &tile) con
 	return m_allMaps[pairTile];
 }
 
-int MapTools::getSectorNumber(int x, int y) const
+const DistanceAtlas &MapTools::getDistanceAtlas() const
 {
-	if (!isValidTile(x, y))
+	return m_distanceAtlas;
+}
+
+// computes the distance fields of all the given tiles which aren't already in the atlas, in parallel
+// any later DistanceMap computed from one of these tiles is then copied from the atlas instead of BFSing
+void MapTools::precomputeDistanceMaps(const std::vector<BWAPI::TilePosition> &tiles)
+{
+	PROFILE_FUNCTION();
+
+	std::vector<Tile> sources;
+	for (auto &tile : tiles)
 	{
-		return 0;
+		if (isValidTile(tile))
+		{
+			sources.push_back({tile.x, tile.y});
+		}
 	}
 
-	return m_sectorNumber.get(x, y);
+	m_distanceAtlas.computeFields(sources);
+}
+
+void MapTools::saveDistanceAtlas()
+{
+	if (Config::Tools::UseDistanceAtlas && m_distanceAtlas.isModified())
+	{
+		m_distanceAtlas.save(Config::Strategy::WriteDir + getDistanceAtlasFileName());
+	}
+}
+
+std::string MapTools::getDistanceAtlasFileName() const
+{
+	return BWAPI::Broodwar->mapHash() + ".atlas";
+}
+
+int MapTools::getSectorNumber(int x, int y) const
+{
+	return m_sectors.getSector(x, y);
 }
 
 bool MapTools::isValidTile(int tileX, int tileY) const
@@ -510,42 +647,32 @@ void MapTools::draw() const
 	}
 }
 
+// the unit positions come from the InformationManager spatial grid, which is updated at the start of every frame
 void MapTools::getUnits(BWAPI::Unitset &units, BWAPI::Position center, int radius, bool ourUnits, bool oppUnits)
 {
-	const int radiusSq(radius * radius);
+	std::vector<BWAPI::Unit> nearbyUnits;
 
 	if (ourUnits)
 	{
-		for (auto &unit : BWAPI::Broodwar->self()->getUnits())
-		{
-			BWAPI::Position d(unit->getPosition() - center);
-			if (d.x * d.x + d.y * d.y <= radiusSq)
-			{
-				if (!units.contains(unit))
-				{
-					units.insert(unit);
-				}
-			}
-		}
+		Global::Info().getUnitData(BWAPI::Broodwar->self()).getSpatialGrid().getInRadius(center.x, center.y, radius, nearbyUnits);
 	}
 
 	if (oppUnits)
 	{
-		for (auto &unit : BWAPI::Broodwar->enemy()->getUnits())
+		Global::Info().getUnitData(BWAPI::Broodwar->enemy()).getSpatialGrid().getInRadius(center.x, center.y, radius, nearbyUnits);
+	}
+
+	for (auto &unit : nearbyUnits)
+	{
+		// enemy units are only included while they are visible, we don't want last known positions here
+		if (unit->getPlayer() == BWAPI::Broodwar->enemy() && (unit->getType() == BWAPI::UnitTypes::Unknown || !unit->isVisible()))
 		{
-			if (unit->getType() == BWAPI::UnitTypes::Unknown || !unit->isVisible())
-			{
-				continue;
-			}
+			continue;
+		}
 
-			BWAPI::Position d(unit->getPosition() - center);
-			if (d.x * d.x + d.y * d.y <= radiusSq)
-			{
-				if (!units.contains(unit))
-				{
-					units.insert(unit);
-				}
-			}
+		if (!units.contains(unit))
+		{
+			units.insert(unit);
 		}
 	}
 }
@@ -561,4 +688,7 @@ void MapTools::saveMapToFile(const std::string &path) const
 	std::string mapFile = BWAPI::Broodwar->mapFileName();
 	std::replace(mapFile.begin(), mapFile.end(), ' ', '_');
 	getStarDraftMap().save(mapFile + ".txt");
+
+	// the binary version is what the offline tools map in
+	StarDraftMapFile::Write(getStarDraftMap(), mapFile + ".sdm");
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <vector>
 #include "DistanceMap.h"
 #include "Grid.hpp"
+#include "SectorMap.h"
 
 #include "stardraft/StarDraft.h"
 
@@ -13,6 +14,10 @@ namespace UAlbertaBot
 	{
 		friend class Global;
 
+		// region graph queries a destination gets before it is given a distance map,
+		// a full BFS costs about 3.5 exact queries (RegionGraphBenchmark)
+		static const int GraphQueriesPerDestination = 3;
+
 		StarDraftMap m_map;
 
 		int m_width = 0;
@@ -22,17 +27,36 @@ namespace UAlbertaBot
 		// a cache of already computed distance maps, which is mutable since it only acts as a cache
 		mutable std::map<std::pair<int, int>, DistanceMap> m_allMaps;
 
+		// how many region graph queries each destination without a distance map has had, a destination
+		// asked about often enough gets a distance map of its own
+		mutable std::map<std::pair<int, int>, int> m_graphQueries;
+
+		// precomputed distance fields from base locations, saved per map so later games load them instead of BFSing
+		DistanceAtlas m_distanceAtlas;
+
+		// region and choke graph over the walkable tiles, answers ground distances without a BFS per destination
+		RegionGraph m_regionGraph;
+
 		Grid<int> m_walkable;		// whether a tile is buildable (includes static resources)
 		Grid<int> m_buildable;		// whether a tile is buildable (includes static resources)
 		Grid<int> m_depotBuildable; // whether a depot is buildable on a tile (illegal within 3 tiles of static resource)
 		Grid<int> m_lastSeen;		// the last time any of our units has seen this position on the map
-		Grid<int> m_sectorNumber;	// connectivity sector number, two tiles are ground connected if they have the same number
+		Grid<int> m_blockers;		// how many buildings and resources stand on a tile
+
+		// connectivity sectors, two tiles are ground connected if they have the same number. tiles under
+		// buildings and resources aren't walkable here, so the sectors change as they come and go
+		SectorMap m_sectors;
+
+		// the top left tile and size in tiles of every building and resource blocking tiles
+		std::map<BWAPI::Unit, std::pair<BWAPI::TilePosition, BWAPI::TilePosition>> m_blockingUnits;
 
 		void computeMap();
 
 		void computeConnectivity();
+		void setBlocked(const BWAPI::TilePosition &topLeft, const BWAPI::TilePosition &size, bool blocked);
 		int getSectorNumber(int x, int y) const;
 		void printMap() const;
+		std::string getDistanceAtlasFileName() const;
 		bool canBuild(int tileX, int tileY) const;
 		bool canWalk(int tileX, int tileY) const;
 
@@ -43,6 +67,11 @@ namespace UAlbertaBot
 		void onFrame();
 		void draw() const;
 
+		// keeps the connectivity sectors up to date as buildings are placed, lift off, land or die
+		// and as resources are mined out
+		void updateBlockingUnit(BWAPI::Unit unit);
+		void removeBlockingUnit(BWAPI::Unit unit);
+
 		int width() const;
 		int height() const;
 
@@ -59,6 +88,9 @@ namespace UAlbertaBot
 
 		const DistanceMap &getDistanceMap(const BWAPI::TilePosition &tile) const;
 		const DistanceMap &getDistanceMap(const BWAPI::Position &tile) const;
+		const DistanceAtlas &getDistanceAtlas() const;
+		void precomputeDistanceMaps(const std::vector<BWAPI::TilePosition> &tiles);
+		void saveDistanceAtlas();
 		int getGroundDistance(const BWAPI::Position &src, const BWAPI::Position &dest) const;
 		bool isConnected(int x1, int y1, int x2, int y2) const;
 		bool isConnected(const BWAPI::TilePosition &from, const BWAPI::TilePosition &to) const;
@@ -49,11 +49,19 @@ void ParseUtils::ParseConfigFile(const std::string &filename)
 		JSONTools::ReadBool("CompleteMapInformation", bwapi, Config::BWAPIOptions::EnableCompleteMapInformation);
 	}
 
+	// Parse the Tournament Options
+	if (doc.HasMember("Tournament") && doc["Tournament"].IsObject())
+	{
+		const rapidjson::Value &tournament = doc["Tournament"];
+		JSONTools::ReadInt("FrameTimeBudget", tournament, Config::Tournament::FrameTimeBudget);
+	}
+
 	// Parse the Micro Options
 	if (doc.HasMember("Micro") && doc["Micro"].IsObject())
 	{
 		const rapidjson::Value &micro = doc["Micro"];
 		JSONTools::ReadBool("UseSparcraftSimulation", micro, Config::Micro::UseSparcraftSimulation);
+		JSONTools::ReadInt("CombatEstimatorBand", micro, Config::Micro::CombatEstimatorBand);
 		JSONTools::ReadBool("KiteWithRangedUnits", micro, Config::Micro::KiteWithRangedUnits);
 		JSONTools::ReadBool("WorkersDefendRush", micro, Config::Micro::WorkersDefendRush);
 		JSONTools::ReadInt("RetreatMeleeUnitShields", micro, Config::Micro::RetreatMeleeUnitShields);
@@ -93,6 +101,9 @@ void ParseUtils::ParseConfigFile(const std::string &filename)
 		const rapidjson::Value &debug = doc["Debug"];
 		JSONTools::ReadString("ErrorLogFilename", debug, Config::Debug::ErrorLogFilename);
 		JSONTools::ReadBool("LogAssertToErrorFile", debug, Config::Debug::LogAssertToErrorFile);
+		JSONTools::ReadString("ProfileMode", debug, Config::Debug::ProfileMode);
+		JSONTools::ReadInt("ProfileEveryNthFrame", debug, Config::Debug::ProfileEveryNthFrame);
+		JSONTools::ReadString("ProfileFilename", debug, Config::Debug::ProfileFilename);
 		JSONTools::ReadBool("DrawGameInfo", debug, Config::Debug::DrawGameInfo);
 		JSONTools::ReadBool("DrawBuildOrderSearchInfo", debug, Config::Debug::DrawBuildOrderSearchInfo);
 		JSONTools::ReadBool("DrawUnitHealthBars", debug, Config::Debug::DrawUnitHealthBars);
@@ -102,6 +113,7 @@ void ParseUtils::ParseConfigFile(const std::string &filename)
 		JSONTools::ReadBool("DrawScoutInfo", debug, Config::Debug::DrawScoutInfo);
 		JSONTools::ReadBool("DrawSquadInfo", debug, Config::Debug::DrawSquadInfo);
 		JSONTools::ReadBool("DrawCombatSimInfo", debug, Config::Debug::DrawCombatSimulationInfo);
+		JSONTools::ReadBool("RecordCombatSnapshots", debug, Config::Debug::RecordCombatSnapshots);
 		JSONTools::ReadBool("DrawBuildingInfo", debug, Config::Debug::DrawBuildingInfo);
 		JSONTools::ReadBool("DrawModuleTimers", debug, Config::Debug::DrawModuleTimers);
 		JSONTools::ReadBool("DrawMouseCursorInfo", debug, Config::Debug::DrawMouseCursorInfo);
@@ -136,6 +148,9 @@ void ParseUtils::ParseConfigFile(const std::string &filename)
 		const rapidjson::Value &tool = doc["Tools"];
 
 		JSONTools::ReadInt("MapGridSize", tool, Config::Tools::MAP_GRID_SIZE);
+		JSONTools::ReadBool("UseDistanceAtlas", tool, Config::Tools::UseDistanceAtlas);
+		JSONTools::ReadBool("UseRegionGraph", tool, Config::Tools::UseRegionGraph);
+		JSONTools::ReadBool("ExactGroundDistance", tool, Config::Tools::ExactGroundDistance);
 	}
 
 	// Parse the Strategy Options
@@ -49,15 +49,18 @@ void ProductionManager::performBuildOrderSearch()
 	}
 }
 
+// resumes the build order search in progress with the time the frame scheduler has left over
+void ProductionManager::updateBuildOrderSearch(double timeLimit)
+{
+	m_bossManager.update(std::min(timeLimit, (double)Config::Macro::BOSSTimePerFrame));
+}
+
 void ProductionManager::update()
 {
 	PROFILE_FUNCTION();
 
 	m_buildingManager.update();
 
-	// 30 ms per search update
-	m_bossManager.update(Config::Macro::BOSSTimePerFrame);
-
 	// check the _queue for stuff we can build
 	manageBuildOrderQueue();
 
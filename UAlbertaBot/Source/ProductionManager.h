@@ -44,6 +44,7 @@ namespace UAlbertaBot
 
 	public:
 		void update();
+		void updateBuildOrderSearch(double timeLimit);
 		void onUnitDestroy(BWAPI::Unit unit);
 		void performBuildOrderSearch();
 		void drawProductionInformation(int x, int y);
@@ -1,15 +1,35 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <memory>
 #include <mutex>
-#include <map>
-#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Chrome trace (chrome://tracing) profiler used by UAlbertaBot, BOSS and SparCraft
+//
+// Each thread records fixed-size events into its own lock-free ring buffer, which are only
+// collected and written to disk at the end of a frame, so a profiled scope costs two clock reads
+// and a buffer write. While no frame is being sampled a scope costs a single atomic load, which
+// is cheap enough to leave compiled in for tournament games. Define NO_PROFILING to remove it.
+#ifndef NO_PROFILING
+#define PROFILING 1
+#endif
+
+// SparCraft and BOSS define these as no-ops when they are built without the profiler
+#undef PROFILE_SCOPE
+#undef PROFILE_FUNCTION
 
-//#define PROFILING 1
 #ifdef PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
 #define PROFILE_SCOPE(name) \
-	ProfileTimer timer##__LINE__(name)
+	::UAlbertaBot::ProfileTimer PROFILE_CONCAT(profileTimer, __LINE__)(name)
 #define PROFILE_FUNCTION() \
 	PROFILE_SCOPE(__FUNCTION__)
 #else
@@ -20,30 +40,192 @@
 namespace UAlbertaBot
 {
 
-	struct ProfileResult
+	// name must be a string literal (or otherwise outlive the profiler), it is stored by pointer
+	struct ProfileEvent
 	{
-		std::string name = "Default";
+		const char *name = "Default";
 		long long start = 0;
 		long long end = 0;
-		size_t threadID = 0;
+	};
+
+	// single producer (the owning thread) / single consumer (the flushing thread) ring of events
+	// when the ring is full new events are dropped rather than blocking the thread being profiled
+	class ProfileBuffer
+	{
+		std::vector<ProfileEvent> m_events;
+		const size_t m_mask;
+		const size_t m_threadID;
+		std::atomic<size_t> m_head;
+		std::atomic<size_t> m_tail;
+		std::atomic<size_t> m_dropped;
+
+	public:
+		// capacity must be a power of two
+		ProfileBuffer(size_t threadID, size_t capacity)
+			: m_events(capacity), m_mask(capacity - 1), m_threadID(threadID), m_head(0), m_tail(0), m_dropped(0)
+		{
+		}
+
+		size_t threadID() const
+		{
+			return m_threadID;
+		}
+
+		size_t dropped() const
+		{
+			return m_dropped.load(std::memory_order_relaxed);
+		}
+
+		void push(const ProfileEvent &event)
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+			if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+			{
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			m_events[head & m_mask] = event;
+			m_head.store(head + 1, std::memory_order_release);
+		}
+
+		// hands every event pushed so far to f and removes it from the ring
+		template <class F>
+		void drain(F f)
+		{
+			const size_t tail = m_tail.load(std::memory_order_relaxed);
+			const size_t head = m_head.load(std::memory_order_acquire);
+
+			for (size_t i(tail); i != head; ++i)
+			{
+				f(m_events[i & m_mask]);
+			}
+
+			m_tail.store(head, std::memory_order_release);
+		}
 	};
 
 	class Profiler
 	{
+	public:
+		enum class Mode
+		{
+			Off,			  // nothing is recorded
+			All,			  // every event is recorded, including outside of frames
+			EveryNthFrame,	  // only frames whose number is a multiple of N are recorded
+			OverBudgetFrames  // every frame is recorded, but only kept if it took longer than the budget
+		};
+
+	private:
+		struct KeptEvent
+		{
+			ProfileEvent event;
+			size_t threadID = 0;
+			int frame = -1;
+		};
+
+		static const size_t BufferCapacity = 1 << 14;
+		static const size_t FlushThreshold = 1 << 16;
+
+		std::atomic<bool> m_recording;
+
+		// guards thread registration, collecting the buffers and writing the file
+		std::mutex m_lock;
+		std::vector<std::unique_ptr<ProfileBuffer>> m_buffers;
+		std::vector<KeptEvent> m_kept;
+
 		std::string m_outputFile = "results.json";
-		size_t m_profileCount = 0;
 		std::ofstream m_outputStream;
-		std::mutex m_lock;
+		size_t m_profileCount = 0;
+
+		Mode m_mode = Mode::Off;
+		int m_everyNthFrame = 1;
+		double m_frameBudgetMS = 0;
+		int m_frame = -1;
+		long long m_frameStart = 0;
+		size_t m_framesKept = 0;
 
 		Profiler()
+			: m_recording(false)
 		{
-			m_outputStream = std::ofstream(m_outputFile);
-			writeHeader();
 		}
 
 		void writeHeader() { m_outputStream << "{\"otherData\": {},\"traceEvents\":["; }
 		void writeFooter() { m_outputStream << "]}"; }
 
+		// buffers are owned by the profiler so their events survive the thread exiting
+		ProfileBuffer &threadBuffer()
+		{
+			thread_local ProfileBuffer *buffer = nullptr;
+			if (!buffer)
+			{
+				std::lock_guard<std::mutex> lock(m_lock);
+				m_buffers.emplace_back(new ProfileBuffer(m_buffers.size(), BufferCapacity));
+				buffer = m_buffers.back().get();
+			}
+
+			return *buffer;
+		}
+
+		// must hold m_lock
+		void collect(bool keep)
+		{
+			for (auto &buffer : m_buffers)
+			{
+				const size_t threadID = buffer->threadID();
+				buffer->drain([&](const ProfileEvent &event)
+				{
+					if (keep)
+					{
+						KeptEvent kept;
+						kept.event = event;
+						kept.threadID = threadID;
+						kept.frame = m_frame;
+						m_kept.push_back(kept);
+					}
+				});
+			}
+		}
+
+		// must hold m_lock
+		void writeKept()
+		{
+			if (m_kept.empty())
+			{
+				return;
+			}
+
+			if (!m_outputStream.is_open())
+			{
+				m_outputStream.open(m_outputFile);
+				writeHeader();
+			}
+
+			for (auto &kept : m_kept)
+			{
+				std::string name = kept.event.name;
+				std::replace(name.begin(), name.end(), '"', '\'');
+
+				if (m_profileCount++ > 0)
+				{
+					m_outputStream << ",";
+				}
+
+				m_outputStream << "\n{";
+				m_outputStream << "\"cat\":\"function\",";
+				m_outputStream << "\"dur\":" << (kept.event.end - kept.event.start) << ',';
+				m_outputStream << "\"name\":\"" << name << "\",";
+				m_outputStream << "\"ph\":\"X\",";
+				m_outputStream << "\"pid\":0,";
+				m_outputStream << "\"tid\":" << kept.threadID << ",";
+				m_outputStream << "\"ts\":" << kept.event.start << ",";
+				m_outputStream << "\"args\":{\"frame\":" << kept.frame << "}";
+				m_outputStream << "}";
+			}
+
+			m_kept.clear();
+		}
+
 	public:
 		static Profiler &Instance()
 		{
@@ -51,47 +233,134 @@ namespace UAlbertaBot
 			return instance;
 		}
 
+		static long long Now()
+		{
+			return std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()).time_since_epoch().count();
+		}
+
 		~Profiler()
 		{
-			writeFooter();
+			flush();
+
+			if (m_outputStream.is_open())
+			{
+				writeFooter();
+			}
 		}
 
-		void writeProfile(const ProfileResult &result)
+		void setOutputFile(const std::string &filename)
 		{
 			std::lock_guard<std::mutex> lock(m_lock);
+			m_outputFile = filename;
+		}
 
-			if (m_profileCount++ > 0)
+		// frameBudgetMS is only used by OverBudgetFrames
+		void setMode(Mode mode, int everyNthFrame = 1, double frameBudgetMS = 0)
+		{
+			m_mode = mode;
+			m_everyNthFrame = std::max(1, everyNthFrame);
+			m_frameBudgetMS = frameBudgetMS;
+			m_recording.store(mode == Mode::All, std::memory_order_relaxed);
+		}
+
+		inline bool isRecording() const
+		{
+			return m_recording.load(std::memory_order_relaxed);
+		}
+
+		void record(const char *name, long long start, long long end)
+		{
+			ProfileEvent event;
+			event.name = name;
+			event.start = start;
+			event.end = end;
+			threadBuffer().push(event);
+		}
+
+		// called by the main thread at the start and end of every game frame
+		void beginFrame(int frame)
+		{
+			m_frame = frame;
+			m_frameStart = Now();
+
+			const bool sample = (m_mode == Mode::All)
+				|| (m_mode == Mode::OverBudgetFrames)
+				|| (m_mode == Mode::EveryNthFrame && frame % m_everyNthFrame == 0);
+
+			m_recording.store(sample, std::memory_order_relaxed);
+		}
+
+		void endFrame()
+		{
+			if (!isRecording())
 			{
-				m_outputStream << ",";
+				return;
+			}
+
+			const long long frameEnd = Now();
+			const bool keep = (m_mode != Mode::OverBudgetFrames) || ((frameEnd - m_frameStart) / 1000.0 > m_frameBudgetMS);
+
+			if (keep)
+			{
+				record("Frame", m_frameStart, frameEnd);
 			}
 
-			std::string name = result.name;
-			std::replace(name.begin(), name.end(), '"', '\'');
+			std::lock_guard<std::mutex> lock(m_lock);
+			collect(keep);
+			m_framesKept += keep ? 1 : 0;
+
+			if (m_kept.size() >= FlushThreshold)
+			{
+				writeKept();
+			}
+
+			if (m_mode != Mode::All)
+			{
+				m_recording.store(false, std::memory_order_relaxed);
+			}
+		}
+
+		// collects everything still in the thread buffers and writes it out
+		void flush()
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			collect(m_mode == Mode::All);
+			writeKept();
+			m_outputStream.flush();
+		}
+
+		size_t getFramesKept() const
+		{
+			return m_framesKept;
+		}
 
-			m_outputStream << "\n{";
-			m_outputStream << "\"cat\":\"function\",";
-			m_outputStream << "\"dur\":" << (result.end - result.start) << ',';
-			m_outputStream << "\"name\":\"" << name << "\",";
-			m_outputStream << "\"ph\":\"X\",";
-			m_outputStream << "\"pid\":0,";
-			m_outputStream << "\"tid\":" << result.threadID << ",";
-			m_outputStream << "\"ts\":" << result.start;
-			m_outputStream << "}";
+		size_t getEventsDropped()
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			size_t dropped = 0;
+			for (auto &buffer : m_buffers)
+			{
+				dropped += buffer->dropped();
+			}
+
+			return dropped;
 		}
 	};
 
 	class ProfileTimer
 	{
-		ProfileResult m_result;
-		bool m_stopped = false;
-
-		std::chrono::time_point<std::chrono::high_resolution_clock> m_startTimepoint;
+		const char *m_name;
+		long long m_start = 0;
+		bool m_recording = false;
 
 	public:
-		ProfileTimer(const std::string &name)
+		ProfileTimer(const char *name)
+			: m_name(name), m_recording(Profiler::Instance().isRecording())
 		{
-			m_result.name = name;
-			m_startTimepoint = std::chrono::high_resolution_clock::now();
+			if (m_recording)
+			{
+				m_start = Profiler::Now();
+			}
 		}
 
 		~ProfileTimer()
@@ -101,19 +370,13 @@ namespace UAlbertaBot
 
 		void stop()
 		{
-			if (m_stopped)
+			if (!m_recording)
 			{
 				return;
 			}
 
-			auto endTimepoint = std::chrono::high_resolution_clock::now();
-
-			m_result.start = std::chrono::time_point_cast<std::chrono::microseconds>(m_startTimepoint).time_since_epoch().count();
-			m_result.end = std::chrono::time_point_cast<std::chrono::microseconds>(endTimepoint).time_since_epoch().count();
-			m_result.threadID = std::hash<std::thread::id>{}(std::this_thread::get_id());
-			Profiler::Instance().writeProfile(m_result);
-
-			m_stopped = true;
+			Profiler::Instance().record(m_name, m_start, Profiler::Now());
+			m_recording = false;
 		}
 	};
-}
\ No newline at end of file
+}
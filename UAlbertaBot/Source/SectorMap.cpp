@@ -0,0 +1,348 @@
+#include "SectorMap.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace UAlbertaBot;
+
+namespace
+{
+	const int LegalActions = 4;
+	const int ActionX[LegalActions] = { 1, -1, 0, 0 };
+	const int ActionY[LegalActions] = { 0, 0, 1, -1 };
+}
+
+SectorMap::SectorMap()
+{
+}
+
+int SectorMap::index(int x, int y) const
+{
+	return y * m_width + x;
+}
+
+bool SectorMap::isValid(int x, int y) const
+{
+	return x >= 0 && y >= 0 && x < m_width && y < m_height;
+}
+
+bool SectorMap::isWalkable(int x, int y) const
+{
+	return isValid(x, y) && m_walkable[index(x, y)];
+}
+
+int SectorMap::newSector()
+{
+	m_parent.push_back((int)m_parent.size());
+	return (int)m_parent.size() - 1;
+}
+
+int SectorMap::findSector(int id) const
+{
+	while (m_parent[id] != id)
+	{
+		m_parent[id] = m_parent[m_parent[id]];
+		id = m_parent[id];
+	}
+
+	return id;
+}
+
+void SectorMap::uniteSectors(int a, int b)
+{
+	a = findSector(a);
+	b = findSector(b);
+
+	if (a != b)
+	{
+		m_parent[std::max(a, b)] = std::min(a, b);
+	}
+}
+
+int SectorMap::findSearch(int search)
+{
+	while (m_searchParent[search] != search)
+	{
+		m_searchParent[search] = m_searchParent[m_searchParent[search]];
+		search = m_searchParent[search];
+	}
+
+	return search;
+}
+
+void SectorMap::reset(int width, int height, const std::vector<char> &walkable)
+{
+	m_width = width;
+	m_height = height;
+	m_walkable = walkable;
+	m_sector.assign(width * height, 0);
+	m_parent.assign(1, 0);
+	m_visited.assign(width * height, 0);
+	m_stamp = 0;
+	m_lastVisited = 0;
+
+	std::vector<int> fringe;
+	fringe.reserve(width * height);
+
+	// for every tile on the map, do a connected flood fill using BFS
+	for (int start = 0; start < width * height; ++start)
+	{
+		if (!m_walkable[start] || m_sector[start] != 0)
+		{
+			continue;
+		}
+
+		const int sector = newSector();
+		fringe.clear();
+		fringe.push_back(start);
+		m_sector[start] = sector;
+
+		for (size_t f = 0; f < fringe.size(); ++f)
+		{
+			const int x = fringe[f] % width;
+			const int y = fringe[f] / width;
+
+			for (int a = 0; a < LegalActions; ++a)
+			{
+				const int nextX = x + ActionX[a];
+				const int nextY = y + ActionY[a];
+
+				if (isWalkable(nextX, nextY) && m_sector[index(nextX, nextY)] == 0)
+				{
+					m_sector[index(nextX, nextY)] = sector;
+					fringe.push_back(index(nextX, nextY));
+				}
+			}
+		}
+
+		m_lastVisited += fringe.size();
+	}
+}
+
+void SectorMap::setWalkable(int x, int y, int width, int height, bool walkable)
+{
+	std::vector<std::array<int, 2>> tiles;
+	for (int tx = x; tx < x + width; ++tx)
+	{
+		for (int ty = y; ty < y + height; ++ty)
+		{
+			tiles.push_back({ tx, ty });
+		}
+	}
+
+	setWalkable(tiles, walkable);
+}
+
+void SectorMap::setWalkable(const std::vector<std::array<int, 2>> &tiles, bool walkable)
+{
+	std::vector<int> changed;
+	for (auto &tile : tiles)
+	{
+		if (isValid(tile[0], tile[1]) && (m_walkable[index(tile[0], tile[1])] != 0) != walkable)
+		{
+			m_walkable[index(tile[0], tile[1])] = walkable;
+			changed.push_back(index(tile[0], tile[1]));
+		}
+	}
+
+	m_lastVisited = changed.size();
+
+	if (walkable)
+	{
+		// every newly walkable tile joins the sectors around it, or starts a new one
+		for (int tile : changed)
+		{
+			int sector = 0;
+
+			for (int a = 0; a < LegalActions; ++a)
+			{
+				const int nextX = tile % m_width + ActionX[a];
+				const int nextY = tile / m_width + ActionY[a];
+				if (!isWalkable(nextX, nextY) || m_sector[index(nextX, nextY)] == 0)
+				{
+					continue;
+				}
+
+				if (sector == 0)
+				{
+					sector = findSector(m_sector[index(nextX, nextY)]);
+				}
+				else
+				{
+					uniteSectors(sector, m_sector[index(nextX, nextY)]);
+					sector = findSector(sector);
+				}
+			}
+
+			m_sector[tile] = sector != 0 ? sector : newSector();
+		}
+
+		return;
+	}
+
+	// the walkable neighbours of the blocked tiles, grouped by the sector they are in
+	std::vector<std::pair<int, int>> seeds;
+	for (int tile : changed)
+	{
+		m_sector[tile] = 0;
+	}
+
+	for (int tile : changed)
+	{
+		for (int a = 0; a < LegalActions; ++a)
+		{
+			const int nextX = tile % m_width + ActionX[a];
+			const int nextY = tile / m_width + ActionY[a];
+			if (isWalkable(nextX, nextY))
+			{
+				seeds.push_back({ findSector(m_sector[index(nextX, nextY)]), index(nextX, nextY) });
+			}
+		}
+	}
+
+	std::sort(seeds.begin(), seeds.end());
+	seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
+
+	std::vector<int> sectorSeeds;
+	for (size_t s = 0; s < seeds.size(); ++s)
+	{
+		sectorSeeds.push_back(seeds[s].second);
+
+		if (s + 1 == seeds.size() || seeds[s + 1].first != seeds[s].first)
+		{
+			splitSector(sectorSeeds);
+			sectorSeeds.clear();
+		}
+	}
+}
+
+// the seeds are walkable tiles of the same sector, every piece the sector may have been cut into
+// contains at least one of them
+void SectorMap::splitSector(const std::vector<int> &seeds)
+{
+	// one seed means there is only one piece
+	if (seeds.size() < 2)
+	{
+		return;
+	}
+
+	const int numSearches = (int)seeds.size();
+	if (m_stamp > std::numeric_limits<int>::max() - numSearches - 1)
+	{
+		std::fill(m_visited.begin(), m_visited.end(), 0);
+		m_stamp = 0;
+	}
+
+	// search s marks the tiles it visits with firstStamp + s
+	const int firstStamp = m_stamp + 1;
+	m_stamp += numSearches;
+
+	m_searches.resize(numSearches);
+	m_searchParent.resize(numSearches);
+	m_searchActive.assign(numSearches, 1);
+	for (int s = 0; s < numSearches; ++s)
+	{
+		m_searches[s].tiles.assign(1, seeds[s]);
+		m_searches[s].head = 0;
+		m_searchParent[s] = s;
+		m_visited[seeds[s]] = firstStamp + s;
+	}
+
+	// searches which meet are merged, the sector is split once the only pieces left unfinished
+	// are the ones still being searched by a single merged search
+	int running = numSearches;
+	while (running > 1)
+	{
+		for (int s = 0; s < numSearches && running > 1; ++s)
+		{
+			Search &search = m_searches[s];
+			if (search.head == search.tiles.size() || m_searchActive[findSearch(s)] == 0)
+			{
+				continue;
+			}
+
+			const int tile = search.tiles[search.head++];
+			for (int a = 0; a < LegalActions; ++a)
+			{
+				const int nextX = tile % m_width + ActionX[a];
+				const int nextY = tile / m_width + ActionY[a];
+				if (!isWalkable(nextX, nextY))
+				{
+					continue;
+				}
+
+				const int next = index(nextX, nextY);
+				const int visitedBy = m_visited[next] - firstStamp;
+
+				if (visitedBy < 0 || visitedBy >= numSearches)
+				{
+					m_visited[next] = firstStamp + s;
+					search.tiles.push_back(next);
+				}
+				else
+				{
+					const int root = findSearch(s);
+					const int other = findSearch(visitedBy);
+					if (root != other)
+					{
+						m_searchParent[other] = root;
+						m_searchActive[root] += m_searchActive[other];
+						running--;
+					}
+				}
+			}
+
+			if (search.head < search.tiles.size())
+			{
+				continue;
+			}
+
+			// once all of a merged search's searches run out it has found a whole piece
+			const int root = findSearch(s);
+			if (--m_searchActive[root] > 0)
+			{
+				continue;
+			}
+
+			const int sector = newSector();
+			for (int member = 0; member < numSearches; ++member)
+			{
+				if (findSearch(member) == root)
+				{
+					for (int visited : m_searches[member].tiles)
+					{
+						m_sector[visited] = sector;
+					}
+				}
+			}
+
+			running--;
+		}
+	}
+
+	for (const Search &search : m_searches)
+	{
+		m_lastVisited += search.tiles.size();
+	}
+}
+
+bool SectorMap::isConnected(int x1, int y1, int x2, int y2) const
+{
+	const int s1 = getSector(x1, y1);
+	return s1 != 0 && s1 == getSector(x2, y2);
+}
+
+int SectorMap::getSector(int x, int y) const
+{
+	if (!isValid(x, y))
+	{
+		return 0;
+	}
+
+	return findSector(m_sector[index(x, y)]);
+}
+
+size_t SectorMap::getLastVisited() const
+{
+	return m_lastVisited;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace UAlbertaBot
+{
+	// 4-directional ground connectivity of the tile grid, kept up to date as tiles become blocked
+	// (buildings placed) or unblocked (buildings destroyed, minerals mined out)
+	//
+	// Tiles store a sector id and ids are merged with union-find, so the sector of a tile is the
+	// root of its id. Unblocking tiles only unions the sectors around them. Blocking tiles runs
+	// one BFS per walkable neighbour of the blocked tiles, interleaved a tile at a time and merged
+	// when they meet, until a single search is left running. Searches that finish first are the
+	// pieces cut off from the sector and get new ids, the rest of the sector is never visited.
+	class SectorMap
+	{
+		struct Search
+		{
+			std::vector<int>	tiles;		// every tile visited, the unexpanded ones from head on
+			size_t				head = 0;
+		};
+
+		int					m_width = 0;
+		int					m_height = 0;
+		std::vector<char>	m_walkable;		// row-major
+		std::vector<int>	m_sector;		// row-major sector id, 0 where not walkable
+		mutable std::vector<int> m_parent;	// union-find over sector ids, id 0 is its own root
+		std::vector<int>	m_visited;		// search stamp of the last search to visit each tile
+		int					m_stamp = 0;
+		size_t				m_lastVisited = 0;
+
+		std::vector<Search>	m_searches;
+		std::vector<int>	m_searchParent;
+		std::vector<int>	m_searchActive;	// per root search, how many of its searches have tiles left
+
+		int index(int x, int y) const;
+		int newSector();
+		int findSector(int id) const;
+		int findSearch(int search);
+		void uniteSectors(int a, int b);
+		void splitSector(const std::vector<int> &seeds);
+
+	public:
+		SectorMap();
+
+		// labels every sector with a flood fill, walkable is row-major width * height
+		void reset(int width, int height, const std::vector<char> &walkable);
+
+		// sets the walkability of the tiles and updates the sectors, tiles changed together are
+		// updated together, which is cheaper than one at a time
+		void setWalkable(const std::vector<std::array<int, 2>> &tiles, bool walkable);
+		void setWalkable(int x, int y, int width, int height, bool walkable);
+
+		bool isValid(int x, int y) const;
+		bool isWalkable(int x, int y) const;
+		bool isConnected(int x1, int y1, int x2, int y2) const;
+
+		// 0 if the tile isn't walkable, tiles with the same sector are connected
+		int getSector(int x, int y) const;
+
+		// tiles visited by the last setWalkable, for profiling
+		size_t getLastVisited() const;
+	};
+}
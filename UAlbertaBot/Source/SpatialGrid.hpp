@@ -0,0 +1,262 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+
+// A uniform bucket grid over pixel positions for radius, rectangle and k-nearest queries
+// Keys are any hashable handle (BWAPI::Unit, unit IDs, ...) so it can be used without BWAPI
+// Positions are updated incrementally, and only change buckets when a key crosses a cell border
+
+namespace UAlbertaBot
+{
+
+	template <class T>
+	class SpatialGrid
+	{
+		struct Entry
+		{
+			T key;
+			int x = 0;
+			int y = 0;
+			size_t cell = 0;
+			size_t slot = 0; // index of this entry within its cell's bucket
+		};
+
+		int m_cellSize = 128;
+		int m_cols = 0;
+		int m_rows = 0;
+
+		std::vector<Entry> m_entries;
+		std::vector<std::vector<size_t>> m_cells;
+		std::unordered_map<T, size_t> m_index;
+
+		inline int cellCoord(int val, int max) const
+		{
+			return std::max(0, std::min(max - 1, val / m_cellSize));
+		}
+
+		inline size_t cellOf(int x, int y) const
+		{
+			return cellCoord(y, m_rows) * m_cols + cellCoord(x, m_cols);
+		}
+
+		void addToCell(size_t entryIndex, size_t cell)
+		{
+			Entry &entry = m_entries[entryIndex];
+			entry.cell = cell;
+			entry.slot = m_cells[cell].size();
+			m_cells[cell].push_back(entryIndex);
+		}
+
+		void removeFromCell(size_t entryIndex)
+		{
+			const Entry &entry = m_entries[entryIndex];
+			std::vector<size_t> &bucket = m_cells[entry.cell];
+
+			bucket[entry.slot] = bucket.back();
+			m_entries[bucket[entry.slot]].slot = entry.slot;
+			bucket.pop_back();
+		}
+
+		static inline long long distSq(const Entry &entry, int x, int y)
+		{
+			const long long dx = entry.x - x;
+			const long long dy = entry.y - y;
+			return dx * dx + dy * dy;
+		}
+
+	public:
+		SpatialGrid() {}
+
+		// width and height are the size of the area covered in pixels, positions outside it are clamped to the border cells
+		SpatialGrid(int width, int height, int cellSize = 128)
+			: m_cellSize(cellSize), m_cols(std::max(1, (width + cellSize - 1) / cellSize)), m_rows(std::max(1, (height + cellSize - 1) / cellSize)), m_cells(m_cols * m_rows)
+		{
+		}
+
+		// inserts the key, or moves it if it is already in the grid
+		void update(const T &key, int x, int y)
+		{
+			auto it = m_index.find(key);
+			if (it == m_index.end())
+			{
+				Entry entry;
+				entry.key = key;
+				entry.x = x;
+				entry.y = y;
+				m_index[key] = m_entries.size();
+				m_entries.push_back(entry);
+				addToCell(m_entries.size() - 1, cellOf(x, y));
+				return;
+			}
+
+			const size_t entryIndex = it->second;
+			const size_t cell = cellOf(x, y);
+			m_entries[entryIndex].x = x;
+			m_entries[entryIndex].y = y;
+
+			if (cell != m_entries[entryIndex].cell)
+			{
+				removeFromCell(entryIndex);
+				addToCell(entryIndex, cell);
+			}
+		}
+
+		void remove(const T &key)
+		{
+			auto it = m_index.find(key);
+			if (it == m_index.end())
+			{
+				return;
+			}
+
+			// swap the last entry into the removed entry's place so the entries stay dense
+			const size_t entryIndex = it->second;
+			const size_t lastIndex = m_entries.size() - 1;
+			removeFromCell(entryIndex);
+			m_index.erase(it);
+
+			if (entryIndex != lastIndex)
+			{
+				Entry &moved = m_entries[lastIndex];
+				m_cells[moved.cell][moved.slot] = entryIndex;
+				m_index[moved.key] = entryIndex;
+				m_entries[entryIndex] = moved;
+			}
+
+			m_entries.pop_back();
+		}
+
+		void clear()
+		{
+			m_entries.clear();
+			m_index.clear();
+			for (auto &bucket : m_cells)
+			{
+				bucket.clear();
+			}
+		}
+
+		bool contains(const T &key) const
+		{
+			return m_index.find(key) != m_index.end();
+		}
+
+		size_t size() const
+		{
+			return m_entries.size();
+		}
+
+		int cellSize() const
+		{
+			return m_cellSize;
+		}
+
+		// appends every key within radius (inclusive) of x, y
+		void getInRadius(int x, int y, int radius, std::vector<T> &keys) const
+		{
+			const long long radiusSq = (long long)radius * radius;
+			const int cx0 = cellCoord(x - radius, m_cols), cx1 = cellCoord(x + radius, m_cols);
+			const int cy0 = cellCoord(y - radius, m_rows), cy1 = cellCoord(y + radius, m_rows);
+
+			for (int cy = cy0; cy <= cy1; ++cy)
+			{
+				for (int cx = cx0; cx <= cx1; ++cx)
+				{
+					for (size_t entryIndex : m_cells[cy * m_cols + cx])
+					{
+						const Entry &entry = m_entries[entryIndex];
+						if (distSq(entry, x, y) <= radiusSq)
+						{
+							keys.push_back(entry.key);
+						}
+					}
+				}
+			}
+		}
+
+		// appends every key inside the rectangle, borders inclusive
+		void getInRectangle(int left, int top, int right, int bottom, std::vector<T> &keys) const
+		{
+			const int cx0 = cellCoord(left, m_cols), cx1 = cellCoord(right, m_cols);
+			const int cy0 = cellCoord(top, m_rows), cy1 = cellCoord(bottom, m_rows);
+
+			for (int cy = cy0; cy <= cy1; ++cy)
+			{
+				for (int cx = cx0; cx <= cx1; ++cx)
+				{
+					for (size_t entryIndex : m_cells[cy * m_cols + cx])
+					{
+						const Entry &entry = m_entries[entryIndex];
+						if (entry.x >= left && entry.x <= right && entry.y >= top && entry.y <= bottom)
+						{
+							keys.push_back(entry.key);
+						}
+					}
+				}
+			}
+		}
+
+		// appends the (up to) k keys closest to x, y, nearest first
+		// searches outward one ring of cells at a time and stops once no unsearched cell can hold a closer key
+		void getKNearest(int x, int y, size_t k, std::vector<T> &keys) const
+		{
+			if (k == 0 || m_entries.empty())
+			{
+				return;
+			}
+
+			std::vector<std::pair<long long, size_t>> candidates;
+			const int qx = cellCoord(x, m_cols), qy = cellCoord(y, m_rows);
+			const int maxRing = std::max(std::max(qx, m_cols - 1 - qx), std::max(qy, m_rows - 1 - qy));
+
+			for (int ring = 0; ring <= maxRing; ++ring)
+			{
+				for (int cy = qy - ring; cy <= qy + ring; ++cy)
+				{
+					if (cy < 0 || cy >= m_rows)
+					{
+						continue;
+					}
+
+					// only the border of the ring, the inside was searched by the previous rings
+					const int step = (cy == qy - ring || cy == qy + ring) ? 1 : std::max(1, 2 * ring);
+					for (int cx = qx - ring; cx <= qx + ring; cx += step)
+					{
+						if (cx < 0 || cx >= m_cols)
+						{
+							continue;
+						}
+
+						for (size_t entryIndex : m_cells[cy * m_cols + cx])
+						{
+							candidates.push_back({distSq(m_entries[entryIndex], x, y), entryIndex});
+						}
+					}
+				}
+
+				// every key in a later ring is at least ring * cellSize pixels away along one axis
+				if (candidates.size() >= k)
+				{
+					std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+					const long long bound = (long long)ring * m_cellSize;
+					if (candidates[k - 1].first <= bound * bound)
+					{
+						break;
+					}
+				}
+			}
+
+			const size_t count = std::min(k, candidates.size());
+			std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+			for (size_t i(0); i < count; ++i)
+			{
+				keys.push_back(m_entries[candidates[i].second].key);
+			}
+		}
+	};
+
+}
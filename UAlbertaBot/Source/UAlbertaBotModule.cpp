@@ -26,6 +26,27 @@ UAlbertaBotModule::UAlbertaBotModule()
 	Global::GameStart();
 }
 
+// profiling is always compiled in, the config file decides which frames (if any) get written out
+static void StartProfiler()
+{
+	Profiler::Mode mode = Profiler::Mode::Off;
+	if (Config::Debug::ProfileMode == "All")
+	{
+		mode = Profiler::Mode::All;
+	}
+	else if (Config::Debug::ProfileMode == "EveryNthFrame")
+	{
+		mode = Profiler::Mode::EveryNthFrame;
+	}
+	else if (Config::Debug::ProfileMode == "OverBudgetFrames")
+	{
+		mode = Profiler::Mode::OverBudgetFrames;
+	}
+
+	Profiler::Instance().setOutputFile(Config::Debug::ProfileFilename);
+	Profiler::Instance().setMode(mode, Config::Debug::ProfileEveryNthFrame, Config::Tournament::FrameTimeBudget);
+}
+
 // This gets called when the bot starts!
 void UAlbertaBotModule::onStart()
 {
@@ -47,6 +68,8 @@ void UAlbertaBotModule::onStart()
 		BWAPI::Broodwar->enableFlag(BWAPI::Flag::UserInput);
 	}
 
+	StartProfiler();
+
 	if (Config::BotInfo::PrintInfoOnStart)
 	{
 		BWAPI::Broodwar->printf("Hello! I am %s, written by %s", Config::BotInfo::BotName.c_str(), Config::BotInfo::Authors.c_str());
@@ -70,7 +93,10 @@ void UAlbertaBotModule::onEnd(bool isWinner)
 	if (Config::Modules::UsingGameCommander)
 	{
 		Global::Strategy().onEnd(isWinner);
+		m_gameCommander.onEnd();
 	}
+
+	Profiler::Instance().flush();
 }
 
 void UAlbertaBotModule::onFrame()
@@ -108,6 +134,8 @@ void UAlbertaBotModule::onFrame()
 		return;
 	}
 
+	Profiler::Instance().beginFrame(BWAPI::Broodwar->getFrameCount());
+
 	if (Config::Modules::UsingGameCommander)
 	{
 		m_gameCommander.update();
@@ -117,6 +145,8 @@ void UAlbertaBotModule::onFrame()
 	{
 		m_autoObserver.onFrame();
 	}
+
+	Profiler::Instance().endFrame();
 }
 
 void UAlbertaBotModule::onUnitDestroy(BWAPI::Unit unit)
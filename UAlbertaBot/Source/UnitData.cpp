@@ -4,7 +4,7 @@
 using namespace UAlbertaBot;
 
 UnitData::UnitData()
-	: mineralsLost(0), gasLost(0)
+	: spatialGrid(BWAPI::Broodwar->mapWidth() * 32, BWAPI::Broodwar->mapHeight() * 32), mineralsLost(0), gasLost(0)
 {
 	int maxTypeID(0);
 	for (const BWAPI::UnitType &t : BWAPI::UnitTypes::allUnitTypes())
@@ -41,6 +41,8 @@ void UnitData::updateUnit(BWAPI::Unit unit)
 	ui.type = unit->getType();
 	ui.completed = unit->isCompleted();
 
+	spatialGrid.update(unit, ui.lastPosition.x, ui.lastPosition.y);
+
 	if (firstSeen)
 	{
 		numUnits[unit->getType().getID()]++;
@@ -60,6 +62,7 @@ void UnitData::removeUnit(BWAPI::Unit unit)
 	numDeadUnits[unit->getType().getID()]++;
 
 	unitMap.erase(unit);
+	spatialGrid.remove(unit);
 }
 
 void UnitData::removeBadUnits()
@@ -69,6 +72,7 @@ void UnitData::removeBadUnits()
 		if (badUnitInfo(iter->second))
 		{
 			numUnits[iter->second.type.getID()]--;
+			spatialGrid.remove(iter->first);
 			iter = unitMap.erase(iter);
 		}
 		else
@@ -123,4 +127,9 @@ int UnitData::getNumDeadUnits(BWAPI::UnitType t) const
 const std::map<BWAPI::Unit, UnitInfo> &UnitData::getUnits() const
 {
 	return unitMap;
+}
+
+const SpatialGrid<BWAPI::Unit> &UnitData::getSpatialGrid() const
+{
+	return spatialGrid;
 }
\ No newline at end of file
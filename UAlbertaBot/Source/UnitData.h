@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "SpatialGrid.hpp"
 
 namespace UAlbertaBot
 {
@@ -44,6 +45,7 @@ namespace UAlbertaBot
 	class UnitData
 	{
 		UIMap unitMap;
+		SpatialGrid<BWAPI::Unit> spatialGrid; // last known positions of the units in unitMap
 
 		std::vector<int> numDeadUnits;
 		std::vector<int> numUnits;
@@ -64,5 +66,6 @@ namespace UAlbertaBot
 		int getNumUnits(BWAPI::UnitType t) const;
 		int getNumDeadUnits(BWAPI::UnitType t) const;
 		const std::map<BWAPI::Unit, UnitInfo> &getUnits() const;
+		const SpatialGrid<BWAPI::Unit> &getSpatialGrid() const;
 	};
 }
\ No newline at end of file
@@ -5,24 +5,107 @@ using namespace UAlbertaBot;
 
 WorkerData::WorkerData()
 {
-	for (auto &unit : BWAPI::Broodwar->getAllUnits())
+	for (int job = 0; job < NumJobs; ++job)
 	{
-		if ((unit->getType() == BWAPI::UnitTypes::Resource_Mineral_Field))
-		{
-			m_workersOnMineralPatch[unit] = 0;
-		}
+		m_jobHead[job] = -1;
+		m_jobCount[job] = 0;
 	}
 }
 
+int WorkerData::getSlot(BWAPI::Unit unit) const
+{
+	if (!unit || unit->getID() < 0 || unit->getID() >= (int)m_slotOfUnit.size())
+	{
+		return -1;
+	}
+
+	return m_slotOfUnit[unit->getID()];
+}
+
+// gives the unit a slot in the worker table if it doesn't have one yet, new workers start out on the Default job
+int WorkerData::addSlot(BWAPI::Unit unit)
+{
+	int slot = getSlot(unit);
+	if (slot != -1)
+	{
+		return slot;
+	}
+
+	if (m_freeSlots.empty())
+	{
+		slot = (int)m_workerTable.size();
+		m_workerTable.push_back(WorkerInfo());
+	}
+	else
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		m_workerTable[slot] = WorkerInfo();
+	}
+
+	if (unit->getID() >= (int)m_slotOfUnit.size())
+	{
+		m_slotOfUnit.resize(unit->getID() + 1, -1);
+	}
+
+	m_slotOfUnit[unit->getID()] = slot;
+	m_workerTable[slot].unit = unit;
+	linkJob(slot, Default);
+	return slot;
+}
+
+void WorkerData::linkJob(int slot, WorkerJob job)
+{
+	WorkerInfo &info = m_workerTable[slot];
+	info.job = job;
+	info.prevSameJob = -1;
+	info.nextSameJob = m_jobHead[job];
+
+	if (m_jobHead[job] != -1)
+	{
+		m_workerTable[m_jobHead[job]].prevSameJob = slot;
+	}
+
+	m_jobHead[job] = slot;
+	m_jobCount[job]++;
+}
+
+void WorkerData::unlinkJob(int slot)
+{
+	WorkerInfo &info = m_workerTable[slot];
+
+	if (info.prevSameJob != -1)
+	{
+		m_workerTable[info.prevSameJob].nextSameJob = info.nextSameJob;
+	}
+	else
+	{
+		m_jobHead[info.job] = info.nextSameJob;
+	}
+
+	if (info.nextSameJob != -1)
+	{
+		m_workerTable[info.nextSameJob].prevSameJob = info.prevSameJob;
+	}
+
+	info.prevSameJob = -1;
+	info.nextSameJob = -1;
+	m_jobCount[info.job]--;
+}
+
 void WorkerData::workerDestroyed(BWAPI::Unit unit)
 {
-	if (!unit)
+	const int slot = getSlot(unit);
+	if (slot == -1)
 	{
 		return;
 	}
 
 	clearPreviousJob(unit);
-	m_workers.erase(unit);
+	unlinkJob(slot);
+	m_workerTable[slot] = WorkerInfo();
+	m_slotOfUnit[unit->getID()] = -1;
+	m_freeSlots.push_back(slot);
 }
 
 void WorkerData::addWorker(BWAPI::Unit unit)
@@ -32,8 +115,8 @@ void WorkerData::addWorker(BWAPI::Unit unit)
 		return;
 	}
 
-	m_workers.insert(unit);
-	m_workerJobMap[unit] = Default;
+	addSlot(unit);
+	clearPreviousJob(unit);
 }
 
 void WorkerData::addWorker(BWAPI::Unit unit, WorkerJob job, BWAPI::Unit jobUnit)
@@ -43,9 +126,9 @@ void WorkerData::addWorker(BWAPI::Unit unit, WorkerJob job, BWAPI::Unit jobUnit)
 		return;
 	}
 
-	assert(m_workers.find(unit) == m_workers.end());
+	assert(getSlot(unit) == -1);
 
-	m_workers.insert(unit);
+	addSlot(unit);
 	setWorkerJob(unit, job, jobUnit);
 }
 
@@ -56,8 +139,8 @@ void WorkerData::addWorker(BWAPI::Unit unit, enum WorkerJob job, BWAPI::UnitType
 		return;
 	}
 
-	assert(m_workers.find(unit) == m_workers.end());
-	m_workers.insert(unit);
+	assert(getSlot(unit) == -1);
+	addSlot(unit);
 	setWorkerJob(unit, job, jobUnitType);
 }
 
@@ -70,7 +153,7 @@ void WorkerData::addDepot(BWAPI::Unit unit)
 
 	assert(m_depots.find(unit) == m_depots.end());
 	m_depots.insert(unit);
-	m_depotWorkerCount[unit] = 0;
+	addAssignedWorkers(unit, -getNumAssignedWorkers(unit));
 }
 
 void WorkerData::removeDepot(BWAPI::Unit unit)
@@ -81,29 +164,38 @@ void WorkerData::removeDepot(BWAPI::Unit unit)
 	}
 
 	m_depots.erase(unit);
-	m_depotWorkerCount.erase(unit);
 
-	// re-balance workers in here
-	for (auto &worker : m_workers)
+	// re-balance workers in here, only mineral workers have a depot. the next worker is read first
+	// since going idle moves the worker to another list
+	for (int slot = m_jobHead[Minerals]; slot != -1;)
 	{
+		const int next = m_workerTable[slot].nextSameJob;
+
 		// if a worker was working at this depot
-		if (m_workerDepotMap[worker] == unit)
+		if (m_workerTable[slot].depot == unit)
 		{
-			setWorkerJob(worker, Idle, nullptr);
+			setWorkerJob(m_workerTable[slot].unit, Idle, nullptr);
 		}
+
+		slot = next;
 	}
+
+	addAssignedWorkers(unit, -getNumAssignedWorkers(unit));
 }
 
-void WorkerData::addToMineralPatch(BWAPI::Unit unit, int num)
+void WorkerData::addAssignedWorkers(BWAPI::Unit unit, int num)
 {
-	if (m_workersOnMineralPatch.find(unit) == m_workersOnMineralPatch.end())
+	if (!unit || unit->getID() < 0)
 	{
-		m_workersOnMineralPatch[unit] = num;
+		return;
 	}
-	else
+
+	if (unit->getID() >= (int)m_assignedWorkers.size())
 	{
-		m_workersOnMineralPatch[unit] = m_workersOnMineralPatch[unit] + num;
+		m_assignedWorkers.resize(unit->getID() + 1, 0);
 	}
+
+	m_assignedWorkers[unit->getID()] += num;
 }
 
 void WorkerData::setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, BWAPI::Unit jobUnit)
@@ -114,19 +206,23 @@ void WorkerData::setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, BWAPI::Unit
 	}
 
 	clearPreviousJob(unit);
-	m_workerJobMap[unit] = job;
+
+	const int slot = getSlot(unit);
+	WorkerInfo &info = m_workerTable[slot];
+	unlinkJob(slot);
+	linkJob(slot, job);
 
 	if (job == Minerals)
 	{
 		// increase the number of workers assigned to this nexus
-		m_depotWorkerCount[jobUnit] += 1;
+		addAssignedWorkers(jobUnit, 1);
 
 		// set the mineral the worker is working on
-		m_workerDepotMap[unit] = jobUnit;
+		info.depot = jobUnit;
 
 		BWAPI::Unit mineralToMine = getMineralToMine(unit);
-		m_workerMineralAssignment[unit] = mineralToMine;
-		addToMineralPatch(mineralToMine, 1);
+		info.mineral = mineralToMine;
+		addAssignedWorkers(mineralToMine, 1);
 
 		// right click the mineral to start mining
 		Micro::SmartRightClick(unit, mineralToMine);
@@ -134,10 +230,10 @@ void WorkerData::setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, BWAPI::Unit
 	else if (job == Gas)
 	{
 		// increase the count of workers assigned to this refinery
-		m_refineryWorkerCount[jobUnit] += 1;
+		addAssignedWorkers(jobUnit, 1);
 
 		// set the refinery the worker is working on
-		m_workerRefineryMap[unit] = jobUnit;
+		info.refinery = jobUnit;
 
 		// right click the refinery to start harvesting
 		Micro::SmartRightClick(unit, jobUnit);
@@ -148,7 +244,7 @@ void WorkerData::setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, BWAPI::Unit
 		assert(unit->getType() == BWAPI::UnitTypes::Terran_SCV);
 
 		// set the building the worker is to repair
-		m_workerRepairMap[unit] = jobUnit;
+		info.repair = jobUnit;
 
 		// start repairing
 		if (!unit->isRepairing())
@@ -173,11 +269,14 @@ void WorkerData::setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, BWAPI::UnitT
 	}
 
 	clearPreviousJob(unit);
-	m_workerJobMap[unit] = job;
+
+	const int slot = getSlot(unit);
+	unlinkJob(slot);
+	linkJob(slot, job);
 
 	if (job == Build)
 	{
-		m_workerBuildingTypeMap[unit] = jobUnitType;
+		m_workerTable[slot].buildingType = jobUnitType;
 	}
 }
 
@@ -189,19 +288,23 @@ void WorkerData::setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, WorkerMoveDa
 	}
 
 	clearPreviousJob(unit);
-	m_workerJobMap[unit] = job;
+
+	const int slot = getSlot(unit);
+	unlinkJob(slot);
+	linkJob(slot, job);
 
 	if (job == Move)
 	{
-		m_workerMoveMap[unit] = wmd;
+		m_workerTable[slot].moveData = wmd;
 	}
-
-	if (m_workerJobMap[unit] != Move)
+	else
 	{
 		BWAPI::Broodwar->printf("Something went horribly wrong");
 	}
 }
 
+// undoes everything the worker's job assigned and puts it back on the Default job, a unit we
+// don't know yet gets its slot here
 void WorkerData::clearPreviousJob(BWAPI::Unit unit)
 {
 	if (!unit)
@@ -209,100 +312,56 @@ void WorkerData::clearPreviousJob(BWAPI::Unit unit)
 		return;
 	}
 
-	WorkerJob previousJob = getWorkerJob(unit);
+	const int slot = addSlot(unit);
+	WorkerInfo &info = m_workerTable[slot];
 
-	if (previousJob == Minerals)
+	if (info.job == Minerals)
 	{
-		m_depotWorkerCount[m_workerDepotMap[unit]] -= 1;
-
-		m_workerDepotMap.erase(unit);
+		addAssignedWorkers(info.depot, -1);
 
 		// remove a worker from this unit's assigned mineral patch
-		addToMineralPatch(m_workerMineralAssignment[unit], -1);
-
-		// erase the association from the map
-		m_workerMineralAssignment.erase(unit);
+		addAssignedWorkers(info.mineral, -1);
 	}
-	else if (previousJob == Gas)
+	else if (info.job == Gas)
 	{
-		m_refineryWorkerCount[m_workerRefineryMap[unit]] -= 1;
-		m_workerRefineryMap.erase(unit);
-	}
-	else if (previousJob == Build)
-	{
-		m_workerBuildingTypeMap.erase(unit);
-	}
-	else if (previousJob == Repair)
-	{
-		m_workerRepairMap.erase(unit);
-	}
-	else if (previousJob == Move)
-	{
-		m_workerMoveMap.erase(unit);
+		addAssignedWorkers(info.refinery, -1);
 	}
 
-	m_workerJobMap.erase(unit);
+	info.mineral = nullptr;
+	info.depot = nullptr;
+	info.refinery = nullptr;
+	info.repair = nullptr;
+	info.moveData = WorkerMoveData();
+	info.buildingType = BWAPI::UnitTypes::None;
+
+	unlinkJob(slot);
+	linkJob(slot, Default);
 }
 
 int WorkerData::getNumWorkers() const
 {
-	return m_workers.size();
+	return (int)(m_workerTable.size() - m_freeSlots.size());
 }
 
 int WorkerData::getNumMineralWorkers() const
 {
-	size_t num = 0;
-	for (auto &unit : m_workers)
-	{
-		if (m_workerJobMap.at(unit) == WorkerData::Minerals)
-		{
-			num++;
-		}
-	}
-	return num;
+	return m_jobCount[Minerals];
 }
 
 int WorkerData::getNumGasWorkers() const
 {
-	size_t num = 0;
-	for (auto &unit : m_workers)
-	{
-		if (m_workerJobMap.at(unit) == WorkerData::Gas)
-		{
-			num++;
-		}
-	}
-	return num;
+	return m_jobCount[Gas];
 }
 
 int WorkerData::getNumIdleWorkers() const
 {
-	size_t num = 0;
-	for (auto &unit : m_workers)
-	{
-		if (m_workerJobMap.at(unit) == WorkerData::Idle)
-		{
-			num++;
-		}
-	}
-	return num;
+	return m_jobCount[Idle];
 }
 
 enum WorkerData::WorkerJob WorkerData::getWorkerJob(BWAPI::Unit unit)
 {
-	if (!unit)
-	{
-		return Default;
-	}
-
-	std::map<BWAPI::Unit, enum WorkerJob>::iterator it = m_workerJobMap.find(unit);
-
-	if (it != m_workerJobMap.end())
-	{
-		return it->second;
-	}
-
-	return Default;
+	const int slot = getSlot(unit);
+	return slot != -1 ? m_workerTable[slot].job : Default;
 }
 
 bool WorkerData::depotIsFull(BWAPI::Unit depot)
@@ -377,30 +436,20 @@ int WorkerData::getMineralsNearDepot(BWAPI::Unit depot)
 
 BWAPI::Unit WorkerData::getWorkerResource(BWAPI::Unit unit)
 {
-	if (!unit)
+	const int slot = getSlot(unit);
+	if (slot == -1)
 	{
 		return nullptr;
 	}
 
-	// create the iterator
-	std::map<BWAPI::Unit, BWAPI::Unit>::iterator it;
-
-	// if the worker is mining, set the iterator to the mineral map
-	if (getWorkerJob(unit) == Minerals)
+	// the mineral patch or refinery the worker is harvesting from
+	if (m_workerTable[slot].job == Minerals)
 	{
-		it = m_workerMineralMap.find(unit);
-		if (it != m_workerMineralMap.end())
-		{
-			return it->second;
-		}
+		return m_workerTable[slot].mineral;
 	}
-	else if (getWorkerJob(unit) == Gas)
+	else if (m_workerTable[slot].job == Gas)
 	{
-		it = m_workerRefineryMap.find(unit);
-		if (it != m_workerRefineryMap.end())
-		{
-			return it->second;
-		}
+		return m_workerTable[slot].refinery;
 	}
 
 	return nullptr;
@@ -426,7 +475,7 @@ BWAPI::Unit WorkerData::getMineralToMine(BWAPI::Unit worker)
 		for (auto &mineral : mineralPatches)
 		{
 			double dist = mineral->getDistance(depot);
-			double numAssigned = m_workersOnMineralPatch[mineral];
+			double numAssigned = mineral->getID() < (int)m_assignedWorkers.size() ? m_assignedWorkers[mineral->getID()] : 0;
 
 			if (numAssigned < bestNumAssigned)
 			{
@@ -480,102 +529,45 @@ BWAPI::Unit WorkerData::getMineralToMine(BWAPI::Unit worker)
 
 BWAPI::Unit WorkerData::getWorkerRepairUnit(BWAPI::Unit unit)
 {
-	if (!unit)
-	{
-		return nullptr;
-	}
-
-	std::map<BWAPI::Unit, BWAPI::Unit>::iterator it = m_workerRepairMap.find(unit);
-
-	if (it != m_workerRepairMap.end())
-	{
-		return it->second;
-	}
-
-	return nullptr;
+	const int slot = getSlot(unit);
+	return slot != -1 ? m_workerTable[slot].repair : nullptr;
 }
 
 BWAPI::Unit WorkerData::getWorkerDepot(BWAPI::Unit unit)
 {
-	if (!unit)
-	{
-		return nullptr;
-	}
-
-	std::map<BWAPI::Unit, BWAPI::Unit>::iterator it = m_workerDepotMap.find(unit);
-
-	if (it != m_workerDepotMap.end())
-	{
-		return it->second;
-	}
-
-	return nullptr;
+	const int slot = getSlot(unit);
+	return slot != -1 ? m_workerTable[slot].depot : nullptr;
 }
 
 BWAPI::UnitType WorkerData::getWorkerBuildingType(BWAPI::Unit unit)
 {
-	if (!unit)
-	{
-		return BWAPI::UnitTypes::None;
-	}
-
-	std::map<BWAPI::Unit, BWAPI::UnitType>::iterator it = m_workerBuildingTypeMap.find(unit);
-
-	if (it != m_workerBuildingTypeMap.end())
-	{
-		return it->second;
-	}
-
-	return BWAPI::UnitTypes::None;
+	const int slot = getSlot(unit);
+	return slot != -1 ? m_workerTable[slot].buildingType : BWAPI::UnitTypes::None;
 }
 
 WorkerMoveData WorkerData::getWorkerMoveData(BWAPI::Unit unit)
 {
-	std::map<BWAPI::Unit, WorkerMoveData>::iterator it = m_workerMoveMap.find(unit);
+	const int slot = getSlot(unit);
 
-	assert(it != m_workerMoveMap.end());
+	assert(slot != -1 && m_workerTable[slot].job == Move);
 
-	return (it->second);
+	return m_workerTable[slot].moveData;
 }
 
 int WorkerData::getNumAssignedWorkers(BWAPI::Unit unit)
 {
-	if (!unit)
+	if (!unit || unit->getID() < 0 || unit->getID() >= (int)m_assignedWorkers.size())
 	{
 		return 0;
 	}
 
-	std::map<BWAPI::Unit, int>::iterator it;
-
-	// if the worker is mining, set the iterator to the mineral map
-	if (unit->getType().isResourceDepot())
+	// only depots and refineries have workers assigned to them, the mineral patch counts are private
+	if (!unit->getType().isResourceDepot() && !unit->getType().isRefinery())
 	{
-		it = m_depotWorkerCount.find(unit);
-
-		// if there is an entry, return it
-		if (it != m_depotWorkerCount.end())
-		{
-			return it->second;
-		}
-	}
-	else if (unit->getType().isRefinery())
-	{
-		it = m_refineryWorkerCount.find(unit);
-
-		// if there is an entry, return it
-		if (it != m_refineryWorkerCount.end())
-		{
-			return it->second;
-		}
-		// otherwise, we are only calling this on completed refineries, so set it
-		else
-		{
-			m_refineryWorkerCount[unit] = 0;
-		}
+		return 0;
 	}
 
-	// when all else fails, return 0
-	return 0;
+	return m_assignedWorkers[unit->getID()];
 }
 
 char WorkerData::getJobCode(BWAPI::Unit unit)
@@ -627,7 +619,7 @@ void WorkerData::drawDepotDebugInfo()
 			int x = mineral->getPosition().x;
 			int y = mineral->getPosition().y;
 
-			if (m_workersOnMineralPatch.find(mineral) != m_workersOnMineralPatch.end())
+			if (mineral->getID() < (int)m_assignedWorkers.size())
 			{
 				//if (Config::Debug::DRAW_UALBERTABOT_DEBUG) BWAPI::Broodwar->drawBoxMap(x-2, y-1, x+75, y+14, BWAPI::Colors::Black, true);
 				//if (Config::Debug::DRAW_UALBERTABOT_DEBUG) BWAPI::Broodwar->drawTextMap(x, y, "\x04 Workers: %d", workersOnMineralPatch[mineral]);
@@ -636,7 +628,12 @@ void WorkerData::drawDepotDebugInfo()
 	}
 }
 
-const BWAPI::Unitset &WorkerData::getWorkers() const
+const std::vector<WorkerData::WorkerInfo> &WorkerData::getWorkerTable() const
+{
+	return m_workerTable;
+}
+
+int WorkerData::getFirstWorkerSlot(enum WorkerJob job) const
 {
-	return m_workers;
+	return m_jobHead[job];
 }
\ No newline at end of file
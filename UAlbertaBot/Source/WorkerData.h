@@ -36,22 +36,41 @@ namespace UAlbertaBot
 			Default
 		};
 
+		static const int NumJobs = Default + 1;
+
+		// everything we know about one worker, a slot in the worker table. slots of destroyed
+		// workers are reused, their unit is null until then
+		class WorkerInfo
+		{
+		public:
+			BWAPI::Unit unit = nullptr;
+			WorkerJob job = Default;
+			BWAPI::Unit mineral = nullptr;		// the patch a mineral worker was sent to
+			BWAPI::Unit depot = nullptr;
+			BWAPI::Unit refinery = nullptr;
+			BWAPI::Unit repair = nullptr;
+			WorkerMoveData moveData;
+			BWAPI::UnitType buildingType = BWAPI::UnitTypes::None;
+
+			// the workers with the same job are a doubly linked list through their slots
+			int prevSameJob = -1;
+			int nextSameJob = -1;
+		};
+
 	private:
-		BWAPI::Unitset m_workers;
 		BWAPI::Unitset m_depots;
 
-		std::map<BWAPI::Unit, enum WorkerJob> m_workerJobMap;
-		std::map<BWAPI::Unit, BWAPI::Unit> m_workerMineralMap;
-		std::map<BWAPI::Unit, BWAPI::Unit> m_workerDepotMap;
-		std::map<BWAPI::Unit, BWAPI::Unit> m_workerRefineryMap;
-		std::map<BWAPI::Unit, BWAPI::Unit> m_workerRepairMap;
-		std::map<BWAPI::Unit, WorkerMoveData> m_workerMoveMap;
-		std::map<BWAPI::Unit, BWAPI::UnitType> m_workerBuildingTypeMap;
+		std::vector<WorkerInfo> m_workerTable;
+		std::vector<int> m_freeSlots;
+		std::vector<int> m_slotOfUnit;			// by unit ID, -1 if the unit isn't one of our workers
+		std::vector<int> m_assignedWorkers;		// by unit ID, workers on a depot, refinery or mineral patch
+		int m_jobHead[NumJobs];
+		int m_jobCount[NumJobs];
 
-		std::map<BWAPI::Unit, int> m_depotWorkerCount;
-		std::map<BWAPI::Unit, int> m_refineryWorkerCount;
-		std::map<BWAPI::Unit, int> m_workersOnMineralPatch;
-		std::map<BWAPI::Unit, BWAPI::Unit> m_workerMineralAssignment;
+		int getSlot(BWAPI::Unit unit) const;
+		int addSlot(BWAPI::Unit unit);
+		void linkJob(int slot, WorkerJob job);
+		void unlinkJob(int slot);
 
 		void clearPreviousJob(BWAPI::Unit unit);
 
@@ -64,7 +83,7 @@ namespace UAlbertaBot
 		void addWorker(BWAPI::Unit unit);
 		void addWorker(BWAPI::Unit unit, WorkerJob job, BWAPI::Unit jobUnit);
 		void addWorker(BWAPI::Unit unit, enum WorkerJob job, BWAPI::UnitType jobUnitType);
-		void addToMineralPatch(BWAPI::Unit unit, int num);
+		void addAssignedWorkers(BWAPI::Unit unit, int num);
 		void drawDepotDebugInfo();
 		void setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, BWAPI::Unit jobUnit);
 		void setWorkerJob(BWAPI::Unit unit, enum WorkerJob job, BWAPI::UnitType jobUnitType);
@@ -88,6 +107,10 @@ namespace UAlbertaBot
 		WorkerMoveData getWorkerMoveData(BWAPI::Unit unit);
 		BWAPI::Unitset getMineralPatchesNearDepot(BWAPI::Unit depot);
 
-		const BWAPI::Unitset &getWorkers() const;
+		// the dense table of every worker, which the per frame update walks in a single pass
+		const std::vector<WorkerInfo> &getWorkerTable() const;
+
+		// the slot of the first worker with the job, -1 if there is none. the rest follow through nextSameJob
+		int getFirstWorkerSlot(enum WorkerJob job) const;
 	};
 }
\ No newline at end of file
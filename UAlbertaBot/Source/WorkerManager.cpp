@@ -17,9 +17,6 @@ void WorkerManager::onFrame()
 
 	updateWorkerStatus();
 	handleGasWorkers();
-	handleIdleWorkers();
-	handleMoveWorkers();
-	handleCombatWorkers();
 
 	drawResourceDebugInfo();
 	drawWorkerInformation(450, 20);
@@ -29,31 +26,36 @@ void WorkerManager::onFrame()
 	handleRepairWorkers();
 }
 
+// a single pass over the worker table which updates every worker's job and gives the idle, move
+// and combat workers their orders
 void WorkerManager::updateWorkerStatus()
 {
 	PROFILE_FUNCTION();
 
-	// for each of our Workers
-	for (auto &worker : m_workerData.getWorkers())
+	const std::vector<WorkerData::WorkerInfo> &workers = m_workerData.getWorkerTable();
+
+	// jobs change during the pass but workers keep their slots, so the table can be walked by index
+	for (size_t slot = 0; slot < workers.size(); ++slot)
 	{
-		if (!worker->isCompleted())
+		const BWAPI::Unit worker = workers[slot].unit;
+		if (!worker)
 		{
 			continue;
 		}
 
 		// if it's idle
-		if (worker->isIdle() &&
-			(m_workerData.getWorkerJob(worker) != WorkerData::Build) &&
-			(m_workerData.getWorkerJob(worker) != WorkerData::Move) &&
-			(m_workerData.getWorkerJob(worker) != WorkerData::Scout))
+		if (worker->isCompleted() && worker->isIdle() &&
+			(workers[slot].job != WorkerData::Build) &&
+			(workers[slot].job != WorkerData::Move) &&
+			(workers[slot].job != WorkerData::Scout))
 		{
 			m_workerData.setWorkerJob(worker, WorkerData::Idle, nullptr);
 		}
 
 		// if its job is gas
-		if (m_workerData.getWorkerJob(worker) == WorkerData::Gas)
+		if (worker->isCompleted() && workers[slot].job == WorkerData::Gas)
 		{
-			const BWAPI::Unit refinery = m_workerData.getWorkerResource(worker);
+			const BWAPI::Unit refinery = workers[slot].refinery;
 
 			// if the refinery doesn't exist anymore
 			if (!refinery || !refinery->exists() || refinery->getHitPoints() <= 0)
@@ -61,6 +63,27 @@ void WorkerManager::updateWorkerStatus()
 				setMineralWorker(worker);
 			}
 		}
+
+		if (workers[slot].job == WorkerData::Idle)
+		{
+			// send it to the nearest mineral patch
+			setMineralWorker(worker);
+		}
+		else if (workers[slot].job == WorkerData::Move)
+		{
+			Micro::SmartMove(worker, workers[slot].moveData.position);
+		}
+		else if (workers[slot].job == WorkerData::Combat)
+		{
+			// bad micro for combat workers
+			BWAPI::Broodwar->drawCircleMap(worker->getPosition().x, worker->getPosition().y, 4, BWAPI::Colors::Yellow, true);
+			const BWAPI::Unit target = getClosestEnemyUnit(worker);
+
+			if (target)
+			{
+				Micro::SmartAttackUnit(worker, target);
+			}
+		}
 	}
 }
 
@@ -122,22 +145,6 @@ bool WorkerManager::isGasStealRefinery(BWAPI::Unit unit)
 	return false;
 }
 
-void WorkerManager::handleIdleWorkers()
-{
-	// for each of our workers
-	for (auto &worker : m_workerData.getWorkers())
-	{
-		UAB_ASSERT(worker != nullptr, "Worker was null");
-
-		// if it is idle
-		if (m_workerData.getWorkerJob(worker) == WorkerData::Idle)
-		{
-			// send it to the nearest mineral patch
-			setMineralWorker(worker);
-		}
-	}
-}
-
 void WorkerManager::handleRepairWorkers()
 {
 	if (BWAPI::Broodwar->self()->getRace() != BWAPI::Races::Terran)
@@ -156,26 +163,6 @@ void WorkerManager::handleRepairWorkers()
 	}
 }
 
-// bad micro for combat workers
-void WorkerManager::handleCombatWorkers()
-{
-	for (auto &worker : m_workerData.getWorkers())
-	{
-		UAB_ASSERT(worker != nullptr, "Worker was null");
-
-		if (m_workerData.getWorkerJob(worker) == WorkerData::Combat)
-		{
-			BWAPI::Broodwar->drawCircleMap(worker->getPosition().x, worker->getPosition().y, 4, BWAPI::Colors::Yellow, true);
-			const BWAPI::Unit target = getClosestEnemyUnit(worker);
-
-			if (target)
-			{
-				Micro::SmartAttackUnit(worker, target);
-			}
-		}
-	}
-}
-
 BWAPI::Unit WorkerManager::getClosestEnemyUnit(BWAPI::Unit worker)
 {
 	UAB_ASSERT(worker != nullptr, "Worker was null");
@@ -199,14 +186,14 @@ BWAPI::Unit WorkerManager::getClosestEnemyUnit(BWAPI::Unit worker)
 
 void WorkerManager::finishedWithCombatWorkers()
 {
-	for (auto &worker : m_workerData.getWorkers())
-	{
-		UAB_ASSERT(worker != nullptr, "Worker was null");
+	const std::vector<WorkerData::WorkerInfo> &workers = m_workerData.getWorkerTable();
 
-		if (m_workerData.getWorkerJob(worker) == WorkerData::Combat)
-		{
-			setMineralWorker(worker);
-		}
+	// the next worker is read first since changing the job moves the worker to another list
+	for (int slot = m_workerData.getFirstWorkerSlot(WorkerData::Combat); slot != -1;)
+	{
+		const int next = workers[slot].nextSameJob;
+		setMineralWorker(workers[slot].unit);
+		slot = next;
 	}
 }
 
@@ -225,24 +212,20 @@ BWAPI::Unit WorkerManager::getClosestMineralWorkerTo(BWAPI::Unit enemyUnit)
 		}
 	}
 
-	// for each of our workers
-	for (auto &worker : m_workerData.getWorkers())
+	const std::vector<WorkerData::WorkerInfo> &workers = m_workerData.getWorkerTable();
+
+	// for each of our mineral workers
+	for (int slot = m_workerData.getFirstWorkerSlot(WorkerData::Minerals); slot != -1; slot = workers[slot].nextSameJob)
 	{
+		const BWAPI::Unit worker = workers[slot].unit;
 		UAB_ASSERT(worker != nullptr, "Worker was null");
-		if (!worker)
-		{
-			continue;
-		}
-		// if it is a move worker
-		if (m_workerData.getWorkerJob(worker) == WorkerData::Minerals)
-		{
-			double dist = worker->getDistance(enemyUnit);
 
-			if (!closestMineralWorker || dist < closestDist)
-			{
-				closestMineralWorker = worker;
-				closestDist = dist;
-			}
+		double dist = worker->getDistance(enemyUnit);
+
+		if (!closestMineralWorker || dist < closestDist)
+		{
+			closestMineralWorker = worker;
+			closestDist = dist;
 		}
 	}
 
@@ -252,39 +235,9 @@ BWAPI::Unit WorkerManager::getClosestMineralWorkerTo(BWAPI::Unit enemyUnit)
 
 BWAPI::Unit WorkerManager::getWorkerScout()
 {
-	// for each of our workers
-	for (auto &worker : m_workerData.getWorkers())
-	{
-		UAB_ASSERT(worker != nullptr, "Worker was null");
-		if (!worker)
-		{
-			continue;
-		}
-		// if it is a move worker
-		if (m_workerData.getWorkerJob(worker) == WorkerData::Scout)
-		{
-			return worker;
-		}
-	}
+	const int slot = m_workerData.getFirstWorkerSlot(WorkerData::Scout);
 
-	return nullptr;
-}
-
-void WorkerManager::handleMoveWorkers()
-{
-	// for each of our workers
-	for (auto &worker : m_workerData.getWorkers())
-	{
-		UAB_ASSERT(worker != nullptr, "Worker was null");
-
-		// if it is a move worker
-		if (m_workerData.getWorkerJob(worker) == WorkerData::Move)
-		{
-			const WorkerMoveData data = m_workerData.getWorkerMoveData(worker);
-
-			Micro::SmartMove(worker, data.position);
-		}
-	}
+	return slot != -1 ? m_workerData.getWorkerTable()[slot].unit : nullptr;
 }
 
 // set a worker to mine minerals
@@ -351,18 +304,18 @@ BWAPI::Unit WorkerManager::getGasWorker(BWAPI::Unit refinery)
 	BWAPI::Unit closestWorker = nullptr;
 	double closestDistance = 0;
 
-	for (auto &unit : m_workerData.getWorkers())
+	const std::vector<WorkerData::WorkerInfo> &workers = m_workerData.getWorkerTable();
+
+	for (int slot = m_workerData.getFirstWorkerSlot(WorkerData::Minerals); slot != -1; slot = workers[slot].nextSameJob)
 	{
+		const BWAPI::Unit unit = workers[slot].unit;
 		UAB_ASSERT(unit != nullptr, "Unit was null");
 
-		if (m_workerData.getWorkerJob(unit) == WorkerData::Minerals)
+		const double distance = unit->getDistance(refinery);
+		if (!closestWorker || distance < closestDistance)
 		{
-			const double distance = unit->getDistance(refinery);
-			if (!closestWorker || distance < closestDistance)
-			{
-				closestWorker = unit;
-				closestDistance = distance;
-			}
+			closestWorker = unit;
+			closestDistance = distance;
 		}
 	}
 
@@ -381,54 +334,26 @@ void WorkerManager::setBuildingWorker(BWAPI::Unit worker, Building &b)
 // set 'setJobAsBuilder' to false if we just want to see which worker will build a building
 BWAPI::Unit WorkerManager::getBuilder(Building &b, bool setJobAsBuilder)
 {
-	// variables to hold the closest worker of each type to the building
-	BWAPI::Unit closestMovingWorker = nullptr;
-	BWAPI::Unit closestMiningWorker = nullptr;
-	double closestMovingWorkerDistance = 0;
-	double closestMiningWorkerDistance = 0;
+	const std::vector<WorkerData::WorkerInfo> &workers = m_workerData.getWorkerTable();
 
-	// look through each worker that had moved there first
-	for (auto &unit : m_workerData.getWorkers())
+	// gas steal building uses scout worker
+	const int scoutSlot = m_workerData.getFirstWorkerSlot(WorkerData::Scout);
+	if (b.isGasSteal && scoutSlot != -1)
 	{
-		UAB_ASSERT(unit != nullptr, "Unit was null");
-
-		// gas steal building uses scout worker
-		if (b.isGasSteal && (m_workerData.getWorkerJob(unit) == WorkerData::Scout))
-		{
-			if (setJobAsBuilder)
-			{
-				m_workerData.setWorkerJob(unit, WorkerData::Build, b.type);
-			}
-			return unit;
-		}
-
-		// mining worker check
-		if (unit->isCompleted() && (m_workerData.getWorkerJob(unit) == WorkerData::Minerals))
-		{
-			// if it is a new closest distance, set the pointer
-			const double distance = unit->getDistance(BWAPI::Position(b.finalPosition));
-			if (!closestMiningWorker || distance < closestMiningWorkerDistance)
-			{
-				closestMiningWorker = unit;
-				closestMiningWorkerDistance = distance;
-			}
-		}
-
-		// moving worker check
-		if (unit->isCompleted() && (m_workerData.getWorkerJob(unit) == WorkerData::Move))
+		const BWAPI::Unit scout = workers[scoutSlot].unit;
+		if (setJobAsBuilder)
 		{
-			// if it is a new closest distance, set the pointer
-			const double distance = unit->getDistance(BWAPI::Position(b.finalPosition));
-			if (!closestMovingWorker || distance < closestMovingWorkerDistance)
-			{
-				closestMovingWorker = unit;
-				closestMovingWorkerDistance = distance;
-			}
+			m_workerData.setWorkerJob(scout, WorkerData::Build, b.type);
 		}
+		return scout;
 	}
 
-	// if we found a moving worker, use it, otherwise using a mining worker
-	BWAPI::Unit chosenWorker = closestMovingWorker ? closestMovingWorker : closestMiningWorker;
+	// if we find a moving worker use it, otherwise use a mining worker
+	BWAPI::Unit chosenWorker = getClosestWorkerTo(WorkerData::Move, BWAPI::Position(b.finalPosition));
+	if (!chosenWorker)
+	{
+		chosenWorker = getClosestWorkerTo(WorkerData::Minerals, BWAPI::Position(b.finalPosition));
+	}
 
 	// if the worker exists (one may not have been found in rare cases)
 	if (chosenWorker && setJobAsBuilder)
@@ -440,67 +365,56 @@ BWAPI::Unit WorkerManager::getBuilder(Building &b, bool setJobAsBuilder)
 	return chosenWorker;
 }
 
-// sets a worker as a scout
-void WorkerManager::setScoutWorker(BWAPI::Unit worker)
-{
-	UAB_ASSERT(worker != nullptr, "Worker was null");
-
-	m_workerData.setWorkerJob(worker, WorkerData::Scout, nullptr);
-}
-
-// gets a worker which will move to a current location
-BWAPI::Unit WorkerManager::getMoveWorker(BWAPI::Position p)
+// the closest completed worker with the job to the position, if any
+BWAPI::Unit WorkerManager::getClosestWorkerTo(WorkerData::WorkerJob job, BWAPI::Position p)
 {
-	// set up the pointer
 	BWAPI::Unit closestWorker = nullptr;
 	double closestDistance = 0;
 
-	// for each worker we currently have
-	for (auto &unit : m_workerData.getWorkers())
+	const std::vector<WorkerData::WorkerInfo> &workers = m_workerData.getWorkerTable();
+
+	for (int slot = m_workerData.getFirstWorkerSlot(job); slot != -1; slot = workers[slot].nextSameJob)
 	{
+		const BWAPI::Unit unit = workers[slot].unit;
 		UAB_ASSERT(unit != nullptr, "Unit was null");
 
-		// only consider it if it's a mineral worker
-		if (unit->isCompleted() && m_workerData.getWorkerJob(unit) == WorkerData::Minerals)
+		if (!unit->isCompleted())
 		{
-			// if it is a new closest distance, set the pointer
-			const double distance = unit->getDistance(p);
-			if (!closestWorker || distance < closestDistance)
-			{
-				closestWorker = unit;
-				closestDistance = distance;
-			}
+			continue;
+		}
+
+		// if it is a new closest distance, set the pointer
+		const double distance = unit->getDistance(p);
+		if (!closestWorker || distance < closestDistance)
+		{
+			closestWorker = unit;
+			closestDistance = distance;
 		}
 	}
 
-	// return the worker
 	return closestWorker;
 }
 
-// sets a worker to move to a given location
-void WorkerManager::setMoveWorker(int mineralsNeeded, int gasNeeded, BWAPI::Position p)
+// sets a worker as a scout
+void WorkerManager::setScoutWorker(BWAPI::Unit worker)
 {
-	// set up the pointer
-	BWAPI::Unit closestWorker = nullptr;
-	double closestDistance = 0;
+	UAB_ASSERT(worker != nullptr, "Worker was null");
 
-	// for each worker we currently have
-	for (auto &unit : m_workerData.getWorkers())
-	{
-		UAB_ASSERT(unit != nullptr, "Unit was null");
+	m_workerData.setWorkerJob(worker, WorkerData::Scout, nullptr);
+}
 
-		// only consider it if it's a mineral worker
-		if (unit->isCompleted() && m_workerData.getWorkerJob(unit) == WorkerData::Minerals)
-		{
-			// if it is a new closest distance, set the pointer
-			const double distance = unit->getDistance(p);
-			if (!closestWorker || distance < closestDistance)
-			{
-				closestWorker = unit;
-				closestDistance = distance;
-			}
-		}
-	}
+// gets a worker which will move to a current location
+BWAPI::Unit WorkerManager::getMoveWorker(BWAPI::Position p)
+{
+	// only consider mineral workers
+	return getClosestWorkerTo(WorkerData::Minerals, p);
+}
+
+// sets a worker to move to a given location
+void WorkerManager::setMoveWorker(int mineralsNeeded, int gasNeeded, BWAPI::Position p)
+{
+	// only consider mineral workers
+	BWAPI::Unit closestWorker = getClosestWorkerTo(WorkerData::Minerals, p);
 
 	if (closestWorker)
 	{
@@ -590,19 +504,20 @@ void WorkerManager::onUnitShow(BWAPI::Unit unit)
 	}
 }
 
+// only mineral workers are rebalanced. the old loop skipped the others with !job == Minerals, which
+// only worked because Minerals is 0, so builders, scouts and gas workers must never be idled here
 void WorkerManager::rebalanceWorkers()
 {
-	// for each worker
-	for (auto &worker : m_workerData.getWorkers())
+	const std::vector<WorkerData::WorkerInfo> &workers = m_workerData.getWorkerTable();
+
+	// for each mineral worker, the next one is read first since going idle moves the worker to another list
+	for (int slot = m_workerData.getFirstWorkerSlot(WorkerData::Minerals); slot != -1;)
 	{
+		const int next = workers[slot].nextSameJob;
+		const BWAPI::Unit worker = workers[slot].unit;
 		UAB_ASSERT(worker != nullptr, "Worker was null");
 
-		if (!m_workerData.getWorkerJob(worker) == WorkerData::Minerals)
-		{
-			continue;
-		}
-
-		BWAPI::Unit depot = m_workerData.getWorkerDepot(worker);
+		BWAPI::Unit depot = workers[slot].depot;
 
 		if (depot && m_workerData.depotIsFull(depot))
 		{
@@ -612,6 +527,8 @@ void WorkerManager::rebalanceWorkers()
 		{
 			m_workerData.setWorkerJob(worker, WorkerData::Idle, nullptr);
 		}
+
+		slot = next;
 	}
 }
 
@@ -642,9 +559,13 @@ void WorkerManager::drawResourceDebugInfo()
 		return;
 	}
 
-	for (auto &worker : m_workerData.getWorkers())
+	for (auto &info : m_workerData.getWorkerTable())
 	{
-		UAB_ASSERT(worker != nullptr, "Worker was null");
+		const BWAPI::Unit worker = info.unit;
+		if (!worker)
+		{
+			continue;
+		}
 
 		const char job = m_workerData.getJobCode(worker);
 
@@ -654,7 +575,7 @@ void WorkerManager::drawResourceDebugInfo()
 
 		BWAPI::Broodwar->drawLineMap(worker->getPosition().x, worker->getPosition().y, pos.x, pos.y, BWAPI::Colors::Cyan);
 
-		const BWAPI::Unit depot = m_workerData.getWorkerDepot(worker);
+		const BWAPI::Unit depot = info.depot;
 		if (depot)
 		{
 			BWAPI::Broodwar->drawLineMap(worker->getPosition().x, worker->getPosition().y, depot->getPosition().x, depot->getPosition().y, BWAPI::Colors::Orange);
@@ -675,9 +596,13 @@ void WorkerManager::drawWorkerInformation(int x, int y)
 
 	int yspace = 0;
 
-	for (auto &unit : m_workerData.getWorkers())
+	for (auto &info : m_workerData.getWorkerTable())
 	{
-		UAB_ASSERT(unit != nullptr, "Worker was null");
+		const BWAPI::Unit unit = info.unit;
+		if (!unit)
+		{
+			continue;
+		}
 
 		BWAPI::Broodwar->drawTextScreen(x, y + 40 + ((yspace)*10), "\x03 %d", unit->getID());
 		BWAPI::Broodwar->drawTextScreen(x + 50, y + 40 + ((yspace++) * 10), "\x03 %c", m_workerData.getJobCode(unit));
@@ -17,10 +17,7 @@ namespace UAlbertaBot
 		void setMineralWorker(BWAPI::Unit unit);
 		bool isGasStealRefinery(BWAPI::Unit unit);
 
-		void handleIdleWorkers();
 		void handleGasWorkers();
-		void handleMoveWorkers();
-		void handleCombatWorkers();
 		void handleRepairWorkers();
 
 		WorkerManager();
@@ -51,6 +48,7 @@ namespace UAlbertaBot
 		BWAPI::Unit getGasWorker(BWAPI::Unit refinery);
 		BWAPI::Unit getClosestEnemyUnit(BWAPI::Unit worker);
 		BWAPI::Unit getClosestMineralWorkerTo(BWAPI::Unit enemyUnit);
+		BWAPI::Unit getClosestWorkerTo(WorkerData::WorkerJob job, BWAPI::Position p);
 		BWAPI::Unit getWorkerScout();
 
 		void setBuildingWorker(BWAPI::Unit worker, Building &b);
@@ -0,0 +1,266 @@
+#include "CombatDataset.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace UAlbertaBot;
+
+static_assert(sizeof(CombatDataset::FileHeader) == 16, "dataset file header layout changed");
+static_assert(sizeof(CombatDatasetBattle) == 40, "dataset battle header layout changed");
+
+namespace
+{
+	size_t Padded(size_t bytes)
+	{
+		return (bytes + 7) & ~(size_t)7;
+	}
+
+	size_t BattleBytes(size_t numUnits, size_t numSamples, size_t typeSlots)
+	{
+		return Padded(sizeof(CombatDatasetBattle) + 4 * numUnits + 4 * numSamples + 2 * typeSlots + 2 * numUnits + 2 * numUnits * numSamples);
+	}
+
+	template <class T>
+	void Append(std::vector<uint8_t> &out, const T &value)
+	{
+		const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+}
+
+CombatDatasetBattleView::CombatDatasetBattleView(const CombatDatasetBattle *battle, size_t typeSlots)
+	: m_battle(battle)
+	, m_typeSlots(typeSlots)
+{
+}
+
+const int32_t *CombatDatasetBattleView::unitIDs() const
+{
+	return reinterpret_cast<const int32_t *>(columns());
+}
+
+const int32_t *CombatDatasetBattleView::sampleFrames() const
+{
+	return unitIDs() + m_battle->numUnits;
+}
+
+const uint16_t *CombatDatasetBattleView::typeCounts() const
+{
+	return reinterpret_cast<const uint16_t *>(sampleFrames() + m_battle->numSamples);
+}
+
+const uint16_t *CombatDatasetBattleView::unitTypes() const
+{
+	return typeCounts() + m_typeSlots;
+}
+
+const int16_t *CombatDatasetBattleView::hp(size_t unit) const
+{
+	return reinterpret_cast<const int16_t *>(unitTypes() + m_battle->numUnits) + unit * m_battle->numSamples;
+}
+
+CombatDatasetView::CombatDatasetView(const uint8_t *data, size_t size)
+	: m_typeSlots(0)
+{
+	CombatDataset::FileHeader header;
+	if (size < sizeof(header))
+	{
+		return;
+	}
+
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, CombatDataset::Magic, 4) != 0 || header.version != CombatDataset::Version)
+	{
+		return;
+	}
+
+	m_typeSlots = header.typeSlots;
+
+	for (size_t offset = sizeof(header); offset + sizeof(CombatDatasetBattle) <= size;)
+	{
+		const CombatDatasetBattle *battle = reinterpret_cast<const CombatDatasetBattle *>(data + offset);
+		if (battle->bytes < sizeof(CombatDatasetBattle) || offset + battle->bytes > size
+			|| battle->bytes != BattleBytes(battle->numUnits, battle->numSamples, m_typeSlots))
+		{
+			break;
+		}
+
+		m_battles.push_back(battle);
+		offset += battle->bytes;
+	}
+}
+
+size_t CombatDatasetView::size() const
+{
+	return m_battles.size();
+}
+
+size_t CombatDatasetView::typeSlots() const
+{
+	return m_typeSlots;
+}
+
+CombatDatasetBattleView CombatDatasetView::operator [] (size_t i) const
+{
+	return CombatDatasetBattleView(m_battles[i], m_typeSlots);
+}
+
+CombatDatasetWriter::CombatDatasetWriter()
+	: m_typeSlots(0)
+	, m_closing(false)
+	, m_battles(0)
+{
+}
+
+CombatDatasetWriter::~CombatDatasetWriter()
+{
+	close();
+}
+
+void CombatDatasetWriter::open(const std::string &filename, size_t typeSlots)
+{
+	if (isOpen())
+	{
+		return;
+	}
+
+	m_filename = filename;
+	m_typeSlots = typeSlots;
+	m_closing = false;
+
+	CombatDataset::FileHeader header;
+	memcpy(header.magic, CombatDataset::Magic, 4);
+	header.version = CombatDataset::Version;
+	header.typeSlots = (uint32_t)typeSlots;
+	header.reserved = 0;
+	Append(m_pending, header);
+
+	m_thread = std::thread(&CombatDatasetWriter::writerLoop, this);
+}
+
+bool CombatDatasetWriter::isOpen() const
+{
+	return m_thread.joinable();
+}
+
+void CombatDatasetWriter::writerLoop()
+{
+	std::ofstream file(m_filename, std::ios::binary | std::ios::trunc);
+	std::vector<uint8_t> writing;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_wake.wait(lock, [this]() { return m_closing || !m_pending.empty(); });
+
+			if (m_pending.empty() && m_closing)
+			{
+				return;
+			}
+
+			writing.swap(m_pending);
+		}
+
+		file.write(reinterpret_cast<const char *>(writing.data()), writing.size());
+		file.flush();
+		writing.clear();
+	}
+}
+
+void CombatDatasetWriter::addBattle(CombatDatasetBattle battle,
+									const std::vector<int> &unitIDs,
+									const std::vector<int> &unitTypes,
+									const std::vector<int> &sampleFrames,
+									const std::vector<std::vector<int>> &hp)
+{
+	if (!isOpen())
+	{
+		return;
+	}
+
+	const size_t numUnits = std::min(unitIDs.size(), unitTypes.size());
+	const size_t numSamples = std::min(sampleFrames.size(), hp.size());
+	const size_t typeOffset = m_typeSlots / 2;
+
+	battle.numUnits = (uint16_t)numUnits;
+	battle.numSamples = (uint16_t)numSamples;
+	battle.numPlayerOneUnits = std::min(battle.numPlayerOneUnits, battle.numUnits);
+	battle.bytes = (uint32_t)BattleBytes(numUnits, numSamples, m_typeSlots);
+
+	// the battle is encoded before taking the lock, the writer thread only waits for the append
+	std::vector<uint8_t> out;
+	out.reserve(battle.bytes);
+	Append(out, battle);
+
+	for (size_t u(0); u < numUnits; ++u)
+	{
+		Append(out, (int32_t)unitIDs[u]);
+	}
+
+	for (size_t s(0); s < numSamples; ++s)
+	{
+		Append(out, (int32_t)sampleFrames[s]);
+	}
+
+	std::vector<uint16_t> typeCounts(m_typeSlots, 0);
+	for (size_t u(0); u < numUnits; ++u)
+	{
+		const size_t slot = unitTypes[u] + (u < battle.numPlayerOneUnits ? 0 : typeOffset);
+		if (unitTypes[u] >= 0 && (size_t)unitTypes[u] < typeOffset && slot < m_typeSlots)
+		{
+			typeCounts[slot]++;
+		}
+	}
+
+	for (uint16_t count : typeCounts)
+	{
+		Append(out, count);
+	}
+
+	for (size_t u(0); u < numUnits; ++u)
+	{
+		Append(out, (uint16_t)unitTypes[u]);
+	}
+
+	for (size_t u(0); u < numUnits; ++u)
+	{
+		for (size_t s(0); s < numSamples; ++s)
+		{
+			const int value = u < hp[s].size() ? hp[s][u] : 0;
+			Append(out, (int16_t)std::max(-32768, std::min(32767, value)));
+		}
+	}
+
+	out.resize(battle.bytes, 0);
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_pending.insert(m_pending.end(), out.begin(), out.end());
+		m_battles++;
+	}
+
+	m_wake.notify_one();
+}
+
+void CombatDatasetWriter::close()
+{
+	if (!isOpen())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_closing = true;
+	}
+
+	m_wake.notify_one();
+	m_thread.join();
+}
+
+size_t CombatDatasetWriter::getNumBattles() const
+{
+	return m_battles;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace UAlbertaBot
+{
+	// Battles recorded by CombatPredictor, one append-only file per game
+	//
+	// The file is a 16 byte header followed by battles. Every battle starts on an 8 byte boundary
+	// with a CombatDatasetBattle, followed by its columns:
+	//
+	//   int32  unitIDs[numUnits]
+	//   int32  sampleFrames[numSamples]				frames since the start of the battle
+	//   uint16 typeCounts[typeSlots]					units of each type at the start, ours then theirs + MAX_UNIT_TYPES
+	//   uint16 unitTypes[numUnits]						our units first, invisible dark templar are type + 13
+	//   int16  hp[numUnits][numSamples]				hp + shields, one time series per unit
+	//
+	// then padding to 8 bytes. Every value is little endian and aligned to its size, so training
+	// tools can memory map a file and read the columns in place with CombatDatasetView.
+	namespace CombatDataset
+	{
+		const char		Magic[4] = { 'U', 'A', 'B', 'C' };
+		const uint32_t	Version = 1;
+
+		struct FileHeader
+		{
+			char		magic[4];
+			uint32_t	version;
+			uint32_t	typeSlots;
+			uint32_t	reserved;
+		};
+	}
+
+	struct CombatDatasetBattle
+	{
+		uint32_t	bytes = 0;				// the whole battle, columns and padding included
+		uint32_t	id = 0;
+		int32_t		startFrame = 0;
+		int32_t		duration = 0;
+		uint16_t	numUnits = 0;
+		uint16_t	numPlayerOneUnits = 0;
+		uint16_t	numSamples = 0;
+		uint8_t		valid = 0;				// long and damaging enough to train on
+		int8_t		result = 0;				// 1 we won, -1 we lost, 0 unclear, by the LTD2 of the last sample
+		int32_t		sparcraftPrediction = 0;
+		int32_t		matlabPrediction = 0;
+		float		ltd2[2] = { 0, 0 };		// at the last sample
+	};
+
+	// a battle in a memory mapped (or loaded) dataset, nothing is copied
+	class CombatDatasetBattleView
+	{
+		const CombatDatasetBattle	*m_battle;
+		size_t						m_typeSlots;
+
+		const uint8_t *columns() const { return reinterpret_cast<const uint8_t *>(m_battle + 1); }
+
+	public:
+		CombatDatasetBattleView(const CombatDatasetBattle *battle, size_t typeSlots);
+
+		const CombatDatasetBattle &header() const { return *m_battle; }
+
+		const int32_t *unitIDs() const;
+		const int32_t *sampleFrames() const;
+		const uint16_t *typeCounts() const;
+		const uint16_t *unitTypes() const;
+		const int16_t *hp(size_t unit) const;	// numSamples values
+	};
+
+	// indexes the battles of a dataset held in memory, eg from a memory mapped file
+	class CombatDatasetView
+	{
+		std::vector<const CombatDatasetBattle *>	m_battles;
+		size_t										m_typeSlots;
+
+	public:
+		// data must stay valid and 8 byte aligned, a battle cut short at the end of the file is ignored
+		CombatDatasetView(const uint8_t *data, size_t size);
+
+		size_t size() const;
+		size_t typeSlots() const;
+		CombatDatasetBattleView operator [] (size_t i) const;
+	};
+
+	// Collects battles on the game thread and writes them from a background thread, so opening,
+	// writing and flushing the file never happens during a frame
+	class CombatDatasetWriter
+	{
+		std::string					m_filename;
+		size_t						m_typeSlots;
+		std::vector<uint8_t>		m_pending;		// encoded battles waiting for the writer thread
+		std::mutex					m_lock;
+		std::condition_variable		m_wake;
+		std::thread					m_thread;
+		bool						m_closing;
+		size_t						m_battles;
+
+		void writerLoop();
+
+	public:
+		CombatDatasetWriter();
+		~CombatDatasetWriter();
+
+		// the file is created by the writer thread
+		void open(const std::string &filename, size_t typeSlots);
+		bool isOpen() const;
+
+		// hp holds numSamples rows of numUnits values, the way Combat records them
+		void addBattle(CombatDatasetBattle battle,
+					   const std::vector<int> &unitIDs,
+					   const std::vector<int> &unitTypes,
+					   const std::vector<int> &sampleFrames,
+					   const std::vector<std::vector<int>> &hp);
+
+		// waits until every battle added so far is on disk
+		void close();
+
+		size_t getNumBattles() const;
+	};
+}
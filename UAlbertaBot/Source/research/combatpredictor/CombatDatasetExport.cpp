@@ -0,0 +1,82 @@
+// Prints the battles of CombatPredictor dataset files (bwapi-data/write/battles_*.cbd) as the
+// rows of the old train_*.txt MATLAB training file, so the existing training scripts keep working.
+// Built as its own executable together with CombatDataset.cpp.
+//
+// Usage: CombatDatasetExport datasetFile [datasetFile ...] > train.txt
+//
+// Only battles marked valid are exported, a summary of every file goes to stderr
+
+#include "CombatDataset.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace UAlbertaBot;
+
+// loads a whole file with the 8 byte alignment a memory mapping would have
+static std::vector<uint64_t> LoadFile(const std::string &filename, size_t &size)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	size = file.is_open() ? (size_t)file.tellg() : 0;
+
+	std::vector<uint64_t> data((size + 7) / 8);
+	file.seekg(0);
+	file.read(reinterpret_cast<char *>(data.data()), size);
+
+	return data;
+}
+
+// a row is the battle duration followed by type / hp pairs, padded with -1 to 150 values
+static void WriteRow(const CombatDatasetBattleView &battle, size_t sample, size_t typeOffset)
+{
+	const CombatDatasetBattle &header = battle.header();
+	int counter = 2;
+
+	std::cout << 0 << " " << header.duration << " ";
+	for (size_t u(0); u < header.numUnits; ++u, counter += 2)
+	{
+		const size_t type = battle.unitTypes()[u] + (u < header.numPlayerOneUnits ? 0 : typeOffset);
+		std::cout << type << " " << battle.hp(u)[sample] << " ";
+	}
+
+	while (counter++ < 150)
+	{
+		std::cout << -1 << " ";
+	}
+	std::cout << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: CombatDatasetExport datasetFile [datasetFile ...]\n";
+		return 1;
+	}
+
+	for (int a(1); a < argc; ++a)
+	{
+		size_t size = 0;
+		const std::vector<uint64_t> data = LoadFile(argv[a], size);
+		const CombatDatasetView dataset(reinterpret_cast<const uint8_t *>(data.data()), size);
+
+		size_t exported = 0;
+		for (size_t b(0); b < dataset.size(); ++b)
+		{
+			const CombatDatasetBattleView battle = dataset[b];
+			if (!battle.header().valid || battle.header().numSamples == 0)
+			{
+				continue;
+			}
+
+			// the initial conditions, then the result
+			WriteRow(battle, 0, dataset.typeSlots() / 2);
+			WriteRow(battle, battle.header().numSamples - 1, dataset.typeSlots() / 2);
+			exported++;
+		}
+
+		std::cerr << argv[a] << ": " << dataset.size() << " battles, " << exported << " exported\n";
+	}
+
+	return 0;
+}
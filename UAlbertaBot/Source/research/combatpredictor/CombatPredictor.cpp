@@ -146,9 +146,6 @@ void Combat::update()
     
 	if ((elapsedTime > 801) || forceFinish  ) //finish fight, flush to disk
     {
-		std::ostringstream oss;
-		int id = ID;  //CombatPredictor::Instance().combatID;
-
 		//I don't want extremely short fights ...
 		int total_startHP = std::accumulate(HP[0].begin(), HP[0].end(), 0);
 		int total_endHP = std::accumulate(HP.back().begin(), HP.back().end(), 0);
@@ -156,18 +153,8 @@ void Combat::update()
 		//if either 100hp damage total or 20% of inital hp
 		int difHP = std::abs(total_endHP - total_startHP);
 
-		if ((difHP < 100 && difHP*5 < total_startHP )|| bothInvisUnits)
-		{
-			//SHORT battle, don't log
-			oss << defWriteFolder << "s_battle_" << CombatPredictor::Instance().getSuffix() << "_" << id << ".txt";
-			writeToFile(oss.str(),false);
-		}
-		else
-		{
-			//PROPER battle
-			oss << defWriteFolder << "battle_" << CombatPredictor::Instance().getSuffix() << "_" << id << ".txt";
-			writeToFile(oss.str(),true);
-		}
+		//SHORT battles are kept too, but marked as not for training
+		writeToDataset(!((difHP < 100 && difHP*5 < total_startHP) || bothInvisUnits));
         finished = true;
     }
 }
@@ -211,126 +198,36 @@ void CombatPredictor::addCombat(Combat &c)
 	}
 }
 
-void Combat::writeToFile(std::string filename, bool valid4Train)
+void Combat::writeToDataset(bool valid4Train)
 {
-	//this is the debug file
-    std::ofstream logStream(filename);
-
-	logStream << "Frame: " << combatStartTime << std::endl;
-	
-	logStream << "Unit Types: ";
-	int otherPlayerIDX = 0, j = 0;
-
-	for (int i : unitTypes)
-	{
-		if (i < 0)
-		{
-			logStream << " | ";
-			otherPlayerIDX = j;
-		}
-		else
-			logStream << i << " ";
-		j++;
-	}
-	logStream << std::endl;
-	logStream << "  Unit IDs: ";
-
-	j = 0;
-	for (int i : unitIDS)
+	CombatDatasetBattle battle;
+	battle.id = ID;
+	battle.startFrame = combatStartTime;
+	battle.duration = combatTime.back();
+	battle.valid = valid4Train ? 1 : 0;
+	battle.sparcraftPrediction = SparcraftPrediction;
+	battle.matlabPrediction = MATLAB_Prediction;
+
+	//the -1 between the players isn't stored, the dataset keeps the number of our units instead
+	std::vector<int> types;
+	for (int t : unitTypes)
 	{
-		if (j == otherPlayerIDX)
-			logStream << " | " << i << " ";
+		if (t < 0)
+			battle.numPlayerOneUnits = (uint16_t)types.size();
 		else
-			logStream << i << " ";
-		j++;
+			types.push_back(t);
 	}
-	logStream << std::endl;
-	logStream << "-------------------------------" << std::endl;
-    //write frame| HPs
-    int i = 0;
 
-    for (auto h : HP)
-    {
-        logStream << combatTime[i++] << " | ";
-        for (auto u : h)
-            logStream << u << " ";
-        logStream << std::endl;
-    }
+	std::pair<float, float> ltd = LTD2();
+	battle.ltd2[0] = ltd.first;
+	battle.ltd2[1] = ltd.second;
+	if (ltd.first > ltd.second *1.1) // P1 win
+		battle.result = 1;
+	else if (ltd.second > ltd.first * 1.1) // P2 win
+		battle.result = -1;
 
-    logStream.flush();
-    logStream.close();
-
-	if (valid4Train)
-	{
-		//this is the MATLAB training file (accumulator)
-		std::ofstream trainStream(defWriteFolder + "train_" + CombatPredictor::Instance().getSuffix() + ".txt", std::ofstream::app);
-
-		int counter = 0;
-		trainStream << 0 << " " << combatTime.back() << " ";
-		counter += 2;
-
-		//write initial conditions
-		bool p1 = true;
-		for (unsigned int i = 0; i < unitTypes.size(); i++)
-		{
-			if (unitTypes[i] < 0) //switch players
-			{
-				p1 = false;
-			}
-			else
-			{
-				if (p1) trainStream << unitTypes[i] << " " << (HP[0])[i] << " ";
-				if (!p1) trainStream << unitTypes[i] + MAX_UNIT_TYPES << " " << (HP[0])[i - 1] << " ";
-				counter += 2;
-			}
-		}
-
-		//need to add -1s to keep length to 150, easier for matlab to read
-		while (counter++ < 150)
-			trainStream << -1 << " ";
-		trainStream << std::endl;
-
-
-		//write result
-		counter = 0;
-		trainStream << 0 << " " << combatTime.back() << " ";
-		counter += 2;
-
-		p1 = true;
-		for (unsigned int i = 0; i < unitTypes.size(); i++)
-		{
-			if (unitTypes[i] < 0) //switch players
-			{
-				p1 = false;
-			}
-			else
-			{
-				if (p1) trainStream << unitTypes[i] << " " << (HP.back())[i] << " ";
-				if (!p1) trainStream << unitTypes[i] + MAX_UNIT_TYPES << " " << (HP.back())[i - 1] << " ";
-				counter += 2;
-			}
-		}
-
-		//need to add -1s to keep length to 150, easier for matlab to read
-		while (counter++ < 150)
-			trainStream << -1 << " ";
-		trainStream << std::endl;
-
-		trainStream.flush();
-		trainStream.close();
-
-		//write down results to compare % acccuracy
-		std::ofstream resultStream(defWriteFolder + "results_" + CombatPredictor::Instance().getSuffix() + ".txt", std::ofstream::app);
-
-		std::pair<float, float> ltd = LTD2();
-		if (ltd.first > ltd.second *1.1) // P1 win
-			resultStream << SparcraftPrediction << " " << MATLAB_Prediction << " " << 1 << " " << ltd.first / (ltd.second + 0.01) << std::endl;
-		else if (ltd.second > ltd.first * 1.1) // P2 win
-			resultStream << SparcraftPrediction << " " << MATLAB_Prediction << " " << -1 << " " << ltd.second / (ltd.first + 0.01) << std::endl;
-
-		resultStream.flush();
-		resultStream.close();
-	}
+	//encoded here, written to disk by the dataset's own thread
+	CombatPredictor::Instance().getDataset().addBattle(battle, unitIDS, types, combatTime, HP);
 }
 
 std::pair<float, float> Combat::LTD2()
@@ -380,6 +277,16 @@ CombatPredictor::CombatPredictor() {
 
 }
 
+CombatDatasetWriter & CombatPredictor::getDataset()
+{
+	return dataset;
+}
+
+void CombatPredictor::onEnd()
+{
+	dataset.close();
+}
+
 CombatPredictor & CombatPredictor::Instance()
 {
     static CombatPredictor instance;
@@ -413,6 +320,9 @@ void CombatPredictor::initUnitList()
 	observedIDs.resize(2000, 0);
 	observedHPs.resize(2000, -1);
 
+	//every battle of the game goes to one dataset file, our unit types then theirs
+	dataset.open(defWriteFolder + "battles_" + uniqSuffix + ".cbd", 2 * MAX_UNIT_TYPES);
+
 	std::ofstream logStream(defWriteFolder +"predictorInit.txt");
 
     for (auto type : set)
@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "MapGrid.h"
 #include "HLUnitData.h"
+#include "CombatDataset.h"
 
 #ifdef USING_VISUALIZATION_LIBRARIES
 #include "Visualizer.h"
@@ -42,7 +43,7 @@ public:
 	std::vector<int> unitIDS;
     Combat(std::vector<BWAPI::UnitInterface*> & ou, std::vector<UnitInfo> &eu, bool meOBS, bool oppOBS);
     void update();
-    void writeToFile(std::string filename, bool valid4train);
+    void writeToDataset(bool valid4Train);
     bool isFinished(){ return finished; }
 	bool isOneSideDead();
 	std::pair<float, float> LTD2();
@@ -59,6 +60,7 @@ class CombatPredictor
     std::vector<int> MaxHP;
 	std::vector<int> observedIDs; 
 	std::string uniqSuffix;
+	CombatDatasetWriter dataset;
 
 public:
 	bool vsTrainedOpp = false;
@@ -69,6 +71,8 @@ public:
     static CombatPredictor & Instance();
     void initUnitList();
 	std::string getSuffix(){ return uniqSuffix; };
+	CombatDatasetWriter & getDataset();
+	void onEnd();	//waits for the battle dataset to be written, called by GameCommander::onEnd in builds defining USING_COMBAT_PREDICTOR
     const float CombatPredictor::dpf(BWAPI::UnitType &ut);
 	const SparCraft::ScoreType predictCombat(const HLUnitData &myUnits, const HLUnitData &oppUnits);
 
@@ -0,0 +1,248 @@
+// Fits the CombatEstimator Lanchester exponent and confidence band on the battles recorded by
+// CombatPredictor, either battle datasets (bwapi-data/write/battles_*.cbd) or older text battle logs
+// (battle_*.txt). Built as its own executable together with CombatEstimator.cpp, CombatSnapshot.cpp,
+// CombatDataset.cpp and the SparCraft sources. No StarCraft game is needed.
+//
+// Usage: CombatEstimatorCalibration battleFile [battleFile ...]
+//
+// Every battle is converted with the same rules the bot uses in game, the observed winner is the
+// side that kept the larger fraction of its starting HP
+
+#include "..\..\CombatEstimator.h"
+#include "..\..\CombatSnapshot.h"
+#include "..\combatpredictor\CombatDataset.h"
+#include "..\..\..\..\SparCraft\source\SparCraft.h"
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+using namespace UAlbertaBot;
+
+struct Battle
+{
+	SparCraft::GameState state;
+	int winner = 0; // 1 if we won, -1 if we lost
+};
+
+// our units then theirs, HPs in the same order, converted with the rules used in game
+static bool MakeBattle(const std::vector<int> types[2], const std::vector<int> &startHP, const std::vector<int> &endHP, Battle &battle)
+{
+	const size_t numUnits = types[0].size() + types[1].size();
+	if (types[0].empty() || types[1].empty() || startHP.size() != numUnits || endHP.size() != numUnits)
+	{
+		return false;
+	}
+
+	CombatSnapshot snapshot;
+	double start[2] = { 0, 0 };
+	double end[2] = { 0, 0 };
+
+	for (size_t p(0), i(0); p < 2; ++p)
+	{
+		for (size_t u(0); u < types[p].size(); ++u, ++i)
+		{
+			// invisible dark templar are logged as type id + 13, those battles aren't used for training either
+			if (types[p][u] < 0 || types[p][u] >= BWAPI::UnitTypes::None.getID() || types[p][u] == BWAPI::UnitTypes::Protoss_Dark_Templar.getID() + 13)
+			{
+				return false;
+			}
+
+			CombatSnapshotUnit unit;
+			unit.type = BWAPI::UnitType(types[p][u]);
+			unit.player = p == 0 ? SparCraft::Players::Player_One : SparCraft::Players::Player_Two;
+			unit.unitID = (int)i;
+			unit.hp = startHP[i];
+			snapshot.addUnit(unit);
+
+			start[p] += startHP[i];
+			end[p] += std::max(0, endHP[i]);
+		}
+	}
+
+	const double remaining[2] = { start[0] > 0 ? end[0] / start[0] : 0, start[1] > 0 ? end[1] / start[1] : 0 };
+	if (remaining[0] == remaining[1])
+	{
+		return false;
+	}
+
+	battle.state = snapshot.getSparCraftState(0);
+	battle.winner = remaining[0] > remaining[1] ? 1 : -1;
+	return true;
+}
+
+// the log stores all of our units then all of theirs, types split by a |, HPs in the same order without it
+static bool ReadBattle(const std::string &filename, Battle &battle)
+{
+	std::ifstream file(filename);
+	std::string line;
+	std::vector<int> types[2];
+	std::vector<int> startHP, endHP;
+
+	while (std::getline(file, line))
+	{
+		if (line.compare(0, 11, "Unit Types:") == 0)
+		{
+			std::stringstream ss(line.substr(11));
+			std::string token;
+			size_t player = 0;
+			while (ss >> token)
+			{
+				if (token == "|")
+				{
+					player = 1;
+				}
+				else
+				{
+					types[player].push_back(atoi(token.c_str()));
+				}
+			}
+		}
+		else if (line.find(" | ") != std::string::npos && line.compare(0, 10, "  Unit IDs") != 0)
+		{
+			std::stringstream ss(line.substr(line.find(" | ") + 3));
+			std::vector<int> hp;
+			int value;
+			while (ss >> value)
+			{
+				hp.push_back(value);
+			}
+
+			if (startHP.empty())
+			{
+				startHP = hp;
+			}
+			endHP = hp;
+		}
+	}
+
+	return MakeBattle(types, startHP, endHP, battle);
+}
+
+// every battle of a dataset file that was marked as good enough to train on
+static void ReadDataset(const std::string &filename, std::vector<Battle> &battles)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	const size_t size = file.is_open() ? (size_t)file.tellg() : 0;
+	std::vector<uint64_t> data((size + 7) / 8);
+	file.seekg(0);
+	file.read(reinterpret_cast<char *>(data.data()), size);
+
+	const CombatDatasetView dataset(reinterpret_cast<const uint8_t *>(data.data()), size);
+	for (size_t b(0); b < dataset.size(); ++b)
+	{
+		const CombatDatasetBattleView view = dataset[b];
+		const CombatDatasetBattle &header = view.header();
+		if (!header.valid || header.numSamples == 0)
+		{
+			continue;
+		}
+
+		std::vector<int> types[2];
+		std::vector<int> startHP, endHP;
+		for (size_t u(0); u < header.numUnits; ++u)
+		{
+			types[u < header.numPlayerOneUnits ? 0 : 1].push_back(view.unitTypes()[u]);
+			startHP.push_back(view.hp(u)[0]);
+			endHP.push_back(view.hp(u)[header.numSamples - 1]);
+		}
+
+		Battle battle;
+		if (MakeBattle(types, startHP, endHP, battle))
+		{
+			battles.push_back(battle);
+		}
+	}
+}
+
+static double StrengthRatio(const CombatEstimate &estimate)
+{
+	const double winner = std::max(estimate.strength[0], estimate.strength[1]);
+	const double loser = std::min(estimate.strength[0], estimate.strength[1]);
+
+	return loser > 0 ? winner / loser : std::numeric_limits<double>::max();
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: CombatEstimatorCalibration battleFile [battleFile ...]\n";
+		return 1;
+	}
+
+	SparCraft::init();
+
+	std::vector<Battle> battles;
+	for (int a(1); a < argc; ++a)
+	{
+		const std::string filename(argv[a]);
+		Battle battle;
+
+		if (filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".cbd") == 0)
+		{
+			ReadDataset(filename, battles);
+		}
+		else if (ReadBattle(filename, battle))
+		{
+			battles.push_back(battle);
+		}
+	}
+
+	std::cout << "Battles: " << battles.size() << " from " << (argc - 1) << " files\n";
+	if (battles.empty())
+	{
+		return 1;
+	}
+
+	// the exponent is fitted on every battle, the estimate's winner against the observed one
+	double bestExponent = CombatEstimator::DefaultExponent;
+	size_t bestCorrect = 0;
+
+	std::cout << std::fixed << std::setprecision(1) << "\nExponent Correct\n";
+	for (int e(10); e <= 20; ++e)
+	{
+		const CombatEstimator estimator(e / 10.0);
+		size_t correct = 0;
+
+		for (const Battle &battle : battles)
+		{
+			const CombatEstimate estimate = estimator.estimate(battle.state);
+			correct += (estimate.score > 0 ? 1 : -1) == battle.winner ? 1 : 0;
+		}
+
+		std::cout << std::setw(8) << e / 10.0 << " " << std::setw(6) << 100.0 * correct / battles.size() << "%\n";
+
+		if (correct > bestCorrect)
+		{
+			bestCorrect = correct;
+			bestExponent = e / 10.0;
+		}
+	}
+
+	// the band should be the smallest ratio whose trusted estimates are about as good as the playout
+	std::cout << "\nBand with exponent " << bestExponent << "\nBand   Skipped Correct\n";
+	const double bands[] = { 1.25, 1.5, 2.0, 3.0, 4.0 };
+	const CombatEstimator estimator(bestExponent);
+
+	for (double band : bands)
+	{
+		size_t trusted = 0;
+		size_t correct = 0;
+
+		for (const Battle &battle : battles)
+		{
+			const CombatEstimate estimate = estimator.estimate(battle.state);
+			if (StrengthRatio(estimate) >= band)
+			{
+				trusted++;
+				correct += (estimate.score > 0 ? 1 : -1) == battle.winner ? 1 : 0;
+			}
+		}
+
+		std::cout << std::setw(4) << std::setprecision(2) << band << std::setprecision(1) << " " << std::setw(8) << 100.0 * trusted / battles.size() << "% "
+				  << std::setw(6) << (trusted > 0 ? 100.0 * correct / trusted : 0) << "%\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include "CombatSimBatch.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+
+using namespace UAlbertaBot;
+
+CombatSimBatch::CombatSimBatch(const std::vector<CombatSnapshot> &snapshots)
+{
+	for (auto &snapshot : snapshots)
+	{
+		m_states.push_back(snapshot.getSparCraftState(0));
+	}
+}
+
+size_t CombatSimBatch::numStates() const
+{
+	return m_states.size();
+}
+
+CombatSimBatchResults CombatSimBatch::run(size_t repetitions, size_t numThreads) const
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	const size_t numSims = m_states.size() * repetitions;
+
+	if (numThreads == 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	CombatSimBatchResults results;
+	results.threads = numThreads;
+	results.simulations = numSims;
+	results.latencyMS.resize(numSims);
+
+	std::vector<SparCraft::ScoreType> evals(numSims, 0);
+	std::atomic<size_t> nextSim(0);
+
+	// each thread takes the next simulation until they have all been run
+	auto worker = [&]()
+	{
+		SparCraft::GameState finalState;
+		for (size_t i = nextSim++; i < numSims; i = nextSim++)
+		{
+			const auto start = Clock::now();
+			evals[i] = CombatSnapshot::PlayOut(m_states[i % m_states.size()], finalState);
+			results.latencyMS[i] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+	};
+
+	const auto batchStart = Clock::now();
+
+	std::vector<std::thread> threads;
+	for (size_t t(1); t < numThreads; ++t)
+	{
+		threads.emplace_back(worker);
+	}
+
+	worker();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	results.wallTimeMS = std::chrono::duration<double, std::milli>(Clock::now() - batchStart).count();
+
+	for (size_t i(0); i < numSims; ++i)
+	{
+		results.wins += evals[i] > 0 ? 1 : 0;
+		results.losses += evals[i] < 0 ? 1 : 0;
+		results.draws += evals[i] == 0 ? 1 : 0;
+		results.totalUnits += m_states[i % m_states.size()].numUnits(SparCraft::Players::Player_One) + m_states[i % m_states.size()].numUnits(SparCraft::Players::Player_Two);
+	}
+
+	std::sort(results.latencyMS.begin(), results.latencyMS.end());
+
+	return results;
+}
+
+double CombatSimBatchResults::simulationsPerSecond() const
+{
+	return wallTimeMS > 0 ? 1000.0 * simulations / wallTimeMS : 0;
+}
+
+double CombatSimBatchResults::latencyPercentile(double percentile) const
+{
+	if (latencyMS.empty())
+	{
+		return 0;
+	}
+
+	const size_t index = std::min(latencyMS.size() - 1, (size_t)(percentile * latencyMS.size()));
+	return latencyMS[index];
+}
+
+std::string CombatSimBatchResults::toString() const
+{
+	double mean = 0;
+	for (double latency : latencyMS)
+	{
+		mean += latency;
+	}
+
+	mean = latencyMS.empty() ? 0 : mean / latencyMS.size();
+
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(3);
+	ss << "Threads:           " << threads << "\n";
+	ss << "Simulations:       " << simulations << "\n";
+	ss << "Mean Units:        " << (simulations > 0 ? totalUnits / simulations : 0) << "\n";
+	ss << "Win / Loss / Draw: " << wins << " / " << losses << " / " << draws << "\n";
+	ss << "Wall Time:         " << wallTimeMS << " ms\n";
+	ss << "Throughput:        " << simulationsPerSecond() << " sims/s\n";
+	ss << "Latency Mean:      " << mean << " ms\n";
+	ss << "Latency p50:       " << latencyPercentile(0.50) << " ms\n";
+	ss << "Latency p90:       " << latencyPercentile(0.90) << " ms\n";
+	ss << "Latency p99:       " << latencyPercentile(0.99) << " ms\n";
+	ss << "Latency Max:       " << (latencyMS.empty() ? 0 : latencyMS.back()) << " ms\n";
+
+	return ss.str();
+}
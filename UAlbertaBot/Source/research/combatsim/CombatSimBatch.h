@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CombatSnapshot.h"
+
+namespace UAlbertaBot
+{
+	struct CombatSimBatchResults
+	{
+		size_t threads = 0;
+		size_t simulations = 0;
+		size_t wins = 0;	// eval > 0 for Player_One
+		size_t losses = 0;
+		size_t draws = 0;
+		double totalUnits = 0;
+		double wallTimeMS = 0;
+		std::vector<double> latencyMS; // sorted, one per simulation
+
+		double simulationsPerSecond() const;
+		double latencyPercentile(double percentile) const;
+		std::string toString() const;
+	};
+
+	// Runs combat simulations on recorded snapshots without a running game, split over a number of
+	// threads, the same way CombatSimulation does in game. Used to measure how many and how large
+	// simulations the bot can afford per frame.
+	class CombatSimBatch
+	{
+		std::vector<SparCraft::GameState> m_states;
+
+	public:
+		CombatSimBatch(const std::vector<CombatSnapshot> &snapshots);
+
+		size_t numStates() const;
+
+		// simulates every snapshot repetitions times, numThreads = 0 uses all cores
+		CombatSimBatchResults run(size_t repetitions, size_t numThreads) const;
+	};
+}
@@ -0,0 +1,47 @@
+// Offline combat simulation benchmark, built as its own executable together with CombatSnapshot.cpp,
+// CombatSimBatch.cpp and the SparCraft sources. No StarCraft game is needed.
+//
+// Usage: CombatSimBenchmark snapshotFile [repetitions] [threads]
+//
+// The snapshot file is written by the bot when Debug::RecordCombatSnapshots is enabled
+
+#include "CombatSimBatch.h"
+#include "..\..\..\..\SparCraft\source\SparCraft.h"
+
+#include <iostream>
+
+using namespace UAlbertaBot;
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: CombatSimBenchmark snapshotFile [repetitions] [threads]\n";
+		return 1;
+	}
+
+	const size_t repetitions = argc > 2 ? (size_t)std::max(1, atoi(argv[2])) : 10;
+	const size_t threads = argc > 3 ? (size_t)std::max(0, atoi(argv[3])) : 0;
+
+	SparCraft::init();
+
+	const std::vector<CombatSnapshot> snapshots = CombatSnapshot::ReadFile(argv[1]);
+	if (snapshots.empty())
+	{
+		std::cerr << "No combat snapshots found in " << argv[1] << "\n";
+		return 1;
+	}
+
+	CombatSimBatch batch(snapshots);
+	std::cout << "Snapshots:         " << batch.numStates() << "\n";
+
+	// a single threaded run gives the latency the bot sees in game, the parallel one the throughput
+	std::cout << "\n" << batch.run(repetitions, 1).toString();
+
+	if (threads != 1)
+	{
+		std::cout << "\n" << batch.run(repetitions, threads).toString();
+	}
+
+	return 0;
+}
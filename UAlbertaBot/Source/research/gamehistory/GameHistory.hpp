@@ -0,0 +1,153 @@
+#pragma once
+
+#include "BWAPI.h"
+#include "GameHistoryWriter.hpp"
+
+#include <cmath>
+#include <vector>
+
+class UnitFrameData
+{
+    UnitRecord m_record;
+
+    // off map positions such as Positions::None are clamped to what the format can hold
+    static uint16_t Coordinate(int value)
+    {
+        return (uint16_t)std::min(std::max(value, 0), 0xFFFF);
+    }
+
+public:
+
+    UnitFrameData(BWAPI::Unit unit)
+    {
+        const double turn = 2 * 3.14159265358979323846;
+
+        m_record.id         = (uint16_t)unit->getID();
+        m_record.player     = (uint8_t)unit->getPlayer()->getID();
+        m_record.type       = (uint8_t)unit->getType().getID();
+        m_record.hp         = (uint16_t)std::max(0, unit->getHitPoints());
+        m_record.shields    = (uint16_t)std::max(0, unit->getShields());
+        m_record.energy     = (uint8_t)std::min(std::max(0, unit->getEnergy()), 0xFF);
+        m_record.x          = Coordinate(unit->getPosition().x);
+        m_record.y          = Coordinate(unit->getPosition().y);
+        m_record.order      = (uint8_t)unit->getOrder().getID();
+        m_record.orderX     = Coordinate(unit->getOrderTargetPosition().x);
+        m_record.orderY     = Coordinate(unit->getOrderTargetPosition().y);
+        m_record.angle      = (uint8_t)((int)std::floor(unit->getAngle() / turn * 256 + 0.5) & 0xFF);
+    }
+
+    const UnitRecord & getRecord() const
+    {
+        return m_record;
+    }
+};
+
+class GameFrame
+{
+    int                         m_frame = 0;
+    std::vector<UnitRecord>     m_units;
+
+public:
+
+    GameFrame()
+        : m_frame(BWAPI::Broodwar->getFrameCount())
+    {
+        for (const BWAPI::Unit & unit : BWAPI::Broodwar->getAllUnits())
+        {
+            if (unit->getPlayer()->getID() != -1)
+            {
+                m_units.push_back(UnitFrameData(unit).getRecord());
+            }
+        }
+    }
+
+    int getFrame() const
+    {
+        return m_frame;
+    }
+
+    const std::vector<UnitRecord> & getUnits() const
+    {
+        return m_units;
+    }
+};
+
+class GameMap
+{
+    int                 m_width  = 0;
+    int                 m_height = 0;
+    std::vector<char>   m_walkable;
+
+public:
+
+    GameMap()
+        : m_width(BWAPI::Broodwar->mapWidth() * 4)
+        , m_height(BWAPI::Broodwar->mapHeight() * 4)
+        , m_walkable(BWAPI::Broodwar->mapHeight() * BWAPI::Broodwar->mapWidth() * 16, 0)
+    {
+        for (int h(0); h < m_height; ++h)
+        {
+            for (int w(0); w < m_width; ++w)
+            {
+                m_walkable[h*m_width + w] = BWAPI::Broodwar->isWalkable(w, h);
+            }
+        }
+    }
+
+    int getWidth() const
+    {
+        return m_width;
+    }
+
+    int getHeight() const
+    {
+        return m_height;
+    }
+
+    const std::vector<char> & getWalkable() const
+    {
+        return m_walkable;
+    }
+};
+
+// Records every sampled frame to a GameHistoryFormat file as the game goes, see GameHistoryReader
+class GameHistory
+{
+    GameMap             m_map;
+    GameHistoryWriter   m_writer;
+    int                 m_frameSkip = 0;
+    int                 m_lastFrame = -1;
+
+public:
+
+    GameHistory(int keyFrameInterval = 100)
+        : m_writer(keyFrameInterval)
+    {
+    }
+
+    void setFrameSkip(int frames)
+    {
+        m_frameSkip = frames;
+    }
+
+    bool open(const std::string & filename)
+    {
+        return m_writer.open(filename, m_map.getWidth(), m_map.getHeight(), m_map.getWalkable());
+    }
+
+    void onFrame()
+    {
+        if (m_lastFrame < 0 || (BWAPI::Broodwar->getFrameCount() - m_lastFrame >= m_frameSkip))
+        {
+            GameFrame frame;
+            m_writer.addFrame(frame.getFrame(), frame.getUnits());
+            m_lastFrame = frame.getFrame();
+        }
+    }
+
+    // writes the seek index, call at the end of the game
+    void close()
+    {
+        m_writer.close();
+    }
+};
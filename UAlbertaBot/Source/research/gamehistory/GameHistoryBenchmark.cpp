@@ -0,0 +1,209 @@
+// Game history recording benchmark, built as its own executable from this file alone. No StarCraft
+// game is needed, the units of a game are made up with a fixed seed.
+//
+// Usage: GameHistoryBenchmark outputFile [frames] [frameSkip] [keyFrameInterval]
+//
+// Reports bytes per recorded frame for the binary format and for the old text format, checks that
+// every frame reads back unchanged and times seeking to random frames
+
+#include "GameHistoryReader.hpp"
+#include "GameHistoryWriter.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+// a game where the army grows over time, some units move, fight, die and get replaced every frame
+class MadeUpGame
+{
+    std::mt19937                m_rng;
+    std::vector<UnitRecord>     m_units;
+    uint16_t                    m_nextID = 0;
+
+    int random(int max)
+    {
+        return (int)(m_rng() % (unsigned)max);
+    }
+
+    void addUnit()
+    {
+        UnitRecord unit;
+        unit.id         = m_nextID++;
+        unit.player     = (uint8_t)random(2);
+        unit.type       = (uint8_t)random(120);
+        unit.hp         = (uint16_t)(40 + random(200));
+        unit.shields    = (uint16_t)random(100);
+        unit.x          = (uint16_t)random(4096);
+        unit.y          = (uint16_t)random(4096);
+        unit.order      = (uint8_t)random(180);
+        unit.orderX     = unit.x;
+        unit.orderY     = unit.y;
+        m_units.push_back(unit);
+    }
+
+public:
+
+    MadeUpGame()
+        : m_rng(7)
+    {
+    }
+
+    const std::vector<UnitRecord> & step(int frame)
+    {
+        const size_t targetUnits = 20 + (size_t)frame / 100;
+        while (m_units.size() < targetUnits)
+        {
+            addUnit();
+        }
+
+        for (size_t u(0); u < m_units.size(); ++u)
+        {
+            UnitRecord & unit = m_units[u];
+            const int roll = random(100);
+
+            if (roll < 30)
+            {
+                unit.x      = (uint16_t)std::min(4095, std::max(0, unit.x + random(17) - 8));
+                unit.y      = (uint16_t)std::min(4095, std::max(0, unit.y + random(17) - 8));
+                unit.angle  = (uint8_t)(unit.angle + random(9) - 4);
+            }
+            else if (roll < 33)
+            {
+                unit.hp     = (uint16_t)std::max(0, unit.hp - random(20));
+            }
+            else if (roll < 35)
+            {
+                unit.order  = (uint8_t)random(180);
+                unit.orderX = (uint16_t)random(4096);
+                unit.orderY = (uint16_t)random(4096);
+            }
+
+            if (unit.hp == 0)
+            {
+                m_units[u] = m_units.back();
+                m_units.pop_back();
+                addUnit();
+            }
+        }
+
+        return m_units;
+    }
+};
+
+// the text format GameHistory used to write, one line per unit
+static size_t TextBytes(int frame, const std::vector<UnitRecord> & units)
+{
+    std::stringstream ss;
+    ss << "f " << frame << "\n";
+    for (const UnitRecord & unit : units)
+    {
+        ss << (int)unit.player << " " << (int)unit.type << " " << unit.id << " " << unit.hp << " " << unit.shields << " " << unit.x << " " << unit.y << " \n";
+    }
+
+    return ss.str().size();
+}
+
+static std::vector<UnitRecord> Sorted(std::vector<UnitRecord> units)
+{
+    std::sort(units.begin(), units.end(), [](const UnitRecord & a, const UnitRecord & b) { return a.id < b.id; });
+    return units;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: GameHistoryBenchmark outputFile [frames] [frameSkip] [keyFrameInterval]\n";
+        return 1;
+    }
+
+    const int frames            = argc > 2 ? std::max(1, atoi(argv[2])) : 24 * 60 * 20;
+    const int frameSkip         = argc > 3 ? std::max(1, atoi(argv[3])) : 1;
+    const int keyFrameInterval  = argc > 4 ? std::max(1, atoi(argv[4])) : 100;
+    const int width = 512, height = 512;
+
+    std::vector<char> walkable(width * height);
+    for (size_t i(0); i < walkable.size(); ++i)
+    {
+        walkable[i] = (i / 7) % 3 != 0;
+    }
+
+    // record, keeping a copy of what was recorded to check against
+    std::vector<std::vector<UnitRecord>> recorded;
+    size_t textBytes = 0;
+    MadeUpGame game;
+    GameHistoryWriter writer(keyFrameInterval);
+    if (!writer.open(argv[1], width, height, walkable))
+    {
+        std::cerr << "Couldn't open " << argv[1] << "\n";
+        return 1;
+    }
+
+    double recordMS = 0;
+    for (int f(0); f < frames; f += frameSkip)
+    {
+        const std::vector<UnitRecord> & units = game.step(f);
+        textBytes += TextBytes(f, units);
+        recorded.push_back(Sorted(units));
+
+        const auto start = std::chrono::steady_clock::now();
+        writer.addFrame(f, units);
+        recordMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    writer.close();
+
+    const GameHistoryEncoder & encoder = writer.getEncoder();
+    const size_t numFrames = recorded.size();
+    const size_t numKeys = encoder.getNumKeyFrames();
+
+    std::cout << "Frames recorded:     " << numFrames << "\n";
+    std::cout << "Units on last frame: " << recorded.back().size() << "\n";
+    std::cout << "Binary bytes/frame:  " << (double)writer.getBytesWritten() / numFrames << "\n";
+    std::cout << "  key frame bytes:   " << (numKeys > 0 ? (double)encoder.getKeyFrameBytes() / numKeys : 0) << " (" << numKeys << " key frames)\n";
+    std::cout << "  delta frame bytes: " << (numFrames > numKeys ? (double)encoder.getDeltaFrameBytes() / (numFrames - numKeys) : 0) << "\n";
+    std::cout << "Text bytes/frame:    " << (double)textBytes / numFrames << "\n";
+    std::cout << "Text / binary:       " << (double)textBytes / writer.getBytesWritten() << "\n";
+    std::cout << "Record time/frame:   " << recordMS * 1000 / numFrames << " us\n";
+
+    // read everything back in order
+    GameHistoryReader reader;
+    if (!reader.open(argv[1]))
+    {
+        std::cerr << "Couldn't read " << argv[1] << "\n";
+        return 1;
+    }
+
+    size_t mismatches = 0;
+    size_t read = 0;
+    const auto readStart = std::chrono::steady_clock::now();
+    while (reader.next())
+    {
+        mismatches += (read >= numFrames || reader.getFrame().units != recorded[read]) ? 1 : 0;
+        read++;
+    }
+    const double readMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - readStart).count();
+
+    std::cout << "Frames read back:    " << read << " (" << mismatches << " mismatched)\n";
+    std::cout << "Read time/frame:     " << readMS * 1000 / std::max((size_t)1, read) << " us\n";
+
+    // seek to random frames through the key frame index
+    std::mt19937 rng(11);
+    const int seeks = 200;
+    size_t seekMismatches = 0;
+    const auto seekStart = std::chrono::steady_clock::now();
+    for (int s(0); s < seeks; ++s)
+    {
+        const size_t index = rng() % numFrames;
+        if (!reader.seek((int)index * frameSkip) || reader.getFrame().units != recorded[index])
+        {
+            seekMismatches++;
+        }
+    }
+    const double seekMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - seekStart).count();
+
+    std::cout << "Seek time:           " << seekMS * 1000 / seeks << " us (" << seekMismatches << " mismatched, index " << (reader.hasIndex() ? "found" : "missing") << ")\n";
+    std::cout << "Walkable check:      " << (reader.isWalkable(7, 0) == (walkable[7] != 0) && reader.isWalkable(0, 0) == (walkable[0] != 0) ? "ok" : "wrong") << "\n";
+
+    return (mismatches == 0 && seekMismatches == 0 && read == numFrames) ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Binary game history format, written by GameHistoryWriter and read by GameHistoryReader
+//
+// header : "UABH", u16 version, u16 walk tile width, u16 walk tile height,
+//          walkability bitmap (1 bit per walk tile, row major, padded to a byte)
+// block  : u8 kind, u32 frame, u16 record count, records
+//          KeyFrame   - a full UnitRecord for every unit
+//          DeltaFrame - for every unit that changed since the previous frame: u16 id, u16 field mask,
+//                       then only the fields in the mask, in field order. A unit that is gone only
+//                       has the Removed bit set, a new unit has every field set
+// index  : u8 kind, u32 count, (u32 frame, u64 offset) for every key frame
+// footer : u64 offset of the index, "UABX"
+//
+// Every value is little endian. The index and footer are only written when the game ends, a file
+// from a game that crashed can still be read from the start, it just can't seek.
+
+namespace GameHistoryFormat
+{
+    const char      HeaderMagic[4]  = { 'U', 'A', 'B', 'H' };
+    const char      FooterMagic[4]  = { 'U', 'A', 'B', 'X' };
+    const uint16_t  Version         = 1;
+    const size_t    FooterBytes     = 12;
+    const size_t    BlockHeaderBytes= 7;
+
+    enum BlockKind : uint8_t
+    {
+        KeyFrame    = 1,
+        DeltaFrame  = 2,
+        Index       = 3
+    };
+
+    // fields in the order they are written, a field's bit in the delta mask is 1 << field
+    enum Field
+    {
+        Player, Type, HP, Shields, Energy, X, Y, Order, OrderX, OrderY, Angle, NumFields
+    };
+
+    const uint16_t  Removed         = 1 << 15;
+    const uint16_t  AllFields       = (1 << NumFields) - 1;
+    const size_t    FieldBytes[NumFields] = { 1, 1, 2, 2, 1, 2, 2, 1, 2, 2, 1 };
+    const size_t    RecordBytes     = 2 + 1 + 1 + 2 + 2 + 1 + 2 + 2 + 1 + 2 + 2 + 1;
+
+    inline void Put(std::vector<uint8_t> & out, uint64_t value, size_t bytes)
+    {
+        for (size_t b(0); b < bytes; ++b)
+        {
+            out.push_back((uint8_t)(value >> (8 * b)));
+        }
+    }
+
+    inline uint64_t Get(const uint8_t * data, size_t bytes)
+    {
+        uint64_t value = 0;
+        for (size_t b(0); b < bytes; ++b)
+        {
+            value |= (uint64_t)data[b] << (8 * b);
+        }
+
+        return value;
+    }
+}
+
+// one unit on one frame, every field fits the width it is written with
+struct UnitRecord
+{
+    uint16_t    id      = 0;
+    uint8_t     player  = 0;
+    uint8_t     type    = 0;
+    uint16_t    hp      = 0;
+    uint16_t    shields = 0;
+    uint8_t     energy  = 0;
+    uint16_t    x       = 0;
+    uint16_t    y       = 0;
+    uint8_t     order   = 0;
+    uint16_t    orderX  = 0;
+    uint16_t    orderY  = 0;
+    uint8_t     angle   = 0;    // 256 steps per turn
+
+    uint32_t get(int field) const
+    {
+        switch (field)
+        {
+            case GameHistoryFormat::Player:     return player;
+            case GameHistoryFormat::Type:       return type;
+            case GameHistoryFormat::HP:         return hp;
+            case GameHistoryFormat::Shields:    return shields;
+            case GameHistoryFormat::Energy:     return energy;
+            case GameHistoryFormat::X:          return x;
+            case GameHistoryFormat::Y:          return y;
+            case GameHistoryFormat::Order:      return order;
+            case GameHistoryFormat::OrderX:     return orderX;
+            case GameHistoryFormat::OrderY:     return orderY;
+            case GameHistoryFormat::Angle:      return angle;
+            default:                            return 0;
+        }
+    }
+
+    void set(int field, uint32_t value)
+    {
+        switch (field)
+        {
+            case GameHistoryFormat::Player:     player  = (uint8_t)value;  break;
+            case GameHistoryFormat::Type:       type    = (uint8_t)value;  break;
+            case GameHistoryFormat::HP:         hp      = (uint16_t)value; break;
+            case GameHistoryFormat::Shields:    shields = (uint16_t)value; break;
+            case GameHistoryFormat::Energy:     energy  = (uint8_t)value;  break;
+            case GameHistoryFormat::X:          x       = (uint16_t)value; break;
+            case GameHistoryFormat::Y:          y       = (uint16_t)value; break;
+            case GameHistoryFormat::Order:      order   = (uint8_t)value;  break;
+            case GameHistoryFormat::OrderX:     orderX  = (uint16_t)value; break;
+            case GameHistoryFormat::OrderY:     orderY  = (uint16_t)value; break;
+            case GameHistoryFormat::Angle:      angle   = (uint8_t)value;  break;
+            default:                                                       break;
+        }
+    }
+
+    // mask of the fields that differ from another record of the same unit
+    uint16_t diff(const UnitRecord & rhs) const
+    {
+        uint16_t mask = 0;
+        for (int f(0); f < GameHistoryFormat::NumFields; ++f)
+        {
+            if (get(f) != rhs.get(f))
+            {
+                mask |= 1 << f;
+            }
+        }
+
+        return mask;
+    }
+
+    bool operator == (const UnitRecord & rhs) const
+    {
+        return id == rhs.id && diff(rhs) == 0;
+    }
+};
+
+// every unit alive on a frame, sorted by id
+struct GameHistoryFrame
+{
+    int                     frame = -1;
+    std::vector<UnitRecord> units;
+};
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "GameHistoryFormat.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+// Reads a file written by GameHistoryWriter one frame at a time, keeping only the current frame
+// in memory. Doesn't depend on BWAPI so it can be used by offline tools.
+class GameHistoryReader
+{
+    std::ifstream                               m_fin;
+    int                                         m_width     = 0;
+    int                                         m_height    = 0;
+    std::vector<uint8_t>                        m_walkable;     // 1 bit per walk tile
+    std::vector<std::pair<uint32_t, uint64_t>>  m_keyFrames;    // frame, file offset, empty without a footer
+    uint64_t                                    m_dataStart = 0;
+    uint64_t                                    m_dataEnd   = 0;
+    GameHistoryFrame                            m_frame;
+
+    bool read(uint8_t * data, size_t bytes)
+    {
+        m_fin.read((char *)data, bytes);
+        return (size_t)m_fin.gcount() == bytes;
+    }
+
+    bool readValue(uint64_t & value, size_t bytes)
+    {
+        uint8_t data[8];
+        if (!read(data, bytes))
+        {
+            return false;
+        }
+
+        value = GameHistoryFormat::Get(data, bytes);
+        return true;
+    }
+
+    bool readFooter(uint64_t fileSize)
+    {
+        if (fileSize < m_dataStart + GameHistoryFormat::FooterBytes)
+        {
+            return false;
+        }
+
+        uint8_t footer[GameHistoryFormat::FooterBytes];
+        m_fin.seekg(fileSize - GameHistoryFormat::FooterBytes);
+        if (!read(footer, sizeof(footer)) || memcmp(footer + 8, GameHistoryFormat::FooterMagic, 4) != 0)
+        {
+            return false;
+        }
+
+        const uint64_t indexOffset = GameHistoryFormat::Get(footer, 8);
+        uint64_t kind = 0, count = 0;
+        m_fin.seekg(indexOffset);
+        if (!readValue(kind, 1) || kind != GameHistoryFormat::Index || !readValue(count, 4))
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> entries(count * 12);
+        if (!read(entries.data(), entries.size()))
+        {
+            return false;
+        }
+
+        for (size_t k(0); k < count; ++k)
+        {
+            m_keyFrames.push_back(std::make_pair((uint32_t)GameHistoryFormat::Get(&entries[k * 12], 4), GameHistoryFormat::Get(&entries[k * 12 + 4], 8)));
+        }
+
+        m_dataEnd = indexOffset;
+        return true;
+    }
+
+    // reads the header of the next block without consuming it
+    bool peekBlock(uint8_t & kind, uint32_t & frame)
+    {
+        const std::streampos pos = m_fin.tellg();
+        if (pos < 0 || (uint64_t)pos + GameHistoryFormat::BlockHeaderBytes > m_dataEnd)
+        {
+            return false;
+        }
+
+        uint8_t header[GameHistoryFormat::BlockHeaderBytes];
+        const bool ok = read(header, sizeof(header));
+        m_fin.clear();
+        m_fin.seekg(pos);
+
+        kind = header[0];
+        frame = (uint32_t)GameHistoryFormat::Get(header + 1, 4);
+        return ok && (kind == GameHistoryFormat::KeyFrame || kind == GameHistoryFormat::DeltaFrame);
+    }
+
+    bool readKeyFrame(size_t count)
+    {
+        std::vector<uint8_t> data(count * GameHistoryFormat::RecordBytes);
+        if (!read(data.data(), data.size()))
+        {
+            return false;
+        }
+
+        m_frame.units.resize(count);
+        const uint8_t * p = data.data();
+        for (UnitRecord & unit : m_frame.units)
+        {
+            unit.id = (uint16_t)GameHistoryFormat::Get(p, 2);
+            p += 2;
+
+            for (int f(0); f < GameHistoryFormat::NumFields; ++f)
+            {
+                unit.set(f, (uint32_t)GameHistoryFormat::Get(p, GameHistoryFormat::FieldBytes[f]));
+                p += GameHistoryFormat::FieldBytes[f];
+            }
+        }
+
+        return true;
+    }
+
+    // delta records are in id order, so they are merged into the sorted units of the previous frame
+    bool readDeltaFrame(size_t count)
+    {
+        std::vector<UnitRecord> units;
+        units.reserve(m_frame.units.size() + count);
+        size_t p = 0;
+
+        for (size_t r(0); r < count; ++r)
+        {
+            uint64_t id = 0, mask = 0;
+            if (!readValue(id, 2) || !readValue(mask, 2))
+            {
+                return false;
+            }
+
+            for (; p < m_frame.units.size() && m_frame.units[p].id < id; ++p)
+            {
+                units.push_back(m_frame.units[p]);
+            }
+
+            UnitRecord unit;
+            unit.id = (uint16_t)id;
+            if (p < m_frame.units.size() && m_frame.units[p].id == id)
+            {
+                unit = m_frame.units[p++];
+            }
+
+            if (mask & GameHistoryFormat::Removed)
+            {
+                continue;
+            }
+
+            for (int f(0); f < GameHistoryFormat::NumFields; ++f)
+            {
+                uint64_t value = 0;
+                if ((mask & (1 << f)) && !readValue(value, GameHistoryFormat::FieldBytes[f]))
+                {
+                    return false;
+                }
+
+                if (mask & (1 << f))
+                {
+                    unit.set(f, (uint32_t)value);
+                }
+            }
+
+            units.push_back(unit);
+        }
+
+        units.insert(units.end(), m_frame.units.begin() + p, m_frame.units.end());
+        m_frame.units.swap(units);
+        return true;
+    }
+
+public:
+
+    bool open(const std::string & filename)
+    {
+        m_fin.open(filename, std::ios::binary);
+        if (!m_fin.is_open())
+        {
+            return false;
+        }
+
+        m_fin.seekg(0, std::ios::end);
+        const uint64_t fileSize = (uint64_t)m_fin.tellg();
+        m_fin.seekg(0);
+
+        uint8_t header[10];
+        if (!read(header, sizeof(header)) || memcmp(header, GameHistoryFormat::HeaderMagic, 4) != 0
+            || GameHistoryFormat::Get(header + 4, 2) != GameHistoryFormat::Version)
+        {
+            return false;
+        }
+
+        m_width = (int)GameHistoryFormat::Get(header + 6, 2);
+        m_height = (int)GameHistoryFormat::Get(header + 8, 2);
+        m_walkable.resize((m_width * m_height + 7) / 8);
+        if (!read(m_walkable.data(), m_walkable.size()))
+        {
+            return false;
+        }
+
+        m_dataStart = (uint64_t)m_fin.tellg();
+        m_dataEnd = fileSize;
+
+        if (!readFooter(fileSize))
+        {
+            m_keyFrames.clear();
+            m_dataEnd = fileSize;
+        }
+
+        m_fin.clear();
+        m_fin.seekg(m_dataStart);
+        m_frame = GameHistoryFrame();
+        return true;
+    }
+
+    // moves on to the next recorded frame, false at the end of the file
+    bool next()
+    {
+        uint8_t kind = 0;
+        uint32_t frame = 0;
+        if (!peekBlock(kind, frame))
+        {
+            return false;
+        }
+
+        uint64_t count = 0;
+        m_fin.seekg(GameHistoryFormat::BlockHeaderBytes - 2, std::ios::cur);
+        if (!readValue(count, 2))
+        {
+            return false;
+        }
+
+        const bool ok = kind == GameHistoryFormat::KeyFrame ? readKeyFrame((size_t)count) : readDeltaFrame((size_t)count);
+        if (ok)
+        {
+            m_frame.frame = (int)frame;
+        }
+
+        return ok;
+    }
+
+    // makes the current frame the last recorded frame at or before the given one
+    bool seek(int frame)
+    {
+        m_fin.clear();
+        m_frame = GameHistoryFrame();
+
+        // without an index every frame has to be replayed from the start
+        auto key = std::upper_bound(m_keyFrames.begin(), m_keyFrames.end(), std::make_pair((uint32_t)frame, UINT64_MAX));
+        m_fin.seekg(key == m_keyFrames.begin() ? m_dataStart : (std::prev(key))->second);
+
+        uint8_t kind = 0;
+        uint32_t nextFrame = 0;
+        while (peekBlock(kind, nextFrame) && (int)nextFrame <= frame)
+        {
+            if (!next())
+            {
+                return false;
+            }
+        }
+
+        return m_frame.frame >= 0;
+    }
+
+    const GameHistoryFrame & getFrame() const
+    {
+        return m_frame;
+    }
+
+    bool hasIndex() const
+    {
+        return !m_keyFrames.empty();
+    }
+
+    const std::vector<std::pair<uint32_t, uint64_t>> & getKeyFrames() const
+    {
+        return m_keyFrames;
+    }
+
+    int getWidth() const
+    {
+        return m_width;
+    }
+
+    int getHeight() const
+    {
+        return m_height;
+    }
+
+    bool isWalkable(int x, int y) const
+    {
+        const size_t i = (size_t)(y * m_width + x);
+        return x >= 0 && y >= 0 && x < m_width && y < m_height && (m_walkable[i / 8] & (1 << (i % 8)));
+    }
+};
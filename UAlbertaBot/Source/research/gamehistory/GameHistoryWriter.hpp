@@ -0,0 +1,312 @@
+#pragma once
+
+#include "GameHistoryFormat.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+// Turns frames into GameHistoryFormat blocks, only keeping the previous frame in memory
+class GameHistoryEncoder
+{
+    std::vector<UnitRecord>                     m_previous;
+    std::vector<std::pair<uint32_t, uint64_t>>  m_keyFrames;    // frame, file offset
+    int                                         m_keyFrameInterval  = 100;
+    int                                         m_framesSinceKey    = 0;
+    uint64_t                                    m_offset            = 0;
+    size_t                                      m_keyBytes          = 0;
+    size_t                                      m_deltaBytes        = 0;
+
+    void writeRecord(std::vector<uint8_t> & out, const UnitRecord & unit, uint16_t mask) const
+    {
+        for (int f(0); f < GameHistoryFormat::NumFields; ++f)
+        {
+            if (mask & (1 << f))
+            {
+                GameHistoryFormat::Put(out, unit.get(f), GameHistoryFormat::FieldBytes[f]);
+            }
+        }
+    }
+
+    // the record count is only known once the records are written
+    size_t beginBlock(std::vector<uint8_t> & out, GameHistoryFormat::BlockKind kind, uint32_t frame) const
+    {
+        GameHistoryFormat::Put(out, kind, 1);
+        GameHistoryFormat::Put(out, frame, 4);
+        GameHistoryFormat::Put(out, 0, 2);
+        return out.size() - 2;
+    }
+
+    void endBlock(std::vector<uint8_t> & out, size_t countPos, size_t count) const
+    {
+        out[countPos]     = (uint8_t)count;
+        out[countPos + 1] = (uint8_t)(count >> 8);
+    }
+
+public:
+
+    // keyFrameInterval is the number of frames from one key frame to the next
+    GameHistoryEncoder(int keyFrameInterval = 100)
+        : m_keyFrameInterval(std::max(1, keyFrameInterval))
+    {
+    }
+
+    void writeHeader(std::vector<uint8_t> & out, int width, int height, const std::vector<char> & walkable)
+    {
+        const size_t start = out.size();
+
+        out.insert(out.end(), GameHistoryFormat::HeaderMagic, GameHistoryFormat::HeaderMagic + 4);
+        GameHistoryFormat::Put(out, GameHistoryFormat::Version, 2);
+        GameHistoryFormat::Put(out, width, 2);
+        GameHistoryFormat::Put(out, height, 2);
+
+        std::vector<uint8_t> bits((width * height + 7) / 8, 0);
+        for (size_t i(0); i < walkable.size() && i < (size_t)(width * height); ++i)
+        {
+            if (walkable[i])
+            {
+                bits[i / 8] |= 1 << (i % 8);
+            }
+        }
+        out.insert(out.end(), bits.begin(), bits.end());
+
+        m_offset += out.size() - start;
+    }
+
+    // units don't have to be sorted
+    void writeFrame(std::vector<uint8_t> & out, uint32_t frame, std::vector<UnitRecord> units)
+    {
+        const size_t start = out.size();
+
+        std::sort(units.begin(), units.end(), [](const UnitRecord & a, const UnitRecord & b) { return a.id < b.id; });
+
+        if (m_keyFrames.empty() || m_framesSinceKey >= m_keyFrameInterval)
+        {
+            m_keyFrames.push_back(std::make_pair(frame, m_offset));
+
+            const size_t countPos = beginBlock(out, GameHistoryFormat::KeyFrame, frame);
+            for (const UnitRecord & unit : units)
+            {
+                GameHistoryFormat::Put(out, unit.id, 2);
+                writeRecord(out, unit, GameHistoryFormat::AllFields);
+            }
+            endBlock(out, countPos, units.size());
+
+            m_framesSinceKey = 0;
+            m_keyBytes += out.size() - start;
+        }
+        else
+        {
+            // both frames are sorted by id, so changed, new and removed units come out of one merge
+            const size_t countPos = beginBlock(out, GameHistoryFormat::DeltaFrame, frame);
+            size_t count = 0;
+            size_t p = 0;
+
+            for (const UnitRecord & unit : units)
+            {
+                for (; p < m_previous.size() && m_previous[p].id < unit.id; ++p, ++count)
+                {
+                    GameHistoryFormat::Put(out, m_previous[p].id, 2);
+                    GameHistoryFormat::Put(out, GameHistoryFormat::Removed, 2);
+                }
+
+                const bool existed = p < m_previous.size() && m_previous[p].id == unit.id;
+                const uint16_t mask = existed ? unit.diff(m_previous[p]) : GameHistoryFormat::AllFields;
+                p += existed ? 1 : 0;
+
+                if (mask)
+                {
+                    GameHistoryFormat::Put(out, unit.id, 2);
+                    GameHistoryFormat::Put(out, mask, 2);
+                    writeRecord(out, unit, mask);
+                    count++;
+                }
+            }
+
+            for (; p < m_previous.size(); ++p, ++count)
+            {
+                GameHistoryFormat::Put(out, m_previous[p].id, 2);
+                GameHistoryFormat::Put(out, GameHistoryFormat::Removed, 2);
+            }
+
+            endBlock(out, countPos, count);
+
+            m_framesSinceKey++;
+            m_deltaBytes += out.size() - start;
+        }
+
+        m_offset += out.size() - start;
+        m_previous.swap(units);
+    }
+
+    void writeIndex(std::vector<uint8_t> & out)
+    {
+        const uint64_t indexOffset = m_offset;
+        const size_t start = out.size();
+
+        GameHistoryFormat::Put(out, GameHistoryFormat::Index, 1);
+        GameHistoryFormat::Put(out, m_keyFrames.size(), 4);
+        for (const auto & key : m_keyFrames)
+        {
+            GameHistoryFormat::Put(out, key.first, 4);
+            GameHistoryFormat::Put(out, key.second, 8);
+        }
+
+        GameHistoryFormat::Put(out, indexOffset, 8);
+        out.insert(out.end(), GameHistoryFormat::FooterMagic, GameHistoryFormat::FooterMagic + 4);
+
+        m_offset += out.size() - start;
+    }
+
+    uint64_t getBytes() const           { return m_offset; }
+    size_t   getKeyFrameBytes() const   { return m_keyBytes; }
+    size_t   getDeltaFrameBytes() const { return m_deltaBytes; }
+    size_t   getNumKeyFrames() const    { return m_keyFrames.size(); }
+};
+
+// Streams encoded frames to a file from a background thread, so the game thread never waits on
+// the disk and only holds the frames encoded since the last hand off
+class GameHistoryWriter
+{
+    GameHistoryEncoder                  m_encoder;
+    std::ofstream                       m_fout;
+    std::vector<uint8_t>                m_buffer;           // filled by the game thread
+    std::vector<std::vector<uint8_t>>   m_queue;            // waiting for the writer thread
+    std::mutex                          m_lock;
+    std::condition_variable             m_wake;
+    std::thread                         m_thread;
+    bool                                m_closing           = false;
+    size_t                              m_handOffBytes      = 64 * 1024;
+    std::atomic<uint64_t>               m_bytesWritten;
+
+    void handOff()
+    {
+        if (m_buffer.empty())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_queue.push_back(std::vector<uint8_t>());
+            m_queue.back().swap(m_buffer);
+        }
+
+        m_wake.notify_one();
+    }
+
+    void writerLoop()
+    {
+        std::vector<std::vector<uint8_t>> writing;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_wake.wait(lock, [this]() { return m_closing || !m_queue.empty(); });
+
+                if (m_queue.empty() && m_closing)
+                {
+                    return;
+                }
+
+                writing.swap(m_queue);
+            }
+
+            for (const auto & buffer : writing)
+            {
+                m_fout.write((const char *)buffer.data(), buffer.size());
+                m_bytesWritten += buffer.size();
+            }
+
+            m_fout.flush();
+            writing.clear();
+        }
+    }
+
+public:
+
+    GameHistoryWriter(int keyFrameInterval = 100)
+        : m_encoder(keyFrameInterval)
+        , m_bytesWritten(0)
+    {
+    }
+
+    ~GameHistoryWriter()
+    {
+        close();
+    }
+
+    bool open(const std::string & filename, int width, int height, const std::vector<char> & walkable)
+    {
+        m_fout.open(filename, std::ios::binary);
+        if (!m_fout.is_open())
+        {
+            return false;
+        }
+
+        m_encoder.writeHeader(m_buffer, width, height, walkable);
+        m_thread = std::thread(&GameHistoryWriter::writerLoop, this);
+        return true;
+    }
+
+    bool isOpen() const
+    {
+        return m_thread.joinable();
+    }
+
+    // buffered frames are handed to the writer thread once they reach this many bytes
+    void setHandOffBytes(size_t bytes)
+    {
+        m_handOffBytes = bytes;
+    }
+
+    void addFrame(int frame, const std::vector<UnitRecord> & units)
+    {
+        if (!isOpen())
+        {
+            return;
+        }
+
+        m_encoder.writeFrame(m_buffer, (uint32_t)frame, units);
+
+        if (m_buffer.size() >= m_handOffBytes)
+        {
+            handOff();
+        }
+    }
+
+    // writes the seek index and waits for everything to reach the file
+    void close()
+    {
+        if (!isOpen())
+        {
+            return;
+        }
+
+        m_encoder.writeIndex(m_buffer);
+        handOff();
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closing = true;
+        }
+
+        m_wake.notify_one();
+        m_thread.join();
+        m_fout.close();
+    }
+
+    const GameHistoryEncoder & getEncoder() const
+    {
+        return m_encoder;
+    }
+
+    uint64_t getBytesWritten() const
+    {
+        return m_bytesWritten;
+    }
+};
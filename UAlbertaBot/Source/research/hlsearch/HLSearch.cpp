@@ -1,9 +1,15 @@
 #include "HLSearch.h"
 #include "../../BOSS/source/BOSS.h"
+#include <thread>
 
 using namespace UAlbertaBot;
 
-HLSearch::HLSearch() :_tt(20000), _cache(20000), _bestMove(StrategyManager::ProtossHighLevelSearch)
+//memory the forwarded state cache may use, and the number of slots it hashes into
+const size_t HLCacheBytes = 128 * 1024 * 1024;
+const int HLCacheSlots = 20000;
+
+HLSearch::HLSearch() :_tt(20000), _cache(HLCacheBytes, HLCacheSlots), _bestMove(StrategyManager::ProtossHighLevelSearch),
+	_numThreads(std::max(1, (int)std::thread::hardware_concurrency()))
 {
 }
 
@@ -55,19 +61,25 @@ long long HLSearch::search(double timeLimit, int frameLimit, int maxHeight)
 	return _stats.getRunningTimeMilliSecs();
 }
 
+void HLSearch::setThreads(int numThreads)
+{
+	_numThreads = std::max(1, numThreads);
+}
+
+void HLSearch::updateFrameRange(int frame)
+{
+	int minFrame = _minFrame;
+	while (frame < minFrame && !_minFrame.compare_exchange_weak(minFrame, frame));
+	int maxFrame = _maxFrame;
+	while (frame > maxFrame && !_maxFrame.compare_exchange_weak(maxFrame, frame));
+}
+
 int HLSearch::alphaBeta(const HLState& state, int depth, int height, int frameLimit, int turn, const HLMove &firstSideMove, int alpha, int beta)
 {
 	_stats.incNodeCount();
 	
 	if (firstSideMove.isEmpty() && (height <=0 || state.currentFrame() >= frameLimit || state.gameOver())){
-		if (state.currentFrame() < _minFrame)
-		{
-			_minFrame = state.currentFrame();
-		}
-		if (state.currentFrame() > _maxFrame)
-		{
-			_maxFrame = state.currentFrame();
-		}
+		updateFrameRange(state.currentFrame());
 		return state.evaluate(turn);
 	}
 	if (_stats.getNodeCount() % 10 && _stats.getRunningTimeMilliSecs() > _timeLimitMs)
@@ -82,21 +94,21 @@ int HLSearch::alphaBeta(const HLState& state, int depth, int height, int frameLi
 	if (firstSideMove.isEmpty())
 	{
 		_stats.incTTquery();
-		const HLEntry &e = _tt.lookup(state);
-		if (e._hash == state.getHash())
+		auto e = _tt.lookup(state);
+		if (e && e->_hash == state.getHash())
 		{
 			_stats.incTTfound();
-			ttBest = e._bestMove;
+			ttBest = e->_bestMove;
 		}
 	}
 	else
 	{
 		_stats.incTTquery();
-		const HLEntry &e = _tt.lookup(state, depth,firstSideMove);
-		if (e._hash == state.getHash(depth, firstSideMove))
+		auto e = _tt.lookup(state, depth,firstSideMove);
+		if (e && e->_hash == state.getHash(depth, firstSideMove))
 		{
 			_stats.incTTfound();
-			ttBest = e._bestMove;
+			ttBest = e->_bestMove;
 		}
 	}
 	////todo: use value to return or at least shrink alpha-beta window?
@@ -131,61 +143,24 @@ int HLSearch::alphaBeta(const HLState& state, int depth, int height, int frameLi
 	//	return e1._value > e2._value;
 	//});
 	
-	for (auto it = moves.begin(); it != moves.end() && !_timeUp;it++){
+	if (depth == 0 && _numThreads > 1 && moves.size() > 1)
+	{
+		score = parallelRoot(state, height, frameLimit, turn, moves, alpha, beta, bestMove, i);
+	}
+	else for (auto it = moves.begin(); it != moves.end() && !_timeUp;it++){
 		auto m = *it;
 		//Logger::LogAppendToFile(UAB_LOGFILE, "Searching depth %d, move %s, move %s\n", depth, firstSideMove.toString().c_str(), m.toString().c_str());
 
 		int value;
-		if (firstSideMove.isEmpty()){
-			value = alphaBeta(state, depth + 1, height - 1, frameLimit, 1 - turn, m, -beta, -al);
+		if (!searchMove(state, depth, height, frameLimit, turn, firstSideMove, m, al, beta, value))
+		{
+			continue;
 		}
-		else{
-
-			//Logger::LogAppendToFile(UAB_LOGFILE, "Start frame: %d\n", newState.currentFrame());
-
-			std::array < HLMove, 2 > movePair;
-			if (turn == 1){
-				movePair = std::array < HLMove, 2 > { {firstSideMove, m} };
-			}
-			else{//move for player 1 first
-				movePair = std::array < HLMove, 2 > { {m, firstSideMove} };
-			}
-			//Logger::LogAppendToFile(UAB_LOGFILE, "Turn %d depth %d Checking moves: %s %s hash: %u\n", turn, depth,
-			//	firstSideMove.toString().c_str(), m.toString().c_str(), state.getHash(depth,movePair));
-			try
-			{
-				_stats.incCacheQuery();
-				const auto &entry = _cache.lookup(state, depth, movePair);
-				if (entry._hash == state.getHash(depth, movePair))//found
-				{
-					_stats.incCacheFound();
-					//Logger::LogAppendToFile(UAB_LOGFILE, "Moves "+ firstSideMove.toString() + m.toString()+" matches\n");
-					//Logger::LogAppendToFile(UAB_LOGFILE, " hashes: %u %u\n", entry._hash, entry._state.getHash());
-					if (state.currentFrame() == entry._state.currentFrame()){//didn't progress
-						//Logger::LogAppendToFile(UAB_LOGFILE, "No progress (cached)");
-						continue;
-					} 
-					value = alphaBeta(entry._state, depth + 1, height - 1, frameLimit, 1 - turn, HLMove(), -beta, -al);
-				}
-				else
-				{
-					HLState newState(state);
-					newState.applyAndForward(depth, frameLimit-newState.currentFrame(), movePair);
-					if (state.currentFrame() == newState.currentFrame()){//didn't progress
-						//Logger::LogAppendToFile(UAB_LOGFILE, "No progress");
-						continue;
-					}
-					_stats.addFwd(newState.currentFrame() - state.currentFrame());
-					_cache.store(state, depth, movePair, newState);
-					value = alphaBeta(newState, depth + 1, height - 1, frameLimit, 1 - turn, HLMove(), -beta, -al);
-				}
 
-			}
-			catch (const BOSS::Assert::BOSSException &){
-				//Logger::LogAppendToFile(UAB_LOGFILE, "No Legal build order");
-				continue;//couldn't find legal build order, skip
-			}
-			
+		//same as the parallel root, a root move cut short by the time limit isn't counted
+		if (depth == 0 && _timeUp)
+		{
+			break;
 		}
 
 		i++;
@@ -229,6 +204,123 @@ int HLSearch::alphaBeta(const HLState& state, int depth, int height, int frameLi
 	return score;
 }
 
+bool HLSearch::searchMove(const HLState& state, int depth, int height, int frameLimit, int turn, const HLMove &firstSideMove, const HLMove &m, int alpha, int beta, int &value)
+{
+	if (firstSideMove.isEmpty()){
+		value = alphaBeta(state, depth + 1, height - 1, frameLimit, 1 - turn, m, -beta, -alpha);
+	}
+	else{
+
+		//Logger::LogAppendToFile(UAB_LOGFILE, "Start frame: %d\n", newState.currentFrame());
+
+		std::array < HLMove, 2 > movePair;
+		if (turn == 1){
+			movePair = std::array < HLMove, 2 > { {firstSideMove, m} };
+		}
+		else{//move for player 1 first
+			movePair = std::array < HLMove, 2 > { {m, firstSideMove} };
+		}
+		//Logger::LogAppendToFile(UAB_LOGFILE, "Turn %d depth %d Checking moves: %s %s hash: %u\n", turn, depth,
+		//	firstSideMove.toString().c_str(), m.toString().c_str(), state.getHash(depth,movePair));
+		try
+		{
+			_stats.incCacheQuery();
+			//the child is held here, so it stays valid even if the cache evicts it during the recursion
+			std::shared_ptr<const HLState> cached = _cache.lookup(state, depth, movePair);
+			if (cached)//found
+			{
+				_stats.incCacheFound();
+				if (state.currentFrame() == cached->currentFrame()){//didn't progress
+					//Logger::LogAppendToFile(UAB_LOGFILE, "No progress (cached)");
+					return false;
+				} 
+				value = alphaBeta(*cached, depth + 1, height - 1, frameLimit, 1 - turn, HLMove(), -beta, -alpha);
+			}
+			else
+			{
+				std::shared_ptr<HLState> newState = std::make_shared<HLState>(state);
+				newState->applyAndForward(depth, frameLimit-newState->currentFrame(), movePair);
+				if (state.currentFrame() == newState->currentFrame()){//didn't progress
+					//Logger::LogAppendToFile(UAB_LOGFILE, "No progress");
+					return false;
+				}
+				_stats.addFwd(newState->currentFrame() - state.currentFrame());
+				_cache.store(state, depth, movePair, newState);
+				_stats.setCacheUsage(_cache.getBytesUsed(), _cache.getEvictions());
+				value = alphaBeta(*newState, depth + 1, height - 1, frameLimit, 1 - turn, HLMove(), -beta, -alpha);
+			}
+
+		}
+		catch (const BOSS::Assert::BOSSException &){
+			//Logger::LogAppendToFile(UAB_LOGFILE, "No Legal build order");
+			return false;//couldn't find legal build order, skip
+		}
+		
+	}
+	return true;
+}
+
+int HLSearch::parallelRoot(const HLState& state, int height, int frameLimit, int turn, const std::vector<HLMove> &moves, int alpha, int beta, HLMove &bestMove, int &searched)
+{
+	std::vector<int> values(moves.size(), MIN_SCORE);
+	std::vector<char> valid(moves.size(), false);
+
+	//a move still being searched when time ran out returned a partial value, so it isn't counted.
+	//_timeUp never goes back to false, so a move that finished before it was set is complete
+	auto searchRootMove = [&](size_t m, int al)
+	{
+		valid[m] = searchMove(state, 0, height, frameLimit, turn, HLMove(), moves[m], al, beta, values[m]) && !_timeUp;
+	};
+
+	//the first move is usually the TT move, its value gives the other threads a tight window
+	int al = alpha;
+	searchRootMove(0, al);
+	if (valid[0] && values[0] > al)
+	{
+		al = values[0];
+	}
+
+	if (al < beta && !_timeUp)
+	{
+		std::atomic<size_t> next(1);
+		auto worker = [&]()
+		{
+			for (size_t m = next++; m < moves.size() && !_timeUp; m = next++)
+			{
+				searchRootMove(m, al);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (int t = 1; t < std::min(_numThreads, (int)moves.size() - 1); t++)
+		{
+			threads.emplace_back(worker);
+		}
+		worker();
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	//combined in move order so ties are broken the same way as the serial search
+	int score = MIN_SCORE;
+	for (size_t m = 0; m < moves.size(); m++)
+	{
+		if (!valid[m])
+		{
+			continue;
+		}
+		searched++;
+		if (values[m] > score)
+		{
+			score = values[m];
+			bestMove = moves[m];
+		}
+	}
+	return score;
+}
+
 HLMove HLSearch::getBestMove()
 {
 	return _bestMove;
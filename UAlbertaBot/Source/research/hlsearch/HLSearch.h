@@ -4,6 +4,7 @@
 #include "HLState.h"
 #include "HLStatistics.h"
 #include "HLTranspositionTable.h"
+#include <atomic>
 
 namespace UAlbertaBot
 {
@@ -19,18 +20,25 @@ namespace UAlbertaBot
 
 		HLMove _bestMove;	//saved by the search
 		int alphaBeta(const HLState& state, int depth, int height, int frameLimit, int turn, const HLMove &firstSideMove, int alpha, int beta);
+		//searches one child, returns false if the move has to be skipped
+		bool searchMove(const HLState& state, int depth, int height, int frameLimit, int turn, const HLMove &firstSideMove, const HLMove &m, int alpha, int beta, int &value);
+		//the first root move is searched alone for a bound, then the rest are split between _numThreads threads
+		int parallelRoot(const HLState& state, int height, int frameLimit, int turn, const std::vector<HLMove> &moves, int alpha, int beta, HLMove &bestMove, int &searched);
+		void updateFrameRange(int frame);
 		//void uct(const HLState &state, int playouts);
 		//const int _defaultStrategy = 0;
 		HLTranspositionTable _tt;
 		HLCacheTable _cache;
-		bool _timeUp;
+		std::atomic<bool> _timeUp;
 		int _timeLimitMs;
-		int _maxFrame,_minFrame;
+		std::atomic<int> _maxFrame,_minFrame;
+		int _numThreads;
 	public:
 		HLSearch(const UAlbertaBot::HLSearch &) = delete;
 		HLSearch();
 		~HLSearch();
 		long long search(double timeLimit, int frameLimit, int maxHeight);
+		void setThreads(int numThreads);
 
 		//std::vector<Squad> getSquads(const std::set<BWAPI::UnitInterface*> & combatUnits);//get Squads and orders
 		//std::set<BWAPI::UnitInterface*> getScouts();
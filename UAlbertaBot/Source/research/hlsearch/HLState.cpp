@@ -606,10 +606,10 @@ void HLState::forwardCombat(const std::array<std::vector<int>,2 > &squadIndex, i
 	}
 	CombatSimulation sim;
 	SparCraft::GameState state;
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
-	static std::uniform_int_distribution<> X(100,200);
-	static std::uniform_int_distribution<> Y(-200, 200);
+	//one generator per thread, root moves can be forwarded in parallel
+	thread_local std::mt19937 gen(std::random_device{}());
+	std::uniform_int_distribution<> X(100,200);
+	std::uniform_int_distribution<> Y(-200, 200);
 	for (int p = 0; p < 2; p++)
 	{
 		UAB_ASSERT(!squadIndex[p].empty(), "Adding no squads!");
@@ -1058,6 +1058,25 @@ std::string HLMove::toString() const
 	return ss.str();
 }
 
+//approximate bytes owned by this state, used to keep the search cache within its budget
+size_t HLState::getMemoryEstimate() const
+{
+	const size_t nodeOverhead = 4 * sizeof(void*);//hash map and tree nodes
+	const size_t workerMaps = 12;//each worker has an entry in about this many WorkerData maps
+	size_t bytes = sizeof(HLState);
+	for (int p = 0; p < 2; p++)
+	{
+		bytes += _squad[p].capacity()*sizeof(HLSquad);
+		for (const auto &squad : _squad[p])
+		{
+			bytes += std::distance(squad.begin(), squad.end())*(sizeof(UnitInfo) + nodeOverhead);
+		}
+		bytes += _unitData[p].getUnits().size()*(sizeof(UnitInfo) + nodeOverhead);
+		bytes += _workerData[p].getNumWorkers()*workerMaps*(2 * sizeof(void*) + nodeOverhead);
+	}
+	return bytes;
+}
+
 int HLState::currentFrame() const
 {
 	return std::min(_state[0].getCurrentFrame(), _state[1].getCurrentFrame());
@@ -94,6 +94,7 @@ namespace UAlbertaBot{
 		std::vector<HLMove> getMoves(int playerID) const;
 		void applyAndForward(int depth, int frames, const std::array<HLMove, 2> &moves);
 		int evaluate(int playerID) const;
+		size_t getMemoryEstimate() const;
 		bool gameOver() const;
 		friend class HLSearch;
 		int currentFrame() const;
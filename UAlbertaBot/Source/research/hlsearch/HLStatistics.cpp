@@ -11,8 +11,8 @@ HLStatistics::HLStatistics() {
 }
 
 std::string HLStatistics::toString() const{
-	char buff[80];
-	sprintf_s(buff, 80, "%6.3f [%10d %.2e %5d %5d %5d %5d %5.3f %5.1f]",
+	char buff[128];
+	sprintf_s(buff, 128, "%6.3f [%10d %.2e %5d %5d %5d %5d %5.3f %6.1f %6d %5.3f %5.1f]",
 		getRunningTimeMilliSecs() / 1000.0,
 		getNodeCount(),
 		getNodesSec(),
@@ -20,10 +20,13 @@ std::string HLStatistics::toString() const{
 		getTTfound(),
 		getCacheQueries(),
 		getCacheFound(),
+		getCacheHitRate(),
+		getCacheBytes() / (1024.0 * 1024.0),
+		getCacheEvictions(),
 		getAvgBf(),
 		getAvgFwd());
 	return buff;
 }
 std::string HLStatistics::header() const {
-	return "Time       nodes    nodes/sec TtQ	TtF	CacheQ	CacheF  AvgBF	AvgFwd";
+	return "Time       nodes    nodes/sec TtQ	TtF	CacheQ	CacheF  CacheHit CacheMB CacheEv AvgBF	AvgFwd";
 }
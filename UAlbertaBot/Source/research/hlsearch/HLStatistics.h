@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <chrono>
 #include <string>
 
@@ -7,16 +8,19 @@ namespace UAlbertaBot{
 	{
 	private:
 		std::chrono::time_point<std::chrono::high_resolution_clock>  startTime;
-		int nodeCount;
-		int TTqueries;
-		int TTfound;
-		int cacheQueries;
-		int cacheFound;
-		int branches;
-		int searches;
+		//counters are shared by the root search threads
+		std::atomic<int> nodeCount;
+		std::atomic<int> TTqueries;
+		std::atomic<int> TTfound;
+		std::atomic<int> cacheQueries;
+		std::atomic<int> cacheFound;
+		std::atomic<size_t> cacheBytes;
+		std::atomic<int> cacheEvictions;
+		std::atomic<int> branches;
+		std::atomic<int> searches;
 		//int hashCol;
-		int forwardLength;
-		int numForwards;
+		std::atomic<int> forwardLength;
+		std::atomic<int> numForwards;
 	public:
 		HLStatistics();
 		void clear(){
@@ -25,6 +29,8 @@ namespace UAlbertaBot{
 			TTfound = 0;
 			cacheQueries = 0;
 			cacheFound = 0;
+			cacheBytes = 0;
+			cacheEvictions = 0;
 			branches = 0;
 			searches = 0;
 			forwardLength = 0;
@@ -48,7 +54,7 @@ namespace UAlbertaBot{
 			return nodeCount;
 		}
 		double getNodesSec() const{
-			return ((float)nodeCount) / getRunningTimeMilliSecs()*1000.0;
+			return ((float)nodeCount.load()) / getRunningTimeMilliSecs()*1000.0;
 		}
 		void incTTquery(){
 			TTqueries++;
@@ -74,6 +80,19 @@ namespace UAlbertaBot{
 		int getCacheFound() const{
 			return cacheFound;
 		}
+		float getCacheHitRate() const{
+			return cacheQueries>0 ? ((float)cacheFound.load()) / cacheQueries.load() : 0.0f;
+		}
+		void setCacheUsage(size_t bytes, int evictions){
+			cacheBytes = bytes;
+			cacheEvictions = evictions;
+		}
+		size_t getCacheBytes() const{
+			return cacheBytes;
+		}
+		int getCacheEvictions() const{
+			return cacheEvictions;
+		}
 
 		void addFwd(int length){
 			forwardLength += length;
@@ -85,11 +104,11 @@ namespace UAlbertaBot{
 		}
 		float getAvgBf() const{
 
-			return searches>0?((float)branches) / searches:-1.0f;
+			return searches>0?((float)branches.load()) / searches.load():-1.0f;
 		}
 		float getAvgFwd() const{
 
-			return numForwards>0 ? ((float)forwardLength) / numForwards : -1.0f;
+			return numForwards>0 ? ((float)forwardLength.load()) / numForwards.load() : -1.0f;
 		}
 		std::string toString() const;
 		std::string header() const;
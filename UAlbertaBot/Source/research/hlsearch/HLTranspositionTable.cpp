@@ -2,7 +2,7 @@
 
 using namespace UAlbertaBot;
 
-HLTranspositionTable::HLTranspositionTable(int size) :_size(size), _entries(new HLEntry[size])
+HLTranspositionTable::HLTranspositionTable(int size) :_size(size), _entries(new std::shared_ptr<const HLEntry>[size])
 {
 }
 
@@ -10,58 +10,46 @@ HLTranspositionTable::HLTranspositionTable(int size) :_size(size), _entries(new
 HLTranspositionTable::~HLTranspositionTable()
 {
 }
-void HLTranspositionTable::store(const HLState &origState, const HLMove &bestMove, int value, int alpha, int beta, int height)
+void HLTranspositionTable::store(unsigned int hash, const HLMove &bestMove, int value, int alpha, int beta, int height)
 {
-	unsigned int hash = origState.getHash();
+	std::shared_ptr<HLEntry> entry = std::make_shared<HLEntry>();
 
-	_entries[hash%_size]._bestMove = bestMove;
-	_entries[hash%_size]._hash = hash;
-	_entries[hash%_size]._value = value;
-	_entries[hash%_size]._height = height;
+	entry->_bestMove = bestMove;
+	entry->_hash = hash;
+	entry->_value = value;
+	entry->_height = height;
 	if (value <= alpha){
-		_entries[hash%_size]._exact = false;
-		_entries[hash%_size]._upper = true;
+		entry->_exact = false;
+		entry->_upper = true;
 	}
 	else if (value >= beta){
-		_entries[hash%_size]._exact = false;
-		_entries[hash%_size]._upper = false;
+		entry->_exact = false;
+		entry->_upper = false;
 	}
 	else{
-		_entries[hash%_size]._exact = true;
-		_entries[hash%_size]._upper = false;
+		entry->_exact = true;
+		entry->_upper = false;
 	}
+	std::atomic_store(&_entries[hash%_size], std::shared_ptr<const HLEntry>(entry));
+}
+void HLTranspositionTable::store(const HLState &origState, const HLMove &bestMove, int value, int alpha, int beta, int height)
+{
+	store(origState.getHash(), bestMove, value, alpha, beta, height);
 }
 void HLTranspositionTable::store(const HLState &origState, int depth, const HLMove &move, const HLMove &bestMove, int value, int alpha, int beta, int height)
 {
-	unsigned int hash = origState.getHash(depth, move);
-
-	_entries[hash%_size]._bestMove = bestMove;
-	_entries[hash%_size]._hash = hash;
-	_entries[hash%_size]._value = value;
-	_entries[hash%_size]._height = height;
-	if (value <= alpha){
-		_entries[hash%_size]._exact = false;
-		_entries[hash%_size]._upper = true;
-	}
-	else if (value >= beta){
-		_entries[hash%_size]._exact = false;
-		_entries[hash%_size]._upper = false;
-	}
-	else{
-		_entries[hash%_size]._exact = true;
-		_entries[hash%_size]._upper = false;
-	}
+	store(origState.getHash(depth, move), bestMove, value, alpha, beta, height);
 }
-const HLEntry& HLTranspositionTable::lookup(const HLState &state, int depth, const HLMove &move)
+std::shared_ptr<const HLEntry> HLTranspositionTable::lookup(const HLState &state, int depth, const HLMove &move) const
 {
-	return _entries[state.getHash(depth, move) % _size];
+	return std::atomic_load(&_entries[state.getHash(depth, move) % _size]);
 }
-const HLEntry& HLTranspositionTable::lookup(const HLState &state)
+std::shared_ptr<const HLEntry> HLTranspositionTable::lookup(const HLState &state) const
 {
-	return _entries[state.getHash() % _size];
+	return std::atomic_load(&_entries[state.getHash() % _size]);
 }
 
-HLCacheTable::HLCacheTable(int size) : _size(size), _entries(new HLCacheEntry[size])
+HLCacheTable::HLCacheTable(size_t byteBudget, int slots) : _entries(slots), _byteBudget(byteBudget), _bytesUsed(0), _evictHand(0), _evictions(0)
 {
 
 }
@@ -69,13 +57,64 @@ HLCacheTable::~HLCacheTable()
 {
 
 }
-void HLCacheTable::store(const HLState &origState, int depth, const std::array < HLMove, 2 > &movePair, const HLState &newState)
+void HLCacheTable::evict(HLCacheEntry &entry, bool countEviction)
+{
+	if (entry._state)
+	{
+		_bytesUsed -= entry._bytes;
+		if (countEviction)
+		{
+			_evictions++;
+		}
+	}
+	entry = HLCacheEntry();
+}
+void HLCacheTable::store(const HLState &origState, int depth, const std::array < HLMove, 2 > &movePair, const std::shared_ptr<const HLState> &newState)
 {
 	unsigned int hash = origState.getHash(depth, movePair);
-	_entries[hash%_size]._hash = hash;
-	_entries[hash%_size]._state = newState;
+	size_t bytes = newState->getMemoryEstimate();
+	if (bytes > _byteBudget)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_lock);
+	HLCacheEntry &entry = _entries[hash%_entries.size()];
+
+	//replacing the same key's older state isn't an eviction
+	evict(entry, entry._hash != hash || entry._parentFrame != origState.currentFrame());
+
+	//free other slots in order until the new state fits in the budget
+	while (_bytesUsed + bytes > _byteBudget)
+	{
+		evict(_entries[_evictHand], true);
+		_evictHand = (_evictHand + 1) % _entries.size();
+	}
+
+	entry._state = newState;
+	entry._hash = hash;
+	entry._parentFrame = origState.currentFrame();
+	entry._bytes = bytes;
+	_bytesUsed += bytes;
+}
+std::shared_ptr<const HLState> HLCacheTable::lookup(const HLState &state, int depth, const std::array < HLMove, 2 > &movePair) const
+{
+	unsigned int hash = state.getHash(depth, movePair);
+	std::lock_guard<std::mutex> lock(_lock);
+	const HLCacheEntry &entry = _entries[hash%_entries.size()];
+	if (entry._state && entry._hash == hash && entry._parentFrame == state.currentFrame())
+	{
+		return entry._state;
+	}
+	return nullptr;
+}
+size_t HLCacheTable::getBytesUsed() const
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _bytesUsed;
 }
-const HLCacheEntry& HLCacheTable::lookup(const HLState &state, int depth, const std::array < HLMove, 2 > &movePair)
+int HLCacheTable::getEvictions() const
 {
-	return _entries[state.getHash(depth, movePair) % _size];
+	std::lock_guard<std::mutex> lock(_lock);
+	return _evictions;
 }
\ No newline at end of file
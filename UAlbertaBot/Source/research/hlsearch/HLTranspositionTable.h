@@ -1,5 +1,6 @@
 #pragma once
 #include "HLState.h"
+#include <mutex>
 
 namespace UAlbertaBot
 {
@@ -11,32 +12,46 @@ namespace UAlbertaBot
 		bool _exact;
 		bool _upper;
 	};
+	//entries are replaced whole and read through atomic shared_ptr operations, so the root
+	//search threads can share the table without a lock and never see a half written entry
 	class HLTranspositionTable
 	{
 		int _size;
-		std::unique_ptr<HLEntry[]> _entries;
+		std::unique_ptr<std::shared_ptr<const HLEntry>[]> _entries;
+		void store(unsigned int hash, const HLMove &bestMove, int value, int alpha, int beta, int height);
 	public:
 		HLTranspositionTable(int size);
 		~HLTranspositionTable();
 		void store(const HLState &origState, const HLMove &bestMove, int value, int alpha, int beta, int height);
 		void store(const HLState &origState, int depth, const HLMove &move, const HLMove &bestMove, int value, int alpha, int beta, int height);
-		const HLEntry& lookup(const HLState &state, int depth, const HLMove &move);
-		const HLEntry& lookup(const HLState &state);
+		//empty if the slot was never written, callers still have to compare the hash
+		std::shared_ptr<const HLEntry> lookup(const HLState &state, int depth, const HLMove &move) const;
+		std::shared_ptr<const HLEntry> lookup(const HLState &state) const;
 	};
 
+	//forwarded states are shared with the search instead of copied in and out of the table
 	struct HLCacheEntry{
-		HLState _state;
-		unsigned int _hash;
+		std::shared_ptr<const HLState> _state;
+		unsigned int _hash = 0;
+		int _parentFrame = -1;	//second check against hash collisions
+		size_t _bytes = 0;
 	};
 	class HLCacheTable
 	{
-		int _size;
-		std::unique_ptr<HLCacheEntry[]> _entries;
+		mutable std::mutex _lock;	//eviction touches other slots, so the whole table is locked
+		std::vector<HLCacheEntry> _entries;
+		size_t _byteBudget;
+		size_t _bytesUsed;
+		size_t _evictHand;		//next slot to evict when over budget
+		int _evictions;			//entries of other keys dropped to make room, not overwrites of the same key
+		void evict(HLCacheEntry &entry, bool countEviction);
 	public:
-		HLCacheTable(int size);
+		HLCacheTable(size_t byteBudget, int slots);
 		~HLCacheTable();
-		void store(const HLState &origState, int depth, const std::array < HLMove, 2 > &movePair, const HLState &newState);
-		const HLCacheEntry& lookup(const HLState &state, int depth, const std::array < HLMove, 2 > &movePair);
+		void store(const HLState &origState, int depth, const std::array < HLMove, 2 > &movePair, const std::shared_ptr<const HLState> &newState);
+		std::shared_ptr<const HLState> lookup(const HLState &state, int depth, const std::array < HLMove, 2 > &movePair) const;
+		size_t getBytesUsed() const;
+		int getEvictions() const;
 	};
 
 }
\ No newline at end of file
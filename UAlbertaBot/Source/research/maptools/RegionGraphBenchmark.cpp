@@ -0,0 +1,186 @@
+// Ground distance benchmark for the region graph, built as its own executable. No StarCraft game
+// is needed.
+//
+// Usage: RegionGraphBenchmark [mapFile.txt] [queries] [seed] [regionSize]
+//
+// Asks for the ground distance between random pairs of walkable tiles on the map (a StarDraftMap
+// text file saved by MapTools::saveMapToFile, or a generated map when none is given) through the
+// region graph, with and without exact refinement, and through a full BFS from the destination
+// like DistanceMap does. Exact distances have to match the BFS, graph distances are reported by
+// how far over the BFS distance they are.
+
+#include "../../stardraft/RegionGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+// open ground with a few long cliffs, each with a choke or two, and some scattered rocks
+static std::vector<char> GeneratedMap(int width, int height, std::mt19937 &rng)
+{
+	std::vector<char> walkable(width * height, 1);
+
+	for (int cliff = 0; cliff < 12; ++cliff)
+	{
+		const bool horizontal = rng() % 2 == 0;
+		const int along = (int)(rng() % (horizontal ? height : width));
+		const int length = horizontal ? width : height;
+		const int choke = (int)(rng() % length);
+
+		for (int i = 0; i < length; ++i)
+		{
+			if (std::abs(i - choke) <= 1)
+			{
+				continue;
+			}
+
+			const int x = horizontal ? i : along;
+			const int y = horizontal ? along : i;
+			walkable[y * width + x] = 0;
+		}
+	}
+
+	for (int rock = 0; rock < width * height / 64; ++rock)
+	{
+		const int x = (int)(rng() % (width - 3));
+		const int y = (int)(rng() % (height - 3));
+		for (int r = 0; r < 9; ++r)
+		{
+			walkable[(y + r / 3) * width + x + r % 3] = 0;
+		}
+	}
+
+	return walkable;
+}
+
+// 4-directional BFS distances from the start tile, -1 where it can't be reached
+static void FullBFS(int width, int height, const std::vector<char> &walkable, int start, std::vector<int> &dist, std::vector<int> &fringe)
+{
+	const int actionX[4] = { 1, -1, 0, 0 };
+	const int actionY[4] = { 0, 0, 1, -1 };
+
+	std::fill(dist.begin(), dist.end(), -1);
+	fringe.clear();
+	fringe.push_back(start);
+	dist[start] = 0;
+
+	for (size_t f = 0; f < fringe.size(); ++f)
+	{
+		for (int a = 0; a < 4; ++a)
+		{
+			const int x = fringe[f] % width + actionX[a];
+			const int y = fringe[f] / width + actionY[a];
+			if (x < 0 || y < 0 || x >= width || y >= height || !walkable[y * width + x] || dist[y * width + x] != -1)
+			{
+				continue;
+			}
+
+			dist[y * width + x] = dist[fringe[f]] + 1;
+			fringe.push_back(y * width + x);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const int queries = argc > 2 ? std::max(1, atoi(argv[2])) : 1000;
+	std::mt19937 rng(argc > 3 ? atoi(argv[3]) : 1);
+	const int regionSize = argc > 4 ? std::max(2, atoi(argv[4])) : RegionGraph::DefaultRegionSize;
+
+	int width = 256, height = 256;
+	std::vector<char> walkable;
+
+	if (argc > 1)
+	{
+		const StarDraftMap map(argv[1]);
+		width = (int)map.width();
+		height = (int)map.height();
+		walkable.resize(width * height);
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				walkable[y * width + x] = map.isWalkable(x, y);
+			}
+		}
+	}
+	else
+	{
+		walkable = GeneratedMap(width, height, rng);
+	}
+
+	std::vector<int> walkableTiles;
+	for (int tile = 0; tile < width * height; ++tile)
+	{
+		if (walkable[tile])
+		{
+			walkableTiles.push_back(tile);
+		}
+	}
+
+	if (walkableTiles.empty())
+	{
+		std::cerr << "No walkable tiles in " << (argc > 1 ? argv[1] : "the generated map") << "\n";
+		return 1;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	const RegionGraph graph(width, height, walkable, regionSize);
+	const double buildMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::vector<int> dist(width * height), fringe;
+	fringe.reserve(width * height);
+	double bfsMS = 0, graphMS = 0, exactMS = 0, totalError = 0, maxError = 0;
+	size_t mismatches = 0, connected = 0, exactGraph = 0;
+
+	for (int q = 0; q < queries; ++q)
+	{
+		const int src = walkableTiles[rng() % walkableTiles.size()];
+		const int dest = walkableTiles[rng() % walkableTiles.size()];
+		const int sx = src % width, sy = src / width, dx = dest % width, dy = dest / width;
+
+		start = std::chrono::steady_clock::now();
+		FullBFS(width, height, walkable, dest, dist, fringe);
+		bfsMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		const int bfsDist = dist[src];
+
+		start = std::chrono::steady_clock::now();
+		const int graphDist = graph.getDistance(sx, sy, dx, dy);
+		graphMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		const int exactDist = graph.getExactDistance(sx, sy, dx, dy);
+		exactMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (exactDist != bfsDist || (graphDist < 0) != (bfsDist < 0) || graphDist < bfsDist)
+		{
+			mismatches++;
+			continue;
+		}
+
+		if (bfsDist <= 0)
+		{
+			continue;
+		}
+
+		const double error = (double)(graphDist - bfsDist) / bfsDist;
+		totalError += error;
+		maxError = std::max(maxError, error);
+		exactGraph += graphDist == bfsDist;
+		connected++;
+	}
+
+	connected = std::max((size_t)1, connected);
+	std::cout << "Map:                  " << width << "x" << height << ", " << walkableTiles.size() << " walkable tiles\n";
+	std::cout << "Region graph:         " << graph.numNodes() << " chokes in " << regionSize << "x" << regionSize << " regions, built in " << buildMS << " ms\n";
+	std::cout << "Full BFS:             " << bfsMS * 1000 / queries << " us per query\n";
+	std::cout << "Graph distance:       " << graphMS * 1000 / queries << " us per query\n";
+	std::cout << "Exact distance:       " << exactMS * 1000 / queries << " us per query\n";
+	std::cout << "Graph error:          " << 100 * totalError / connected << "% mean, " << 100 * maxError << "% max, " << 100.0 * exactGraph / connected << "% exact\n";
+	std::cout << "Mismatched queries:   " << mismatches << "\n";
+
+	return mismatches == 0 ? 0 : 1;
+}
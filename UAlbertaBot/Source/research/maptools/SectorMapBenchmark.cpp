@@ -0,0 +1,201 @@
+// Incremental connectivity benchmark, built as its own executable together with SectorMap.cpp.
+// No StarCraft game is needed.
+//
+// Usage: SectorMapBenchmark [mapFile.txt] [events] [seed]
+//
+// Places and removes random buildings on the map (a StarDraftMap text file saved by
+// MapTools::saveMapToFile, or a generated map when none is given) and updates a SectorMap after
+// every event. The update time is compared to a full flood fill of the map per event, and the
+// sectors are checked against the flood fill after every event.
+
+#include "..\..\SectorMap.h"
+#include "..\..\stardraft\StarDraftMap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace UAlbertaBot;
+
+struct Building
+{
+	int x, y, width, height;
+};
+
+// open ground with a few long cliffs, each with a choke or two
+static std::vector<char> GeneratedMap(int width, int height, std::mt19937 &rng)
+{
+	std::vector<char> walkable(width * height, 1);
+
+	for (int cliff = 0; cliff < 12; ++cliff)
+	{
+		const bool horizontal = rng() % 2 == 0;
+		const int along = (int)(rng() % (horizontal ? height : width));
+		const int length = horizontal ? width : height;
+		const int choke = (int)(rng() % length);
+
+		for (int i = 0; i < length; ++i)
+		{
+			if (std::abs(i - choke) <= 1)
+			{
+				continue;
+			}
+
+			const int x = horizontal ? i : along;
+			const int y = horizontal ? along : i;
+			walkable[y * width + x] = 0;
+		}
+	}
+
+	return walkable;
+}
+
+// every pair of tiles has to agree on being connected, which holds when the sectors map one to one
+static bool SameSectors(const SectorMap &a, const SectorMap &b, int width, int height)
+{
+	std::vector<int> aToB, bToA;
+
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const int sa = a.getSector(x, y);
+			const int sb = b.getSector(x, y);
+			if ((sa == 0) != (sb == 0))
+			{
+				return false;
+			}
+
+			if (sa == 0)
+			{
+				continue;
+			}
+
+			aToB.resize(std::max(aToB.size(), (size_t)sa + 1), 0);
+			bToA.resize(std::max(bToA.size(), (size_t)sb + 1), 0);
+			if ((aToB[sa] != 0 && aToB[sa] != sb) || (bToA[sb] != 0 && bToA[sb] != sa))
+			{
+				return false;
+			}
+
+			aToB[sa] = sb;
+			bToA[sb] = sa;
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	const int events = argc > 2 ? std::max(1, atoi(argv[2])) : 2000;
+	std::mt19937 rng(argc > 3 ? atoi(argv[3]) : 1);
+
+	int width = 128, height = 128;
+	std::vector<char> walkable;
+
+	if (argc > 1)
+	{
+		const StarDraftMap map(argv[1]);
+		width = (int)map.width();
+		height = (int)map.height();
+		walkable.resize(width * height);
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				walkable[y * width + x] = map.isWalkable(x, y);
+			}
+		}
+	}
+	else
+	{
+		walkable = GeneratedMap(width, height, rng);
+	}
+
+	if (width == 0 || height == 0)
+	{
+		std::cerr << "Couldn't load " << argv[1] << "\n";
+		return 1;
+	}
+
+	SectorMap incremental, full;
+	incremental.reset(width, height, walkable);
+
+	std::vector<Building> buildings;
+	double incrementalMS = 0, fullMS = 0;
+	size_t visited = 0, mismatches = 0, blocks = 0, removals = 0;
+
+	for (int e = 0; e < events; ++e)
+	{
+		// build more than is destroyed until the map fills up, like a game does
+		const bool destroy = !buildings.empty() && (rng() % 100 < 35 || buildings.size() > 300);
+		Building building;
+
+		if (destroy)
+		{
+			const size_t b = rng() % buildings.size();
+			building = buildings[b];
+			buildings[b] = buildings.back();
+			buildings.pop_back();
+			removals++;
+		}
+		else
+		{
+			building = { (int)(rng() % width), (int)(rng() % height), 2 + (int)(rng() % 3), 2 + (int)(rng() % 2) };
+
+			// only on open ground, like a real building
+			bool open = building.x + building.width <= width && building.y + building.height <= height;
+			for (int x = building.x; open && x < building.x + building.width; ++x)
+			{
+				for (int y = building.y; open && y < building.y + building.height; ++y)
+				{
+					open = walkable[y * width + x] != 0;
+				}
+			}
+
+			if (!open)
+			{
+				continue;
+			}
+
+			buildings.push_back(building);
+			blocks++;
+		}
+
+		for (int x = building.x; x < building.x + building.width; ++x)
+		{
+			for (int y = building.y; y < building.y + building.height; ++y)
+			{
+				walkable[y * width + x] = destroy;
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		incremental.setWalkable(building.x, building.y, building.width, building.height, destroy);
+		incrementalMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		visited += incremental.getLastVisited();
+
+		start = std::chrono::steady_clock::now();
+		full.reset(width, height, walkable);
+		fullMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (!SameSectors(incremental, full, width, height))
+		{
+			mismatches++;
+		}
+	}
+
+	const size_t updates = std::max((size_t)1, blocks + removals);
+	std::cout << "Map:                  " << width << "x" << height << "\n";
+	std::cout << "Updates:              " << updates << " (" << blocks << " buildings placed, " << removals << " removed)\n";
+	std::cout << "Incremental update:   " << incrementalMS * 1000 / updates << " us, " << visited / updates << " tiles visited\n";
+	std::cout << "Full flood fill:      " << fullMS * 1000 / updates << " us, " << width * height << " tiles\n";
+	std::cout << "Speedup:              " << fullMS / std::max(incrementalMS, 1e-9) << "\n";
+	std::cout << "Mismatched events:    " << mismatches << "\n";
+
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// SparCraft playout benchmark, built as its own executable together with the SparCraft sources.
+// No StarCraft game is needed.
+//
+// Usage: PlayoutBenchmark [states] [unitsPerPlayer] [seed]
+//
+// Plays random battles out with a few pairs of scripts, once through a Game with freshly made
+// players like GameState::evalSim used to and once through a reused SparCraft::Playout, and
+// reports playouts per second for both. Both have to end in the same score.
+
+#include "../../../../SparCraft/source/SparCraft.h"
+#include "../../../../SparCraft/source/Playout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace SparCraft;
+
+static GameState RandomBattle(size_t unitsPerPlayer, std::mt19937 &rng)
+{
+	const BWAPI::UnitType types[] =
+	{
+		BWAPI::UnitTypes::Protoss_Zealot,
+		BWAPI::UnitTypes::Protoss_Dragoon,
+		BWAPI::UnitTypes::Terran_Marine,
+		BWAPI::UnitTypes::Terran_Vulture,
+		BWAPI::UnitTypes::Zerg_Zergling,
+		BWAPI::UnitTypes::Zerg_Hydralisk
+	};
+
+	GameState state;
+	for (size_t p(0); p < Constants::Num_Players; ++p)
+	{
+		const size_t numUnits = 1 + rng() % unitsPerPlayer;
+		for (size_t u(0); u < numUnits; ++u)
+		{
+			const Position pos(300 + (int)p * 250 + (int)(rng() % 120), 300 + (int)(rng() % 240));
+			state.addUnit(types[rng() % 6], p, pos);
+		}
+	}
+
+	return state;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t numStates = argc > 1 ? (size_t)std::max(1, atoi(argv[1])) : 200;
+	const size_t unitsPerPlayer = argc > 2 ? (size_t)std::max(1, std::min(atoi(argv[2]), (int)Constants::Max_Units)) : 12;
+	std::mt19937 rng(argc > 3 ? atoi(argv[3]) : 1);
+
+	SparCraft::init();
+
+	std::vector<GameState> states;
+	for (size_t s(0); s < numStates; ++s)
+	{
+		states.push_back(RandomBattle(unitsPerPlayer, rng));
+	}
+
+	const size_t scriptPairs[][2] =
+	{
+		{ PlayerModels::NOKDPS, PlayerModels::NOKDPS },
+		{ PlayerModels::Kiter, PlayerModels::AttackClosest },
+		{ PlayerModels::AttackWeakest, PlayerModels::KiterDPS }
+	};
+
+	Playout playout;
+	double gameMS = 0, playoutMS = 0;
+	size_t playouts = 0, mismatches = 0;
+
+	for (auto &scripts : scriptPairs)
+	{
+		for (const GameState &state : states)
+		{
+			auto start = std::chrono::steady_clock::now();
+			PlayerPtr p1(AllPlayers::getPlayerPtr(Players::Player_One, scripts[0]));
+			PlayerPtr p2(AllPlayers::getPlayerPtr(Players::Player_Two, scripts[1]));
+			Game game(state, p1, p2, Playout::DefaultMoveLimit);
+			game.play();
+			const ScoreType gameScore = game.getState().evalLTD2(Players::Player_One);
+			gameMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			const StateEvalScore playoutScore = playout.eval(state, Players::Player_One, scripts[0], scripts[1]);
+			playoutMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			mismatches += gameScore != playoutScore.val();
+			playouts++;
+		}
+	}
+
+	std::cout << "Playouts:             " << playouts << " (" << numStates << " states, up to " << unitsPerPlayer << " units per player)\n";
+	std::cout << "Game per playout:     " << playouts / std::max(gameMS, 1e-9) << " playouts per ms\n";
+	std::cout << "Reused Playout:       " << playouts / std::max(playoutMS, 1e-9) << " playouts per ms\n";
+	std::cout << "Speedup:              " << gameMS / std::max(playoutMS, 1e-9) << "\n";
+	std::cout << "Mismatched scores:    " << mismatches << "\n";
+
+	return mismatches == 0 ? 0 : 1;
+}
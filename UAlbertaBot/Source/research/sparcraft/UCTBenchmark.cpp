@@ -0,0 +1,126 @@
+// SparCraft UCT benchmark, built as its own executable together with the SparCraft sources.
+// No StarCraft game is needed.
+//
+// Usage: UCTBenchmark [states] [unitsPerPlayer] [traversals] [maxChildren] [seed]
+//
+// Plays random mirrored battles, where both armies are the same units placed symmetrically,
+// between a plain UCT player and one with progressive widening, RAVE, or both, all searching the
+// same number of traversals, once from each side of every battle. Plain UCT against itself is
+// the first row, as a baseline for the side that moves first. Reports the other player's wins,
+// draws and losses, the sum of its final LTD2 scores, and the time taken.
+
+#include "..\..\..\..\SparCraft\source\SparCraft.h"
+#include "..\..\..\..\SparCraft\source\Playout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace SparCraft;
+
+static GameState RandomBattle(size_t unitsPerPlayer, std::mt19937 &rng)
+{
+	const BWAPI::UnitType types[] =
+	{
+		BWAPI::UnitTypes::Protoss_Zealot,
+		BWAPI::UnitTypes::Protoss_Dragoon,
+		BWAPI::UnitTypes::Terran_Marine,
+		BWAPI::UnitTypes::Terran_Vulture,
+		BWAPI::UnitTypes::Zerg_Zergling,
+		BWAPI::UnitTypes::Zerg_Hydralisk
+	};
+
+	GameState state;
+	const size_t numUnits = 1 + rng() % unitsPerPlayer;
+	for (size_t u(0); u < numUnits; ++u)
+	{
+		const BWAPI::UnitType type = types[rng() % 6];
+		const int x = (int)(rng() % 120), y = 300 + (int)(rng() % 240);
+
+		state.addUnit(type, Players::Player_One, Position(430 - x, y));
+		state.addUnit(type, Players::Player_Two, Position(550 + x, y));
+	}
+
+	return state;
+}
+
+static UCTSearchParameters UCTParams(size_t player, size_t traversals, size_t maxChildren, bool widening, bool rave)
+{
+	UCTSearchParameters params;
+	params.setMaxPlayer(player);
+	params.setCValue(1.6);
+	params.setMaxTraversals(traversals);
+	params.setMaxChildren(maxChildren);
+	params.setMoveOrderingMethod(MoveOrderMethod::ScriptFirst);
+	params.setEvalMethod(EvaluationMethods::Playout);
+	params.setSimScripts(PlayerModels::NOKDPS, PlayerModels::NOKDPS);
+	params.setPlayerToMoveMethod(PlayerToMove::Alternate);
+	params.addOrderedMoveScript(PlayerModels::NOKDPS);
+	params.addOrderedMoveScript(PlayerModels::KiterDPS);
+	params.setProgressiveWidening(widening);
+	params.setRAVE(rave);
+
+	return params;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t numStates = argc > 1 ? (size_t)std::max(1, atoi(argv[1])) : 20;
+	const size_t unitsPerPlayer = argc > 2 ? (size_t)std::max(1, std::min(atoi(argv[2]), (int)Constants::Max_Units)) : 8;
+	const size_t traversals = argc > 3 ? (size_t)std::max(1, atoi(argv[3])) : 500;
+	const size_t maxChildren = argc > 4 ? (size_t)std::max(1, atoi(argv[4])) : 20;
+	std::mt19937 rng(argc > 5 ? atoi(argv[5]) : 1);
+
+	SparCraft::init();
+
+	std::vector<GameState> states;
+	for (size_t s(0); s < numStates; ++s)
+	{
+		states.push_back(RandomBattle(unitsPerPlayer, rng));
+	}
+
+	std::cout << "Games:                " << 2 * numStates << " per row (" << numStates << " mirrored states, up to " << unitsPerPlayer << " units per player)\n";
+	std::cout << "Search:               " << traversals << " traversals, " << maxChildren << " max children\n";
+
+	const struct { const char * name; bool widening, rave; } configs[] =
+	{
+		{ "Plain UCT:            ", false, false },
+		{ "Widening:             ", true,  false },
+		{ "RAVE:                 ", false, true  },
+		{ "Widening + RAVE:      ", true,  true  }
+	};
+
+	for (auto &config : configs)
+	{
+		size_t wins = 0, draws = 0, losses = 0;
+		long long margin = 0;
+		auto start = std::chrono::steady_clock::now();
+
+		for (const GameState &state : states)
+		{
+			for (size_t player(0); player < Constants::Num_Players; ++player)
+			{
+				const bool oneIsTested = player == Players::Player_One;
+				PlayerPtr p1(new Player_UCT(Players::Player_One, UCTParams(Players::Player_One, traversals, maxChildren, oneIsTested && config.widening, oneIsTested && config.rave)));
+				PlayerPtr p2(new Player_UCT(Players::Player_Two, UCTParams(Players::Player_Two, traversals, maxChildren, !oneIsTested && config.widening, !oneIsTested && config.rave)));
+
+				Game game(state, p1, p2, Playout::DefaultMoveLimit);
+				game.play();
+
+				const ScoreType score = game.getState().evalLTD2(player);
+				wins += score > 0;
+				draws += score == 0;
+				losses += score < 0;
+				margin += score;
+			}
+		}
+
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << config.name << wins << " wins, " << draws << " draws, " << losses << " losses, LTD2 margin " << margin << ", " << ms << " ms\n";
+	}
+
+	return 0;
+}
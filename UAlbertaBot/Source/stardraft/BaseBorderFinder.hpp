@@ -3,7 +3,7 @@
 #include "Grid2D.hpp"
 #include "StarDraftMap.hpp"
 #include <algorithm>
-
+#include <limits>
 #include <vector>
 
 // a base is just a rectangle encompassing some portion of the map
@@ -29,115 +29,136 @@ struct Cluster
 };
 
 class BaseBorderFinder
-{    
-    struct Direction { char x = 0, y = 0; };
+{
+    struct Direction { int x = 0, y = 0; };
 
     const StarDraftMap *    m_map = nullptr;
     std::vector<BaseBorder> m_baseBorders;
     Grid2D<int>             m_resourceDist;
     Grid2D<int>             m_resourceClusterLabels;
+    Grid2D<int>             m_owner;        // the resource whose search labeled the tile
     int                     m_maxDepth = 5;
     int                     m_ops = 0;
-    std::vector<Tile>       m_stack;
-    std::vector<Direction>  m_actions = { {0,1}, {0,-1}, {1,0}, {-1,0}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    std::vector<Tile>       m_stack;        // every labeled tile, in the order they were labeled
+    std::vector<Tile>       m_queue;        // the tiles of the current resource search
+    std::vector<bool>       m_repeated;     // whether a resource's tile is listed earlier
+    std::vector<int>        m_parent;
     std::vector<Cluster>    m_resourceClusters;
-    
-    void resourceDistanceBFS(int x, int y)
+
+    // the first four are the forward half used by the union pass
+    Direction               m_actions[8] = { {1, 0}, {0, 1}, {1, 1}, {1, -1}, {-1, 0}, {0, -1}, {-1, -1}, {-1, 1} };
+
+    int findRoot(int resource)
     {
-        m_stack.clear();
+        while (m_parent[resource] != resource)
+        {
+            m_parent[resource] = m_parent[m_parent[resource]];
+            resource = m_parent[resource];
+        }
+
+        return resource;
+    }
+
+    void unite(int a, int b)
+    {
+        a = findRoot(a);
+        b = findRoot(b);
+
+        if (a < b) { m_parent[b] = a; }
+        else if (b < a) { m_parent[a] = b; }
+    }
 
-        m_stack.push_back({x, y});
-        m_resourceDist.set(x, y, 0);
+    // BFS outward from each resource up to m_maxDepth moves. The searches run one after the
+    // other, a search doesn't pass through tiles an earlier one labeled. A resource tile an
+    // earlier search reached keeps its owner, but is searched from again at distance 0.
+    void resourceDistanceBFS()
+    {
+        const std::vector<Tile> & resources = m_map->resourceTiles();
+        m_stack.clear();
+        m_repeated.assign(resources.size(), false);
 
-        // iterate until the current pointer meets the end
-        for (size_t i = 0; i < m_stack.size(); i++)
+        for (size_t r = 0; r < resources.size(); r++)
         {
-            // get a copy of the cell and its distance to avoid future lookups
-            Tile tile = m_stack[i];
-            int dist = m_resourceDist.get(tile.x, tile.y);
+            const Tile start = resources[r];
+
+            // only resource tiles already searched from have distance 0
+            m_repeated[r] = m_resourceDist.get(start.x, start.y) == 0;
+            m_resourceDist.set(start.x, start.y, 0);
+
+            if (m_owner.get(start.x, start.y) == -1)
+            {
+                m_owner.set(start.x, start.y, (int)r);
+                m_stack.push_back(start);
+            }
 
-            // if we've gone far enough away, stop
-            if (dist == m_maxDepth) { return; }
+            m_queue.clear();
+            m_queue.push_back(start);
 
-            // look out in each direction
-            for (size_t a = 0; a < m_actions.size(); a++)
+            // iterate until the current pointer meets the end
+            for (size_t i = 0; i < m_queue.size(); i++)
             {
-                // calculate the child cell
-                Tile next ={tile.x + m_actions[a].x, tile.y + m_actions[a].y};
+                const Tile tile = m_queue[i];
+                const int dist = m_resourceDist.get(tile.x, tile.y);
+
+                // if we've gone far enough away, stop
+                if (dist == m_maxDepth) { break; }
 
-                // if this child is a valid cell we can do stuff with it
-                if (m_map->isValid(next.x, next.y) && m_map->isWalkable(next.x, next.y))
+                for (const Direction & action : m_actions)
                 {
-                    // save the distance to the next cell to avoid another lookup
-                    auto nval = m_resourceDist.get(next.x, next.y);
+                    const Tile next = {tile.x + action.x, tile.y + action.y};
 
-                    // if we haven't seen this cell before
-                    if (nval == -1)
+                    if (m_map->isValid(next.x, next.y) && m_resourceDist.get(next.x, next.y) == -1 && m_map->isWalkable(next.x, next.y))
                     {
-                        // add it to the stack and set the distance
-                        m_stack.emplace_back(next);
-                        m_ops++;
                         m_resourceDist.set(next.x, next.y, dist + 1);
+                        m_owner.set(next.x, next.y, (int)r);
+                        m_queue.push_back(next);
+                        m_stack.push_back(next);
+                        m_ops++;
                     }
                 }
             }
         }
     }
 
-    // this will form a cluster of resource tiles by BFSing from x,y
-    // x, y will be a resource tile of unassigned cluster
-    Cluster resourceClusterFormationBFS(int x, int y, int clusterNumber)
+    // resources whose labeled tiles touch (8-connected) are in the same cluster. only four of
+    // the eight directions are needed since every touching pair is seen from one of its tiles
+    void resourceClusterUnion()
     {
-        m_stack.clear();
-        m_stack.push_back({x, y});
-
-        // the vector of resource tiles for this cluster
-        Cluster cluster;
-
-        // iterate until the current pointer meets the end
-        for (size_t i = 0; i < m_stack.size(); i++)
+        m_parent.resize(m_map->resourceTiles().size());
+        for (size_t r = 0; r < m_parent.size(); r++)
         {
-            // get a copy of the cell and its distance to avoid future lookups
-            Tile tile = m_stack[i];
-
-            if (m_map->isMineral(tile.x, tile.y)) { cluster.minerals.push_back(tile); }
-            if (m_map->isGas(tile.x, tile.y)) { cluster.gas.push_back(tile); }
-            if (m_map->isResource(tile.x, tile.y)) { cluster.allResources.push_back(tile); }
+            m_parent[r] = (int)r;
+        }
 
-            // look out in each direction
-            for (size_t a = 0; a < m_actions.size(); a++)
+        for (const Tile & tile : m_stack)
+        {
+            for (size_t a = 0; a < 4; a++)
             {
-                // calculate the child cell
-                Tile next ={tile.x + m_actions[a].x, tile.y + m_actions[a].y};
+                const Tile next = {tile.x + m_actions[a].x, tile.y + m_actions[a].y};
+                if (!m_map->isValid(next.x, next.y)) { continue; }
 
-                // test the child tile for validity
-                if (m_map->isValid(next.x, next.y) &&               // if this child is a valid cell
-                    m_resourceDist.get(next.x, next.y) != -1 &&     //    and it has a valid distance
-                    m_resourceClusterLabels.get(next.x, next.y) == -1)    //    and it hasn't been given a cluster yet
+                const int nextOwner = m_owner.get(next.x, next.y);
+                if (nextOwner != -1)
                 {
-                    // mark this tile as being part of this cluster
-                    m_resourceClusterLabels.set(next.x, next.y, clusterNumber);
-                    m_stack.emplace_back(next);
-                    m_ops++;
+                    unite(m_owner.get(tile.x, tile.y), nextOwner);
                 }
             }
         }
-
-        return cluster;
     }
 
-
 public:
 
     BaseBorderFinder()
     {
         m_stack.reserve(1024);
+        m_queue.reserve(1024);
     }
 
     BaseBorderFinder(const StarDraftMap & map)
         : m_map(&map)
     {
         m_stack.reserve(1024);
+        m_queue.reserve(1024);
 
         computeBases(map);
     }
@@ -146,25 +167,68 @@ public:
     {
         m_map = &map;
 
+        const std::vector<Tile> & resources = m_map->resourceTiles();
+
         m_baseBorders ={};
+        m_resourceClusters.clear();
         m_resourceDist = Grid2D<int>(m_map->width(), m_map->height(), -1);
         m_resourceClusterLabels = Grid2D<int>(m_map->width(), m_map->height(), -1);
+        m_owner = Grid2D<int>(m_map->width(), m_map->height(), -1);
 
         // Step 1. BFS outward from resources
-        for (auto resourceTile : m_map->resourceTiles())
+        resourceDistanceBFS();
+
+        // Step 2. Union touching resources into clusters, numbered in the order their first
+        //         resource appears in the resource list
+        resourceClusterUnion();
+
+        std::vector<int> rootTiles(resources.size(), 0);
+        for (const Tile & tile : m_stack)
+        {
+            rootTiles[findRoot(m_owner.get(tile.x, tile.y))]++;
+        }
+
+        // A resource whose search labeled no other tile and which touches no other labeled tile
+        // is isolated. The cluster search this replaced never labeled such a tile, so it made a
+        // new one-resource cluster every time the tile came up in the resource list.
+        std::vector<int> clusterOfRoot(resources.size(), -1);
+        for (size_t r = 0; r < resources.size(); r++)
         {
-            resourceDistanceBFS(resourceTile.x, resourceTile.y);
+            const int owner = m_owner.get(resources[r].x, resources[r].y);
+            const int root = findRoot(owner);
+            const bool isolated = rootTiles[root] == 1;
+            const bool newCluster = isolated || clusterOfRoot[root] == -1;
+
+            if (newCluster)
+            {
+                clusterOfRoot[root] = (int)m_resourceClusters.size();
+                m_resourceClusters.emplace_back();
+            }
+            else if (m_repeated[r])
+            {
+                continue;
+            }
+
+            // the cluster search this replaced listed the resource it started from twice whenever the
+            // cluster had more than one tile, which counts towards the 4 minerals a base needs
+            Cluster & cluster = m_resourceClusters[clusterOfRoot[root]];
+            const Tile & tile = resources[r];
+            for (int copies = (newCluster && !isolated) ? 2 : 1; copies > 0; copies--)
+            {
+                if (m_map->isMineral(tile.x, tile.y)) { cluster.minerals.push_back(tile); }
+                if (m_map->isGas(tile.x, tile.y)) { cluster.gas.push_back(tile); }
+                if (m_map->isResource(tile.x, tile.y)) { cluster.allResources.push_back(tile); }
+            }
         }
 
-        // Step 2. Label each resource cluster
-        int clusterNumber = 0;
-        for (auto resourceTile : m_map->resourceTiles())
+        for (const Tile & tile : m_stack)
         {
-            // if this tile has already been clustered skip it 
-            if (m_resourceClusterLabels.get(resourceTile.x, resourceTile.y) != -1) { continue; }
+            const int root = findRoot(m_owner.get(tile.x, tile.y));
 
-            // perform the BFS on this un-clustered resource tile to assign it a cluster number 
-            m_resourceClusters.push_back(resourceClusterFormationBFS(resourceTile.x, resourceTile.y, clusterNumber++));
+            if (rootTiles[root] > 1)
+            {
+                m_resourceClusterLabels.set(tile.x, tile.y, clusterOfRoot[root]);
+            }
         }
 
         // Step 3. Form Base objects out of each cluster, if they are valid
@@ -186,7 +250,7 @@ public:
             m_baseBorders.push_back(border);
         }
     }
-    
+
     const Grid2D<int> & getResourceDist() const
     {
         return m_resourceDist;
@@ -202,4 +266,4 @@ public:
         return m_baseBorders;
     }
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,443 @@
+#pragma once
+
+#include "StarDraftMap.hpp"
+#include "BaseBorderFinder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// A DistanceAtlas holds the 4-directional BFS ground distance fields from a set of
+// source tiles (base locations, start tiles, etc) to every other tile on the map.
+// Fields are held in memory as contiguous row-major uint16 planes, Unreachable where no
+// path exists, and are delta coded on disk (see EncodeField).
+//
+// File layout (little endian):
+//   Header
+//   Tile[numFields] source tiles as int16 x, y pairs
+//   numFields times: uint32 encoded size, then the encoded plane
+class DistanceAtlas
+{
+public:
+
+    static const uint16_t Unreachable = 0xFFFF;
+
+private:
+
+    // encoded plane bytes, see EncodeField
+    enum
+    {
+        RawCode     = 0x00,     // followed by the tile's uint16 value
+        RunCode     = 0x01,     // followed by a count of tiles equal to the previous one
+        StepCode    = 0x80,     // low bits hold up to MaxSteps tiles one more or less than the last
+        MaxSteps    = 6
+    };
+
+    struct Header
+    {
+        char     magic[4]   = {'S', 'D', 'D', 'A'};
+        uint32_t version    = 2;
+        uint32_t width      = 0;
+        uint32_t height     = 0;
+        uint64_t walkHash   = 0;
+        uint32_t numFields  = 0;
+        uint32_t reserved   = 0;
+    };
+
+    struct Direction { int x = 0, y = 0; };
+
+    size_t                  m_width = 0;
+    size_t                  m_height = 0;
+    uint64_t                m_walkHash = 0;
+    std::vector<char>       m_walkable;
+    std::vector<Tile>       m_sources;
+    std::vector<int>        m_fieldIndex;
+    std::vector<uint16_t>   m_fields;
+    bool                    m_modified = false;
+
+    inline size_t index(int x, int y) const
+    {
+        return (size_t)y * m_width + (size_t)x;
+    }
+
+    inline bool isValid(int x, int y) const
+    {
+        return (x >= 0) && (y >= 0) && (x < (int)m_width) && (y < (int)m_height);
+    }
+
+    // FNV-1a over the dimensions and walk grid, so an atlas is only ever reused on the
+    // exact same walkability it was computed from
+    static uint64_t HashWalkable(size_t width, size_t height, const std::vector<char> & walkable)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](uint64_t val) { hash ^= val; hash *= 1099511628211ULL; };
+
+        mix(width);
+        mix(height);
+        for (char w : walkable) { mix(w ? 1 : 0); }
+
+        return hash;
+    }
+
+    // Walkable row-major neighbours in a 4-directional BFS field are exactly one step apart, so
+    // a step code packs up to MaxSteps of them into one byte: the bits below the highest set bit
+    // of the low 7 are the steps in order, 1 for one further and 0 for one closer. Unreachable
+    // tiles code to runs and only the edges of walkable areas need a raw value.
+    static void EncodeField(const uint16_t * field, size_t size, std::vector<uint8_t> & out)
+    {
+        uint16_t prev = 0;
+        for (size_t i = 0; i < size; )
+        {
+            size_t run = 0;
+            while (run < 255 && i + run < size && field[i + run] == prev) { run++; }
+
+            if (run > 0)
+            {
+                out.push_back((uint8_t)RunCode);
+                out.push_back((uint8_t)run);
+                i += run;
+                continue;
+            }
+
+            uint8_t steps = 1;
+            int numSteps = 0;
+            while (numSteps < MaxSteps && i < size && (field[i] == (uint16_t)(prev + 1) || field[i] == (uint16_t)(prev - 1)))
+            {
+                steps = (uint8_t)((steps << 1) | (field[i] == (uint16_t)(prev + 1) ? 1 : 0));
+                prev = field[i++];
+                numSteps++;
+            }
+
+            if (numSteps > 0)
+            {
+                out.push_back((uint8_t)(StepCode | steps));
+                continue;
+            }
+
+            out.push_back((uint8_t)RawCode);
+            out.push_back((uint8_t)(field[i] & 0xFF));
+            out.push_back((uint8_t)(field[i] >> 8));
+            prev = field[i++];
+        }
+    }
+
+    // returns false if the bytes don't decode to exactly size tiles
+    static bool DecodeField(const uint8_t * in, size_t bytes, uint16_t * field, size_t size)
+    {
+        uint16_t prev = 0;
+        size_t i = 0;
+        for (size_t b = 0; b < bytes; )
+        {
+            const uint8_t code = in[b++];
+
+            if (code & StepCode)
+            {
+                int numSteps = MaxSteps;
+                while (numSteps > 0 && !(code & (1 << numSteps))) { numSteps--; }
+
+                if (numSteps == 0 || i + numSteps > size) { return false; }
+
+                for (int step = numSteps - 1; step >= 0; step--)
+                {
+                    prev = (uint16_t)((code & (1 << step)) ? prev + 1 : prev - 1);
+                    field[i++] = prev;
+                }
+            }
+            else if (code == RunCode)
+            {
+                if (b >= bytes || i + in[b] > size) { return false; }
+
+                std::fill(field + i, field + i + in[b], prev);
+                i += in[b++];
+            }
+            else if (code == RawCode)
+            {
+                if (b + 2 > bytes || i >= size) { return false; }
+
+                prev = (uint16_t)(in[b] | (in[b + 1] << 8));
+                field[i++] = prev;
+                b += 2;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return i == size;
+    }
+
+    // BFS from the source tile, writing distances into the given plane
+    void computeField(const Tile & source, uint16_t * field, std::vector<Tile> & fringe) const
+    {
+        static const Direction actions[4] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+        std::fill(field, field + m_width * m_height, (uint16_t)Unreachable);
+
+        if (!isValid(source.x, source.y)) { return; }
+
+        fringe.clear();
+        fringe.push_back(source);
+        field[index(source.x, source.y)] = 0;
+
+        for (size_t i = 0; i < fringe.size(); i++)
+        {
+            const Tile tile = fringe[i];
+            const uint16_t dist = field[index(tile.x, tile.y)];
+
+            for (size_t a = 0; a < 4; a++)
+            {
+                const Tile next = {tile.x + actions[a].x, tile.y + actions[a].y};
+
+                if (isValid(next.x, next.y) && m_walkable[index(next.x, next.y)] && field[index(next.x, next.y)] == Unreachable)
+                {
+                    field[index(next.x, next.y)] = dist + 1;
+                    fringe.push_back(next);
+                }
+            }
+        }
+    }
+
+public:
+
+    DistanceAtlas() {}
+
+    // walkable is a row-major width*height grid, non-zero where ground units can walk
+    DistanceAtlas(size_t width, size_t height, const std::vector<char> & walkable)
+    {
+        reset(width, height, walkable);
+    }
+
+    // builds an atlas over the StarDraftMap walkable tiles with every start tile and
+    // the center of every base border as a source, this is what the offline tools use
+    DistanceAtlas(const StarDraftMap & map, size_t numThreads = 0)
+    {
+        std::vector<char> walkable(map.width() * map.height(), 0);
+        for (size_t y = 0; y < map.height(); y++)
+        {
+            for (size_t x = 0; x < map.width(); x++)
+            {
+                walkable[y * map.width() + x] = map.isWalkable(x, y);
+            }
+        }
+
+        reset(map.width(), map.height(), walkable);
+
+        const BaseBorderFinder borders(map);
+        std::vector<Tile> sources = map.startTiles();
+        for (auto & border : borders.getBaseBorders())
+        {
+            sources.push_back({(border.left + border.right) / 2, (border.top + border.bottom) / 2});
+        }
+
+        computeFields(sources, numThreads);
+    }
+
+    void reset(size_t width, size_t height, const std::vector<char> & walkable)
+    {
+        m_width = width;
+        m_height = height;
+        m_walkable = walkable;
+        m_walkHash = HashWalkable(width, height, walkable);
+        m_sources.clear();
+        m_fields.clear();
+        m_fieldIndex = std::vector<int>(width * height, -1);
+        m_modified = false;
+    }
+
+    // computes the distance field of every source which isn't already in the atlas
+    // the BFS searches are independent so they are split over numThreads threads (0 = all cores)
+    void computeFields(const std::vector<Tile> & sources, size_t numThreads = 0)
+    {
+        std::vector<Tile> newSources;
+        for (auto & source : sources)
+        {
+            if (!isValid(source.x, source.y) || hasField(source.x, source.y)) { continue; }
+
+            m_fieldIndex[index(source.x, source.y)] = (int)(m_sources.size() + newSources.size());
+            newSources.push_back(source);
+        }
+
+        if (newSources.empty()) { return; }
+
+        const size_t planeSize = m_width * m_height;
+        const size_t firstField = m_sources.size();
+        m_sources.insert(m_sources.end(), newSources.begin(), newSources.end());
+        m_fields.resize(m_sources.size() * planeSize);
+        m_modified = true;
+
+        if (numThreads == 0) { numThreads = std::max(1u, std::thread::hardware_concurrency()); }
+        numThreads = std::min(numThreads, newSources.size());
+
+        // each worker pulls the next unclaimed source until all are computed
+        std::atomic<size_t> nextSource(0);
+        auto worker = [&]()
+        {
+            std::vector<Tile> fringe;
+            fringe.reserve(planeSize);
+
+            for (size_t i = nextSource++; i < newSources.size(); i = nextSource++)
+            {
+                computeField(newSources[i], &m_fields[(firstField + i) * planeSize], fringe);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < numThreads; t++)
+        {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    inline size_t width() const
+    {
+        return m_width;
+    }
+
+    inline size_t height() const
+    {
+        return m_height;
+    }
+
+    inline size_t numFields() const
+    {
+        return m_sources.size();
+    }
+
+    inline bool isModified() const
+    {
+        return m_modified;
+    }
+
+    inline const Tile & getSource(size_t field) const
+    {
+        return m_sources[field];
+    }
+
+    inline bool hasField(int x, int y) const
+    {
+        return isValid(x, y) && m_fieldIndex[index(x, y)] != -1;
+    }
+
+    // returns the field index whose source is x, y or -1 if it hasn't been computed
+    inline int getFieldIndex(int x, int y) const
+    {
+        return isValid(x, y) ? m_fieldIndex[index(x, y)] : -1;
+    }
+
+    // row-major width*height plane of distances for the given field
+    inline const uint16_t * getField(size_t field) const
+    {
+        return &m_fields[field * m_width * m_height];
+    }
+
+    // returns the ground distance in tiles from the field's source to x, y, or -1 if unreachable
+    inline int getDistance(size_t field, int x, int y) const
+    {
+        const uint16_t dist = getField(field)[index(x, y)];
+        return dist == Unreachable ? -1 : dist;
+    }
+
+    bool save(const std::string & path)
+    {
+        FILE * file = fopen(path.c_str(), "wb");
+        if (!file) { return false; }
+
+        Header header;
+        header.width = (uint32_t)m_width;
+        header.height = (uint32_t)m_height;
+        header.walkHash = m_walkHash;
+        header.numFields = (uint32_t)m_sources.size();
+
+        std::vector<int16_t> sources;
+        for (auto & source : m_sources)
+        {
+            sources.push_back((int16_t)source.x);
+            sources.push_back((int16_t)source.y);
+        }
+
+        bool ok = fwrite(&header, sizeof(Header), 1, file) == 1;
+        ok = ok && fwrite(sources.data(), sizeof(int16_t), sources.size(), file) == sources.size();
+
+        std::vector<uint8_t> encoded;
+        for (size_t f = 0; ok && f < m_sources.size(); f++)
+        {
+            encoded.clear();
+            EncodeField(getField(f), m_width * m_height, encoded);
+
+            const uint32_t bytes = (uint32_t)encoded.size();
+            ok = fwrite(&bytes, sizeof(uint32_t), 1, file) == 1;
+            ok = ok && fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+        }
+        fclose(file);
+
+        if (ok) { m_modified = false; }
+        return ok;
+    }
+
+    // loads the fields from a saved atlas, which must have been computed on the same dimensions
+    // and walkable grid that this atlas was reset with. returns false and leaves the atlas
+    // unchanged if the file doesn't exist or doesn't match
+    bool load(const std::string & path)
+    {
+        FILE * file = fopen(path.c_str(), "rb");
+        if (!file) { return false; }
+
+        Header header, expected;
+        const bool headerOk = fread(&header, sizeof(Header), 1, file) == 1
+            && std::equal(header.magic, header.magic + 4, expected.magic)
+            && header.version == expected.version
+            && header.width == m_width
+            && header.height == m_height
+            && header.walkHash == m_walkHash;
+
+        if (!headerOk) { fclose(file); return false; }
+
+        const size_t planeSize = m_width * m_height;
+        std::vector<int16_t> sources(2 * header.numFields);
+        std::vector<uint16_t> fields((size_t)header.numFields * planeSize);
+
+        bool ok = fread(sources.data(), sizeof(int16_t), sources.size(), file) == sources.size();
+
+        // a plane never codes to more than 3 bytes a tile
+        std::vector<uint8_t> encoded;
+        for (size_t f = 0; ok && f < header.numFields; f++)
+        {
+            uint32_t bytes = 0;
+            ok = fread(&bytes, sizeof(uint32_t), 1, file) == 1 && bytes <= 3 * planeSize;
+
+            encoded.resize(bytes);
+            ok = ok && fread(encoded.data(), 1, bytes, file) == bytes;
+            ok = ok && DecodeField(encoded.data(), bytes, &fields[f * planeSize], planeSize);
+        }
+        fclose(file);
+
+        if (!ok) { return false; }
+
+        std::vector<Tile> sourceTiles;
+        std::vector<int> fieldIndex(m_width * m_height, -1);
+        for (size_t i = 0; i < header.numFields; i++)
+        {
+            const Tile source = {sources[2*i], sources[2*i + 1]};
+            if (!isValid(source.x, source.y)) { return false; }
+
+            fieldIndex[index(source.x, source.y)] = (int)i;
+            sourceTiles.push_back(source);
+        }
+
+        m_sources.swap(sourceTiles);
+        m_fieldIndex.swap(fieldIndex);
+        m_fields.swap(fields);
+        m_modified = false;
+        return true;
+    }
+};
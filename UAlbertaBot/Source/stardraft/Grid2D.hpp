@@ -9,7 +9,8 @@ class Grid2D
     size_t m_width = 0;
     size_t m_height = 0;
 
-    std::vector<std::vector<T>> m_grid;
+    // column-major, x * height + y, in one allocation
+    std::vector<T> m_grid;
 
 public:
 
@@ -18,39 +19,39 @@ public:
     Grid2D(size_t width, size_t height, T val)
         : m_width(width)
         , m_height(height)
-        , m_grid(width, std::vector<T>(height, val))
+        , m_grid(width * height, val)
     {
 
     }
 
     T& get(size_t x, size_t y)
     {
-        return m_grid[x][y];
+        return m_grid[x * m_height + y];
     }
 
     T& get(int x, int y)
     {
-        return m_grid[x][y];
+        return m_grid[x * m_height + y];
     }
 
     const T& get(size_t x, size_t y) const
     {
-        return m_grid[x][y];
+        return m_grid[x * m_height + y];
     }
 
     const T& get(int x, int y) const
     {
-        return m_grid[x][y];
+        return m_grid[x * m_height + y];
     }
 
     void set(size_t x, size_t y, T val)
     {
-        m_grid[x][y] = val;
+        m_grid[x * m_height + y] = val;
     }
 
     void set(int x, int y, T val)
     {
-        m_grid[x][y] = val;
+        m_grid[x * m_height + y] = val;
     }
 
     size_t width() const
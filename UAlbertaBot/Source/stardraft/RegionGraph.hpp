@@ -0,0 +1,449 @@
+#pragma once
+
+#include "StarDraftMap.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+// A RegionGraph answers 4-directional ground distance queries between any two tiles without a
+// full map BFS per destination.
+//
+// The map is cut into square regions. Wherever a run of walkable tiles crosses the border between
+// two regions there is a choke, one pair of nodes (one on each side) for a short run and one pair
+// at each end of a long run. The distances between the chokes of a region are precomputed with a
+// BFS inside the region, which makes a graph over the whole map. A query BFSes inside the source
+// and destination regions to reach their chokes and searches the graph in between.
+//
+// Distances found through the graph are the length of a real path, so they are never shorter
+// than the true distance and usually within a few percent of it. The exact query refines that
+// with an A* over the tiles which never expands past the graph distance.
+class RegionGraph
+{
+public:
+
+    static const int DefaultRegionSize = 16;
+
+private:
+
+    struct Direction { int x = 0, y = 0; };
+
+    struct Edge
+    {
+        int node = 0;
+        int cost = 0;
+    };
+
+    struct Node
+    {
+        int tile = 0;                   // row-major tile index
+        int region = 0;
+        std::vector<Edge> edges;
+    };
+
+    int                     m_width = 0;
+    int                     m_height = 0;
+    int                     m_regionSize = DefaultRegionSize;
+    int                     m_regionsX = 0;
+    int                     m_regionsY = 0;
+    std::vector<char>       m_walkable;
+    std::vector<Node>       m_nodes;
+    std::vector<std::vector<int>> m_regionNodes;
+
+    // scratch space for queries, a tile or node is only valid if its stamp is the current one
+    mutable std::vector<int>        m_tileDist;
+    mutable std::vector<uint32_t>   m_tileStamp;
+    mutable std::vector<int>        m_nodeDist;
+    mutable std::vector<uint32_t>   m_nodeStamp;
+    mutable uint32_t                m_stamp = 0;
+    mutable std::vector<int>        m_fringe;
+    mutable std::vector<int>        m_sourceDist;
+    mutable std::vector<int>        m_destDist;
+    mutable std::vector<std::pair<int, int>> m_open;    // binary heap of (f cost, node), smallest on top
+
+    inline int index(int x, int y) const
+    {
+        return y * m_width + x;
+    }
+
+    inline bool isValid(int x, int y) const
+    {
+        return (x >= 0) && (y >= 0) && (x < m_width) && (y < m_height);
+    }
+
+    inline int regionOf(int tile) const
+    {
+        return (tile / m_width / m_regionSize) * m_regionsX + (tile % m_width / m_regionSize);
+    }
+
+    inline int manhattan(int a, int b) const
+    {
+        return std::abs(a % m_width - b % m_width) + std::abs(a / m_width - b / m_width);
+    }
+
+    uint32_t nextStamp() const
+    {
+        if (++m_stamp == 0)
+        {
+            std::fill(m_tileStamp.begin(), m_tileStamp.end(), 0);
+            std::fill(m_nodeStamp.begin(), m_nodeStamp.end(), 0);
+            m_stamp = 1;
+        }
+
+        return m_stamp;
+    }
+
+    int addNode(int tile)
+    {
+        // a tile can be a choke of more than one border, it is still a single node
+        const int region = regionOf(tile);
+        for (int node : m_regionNodes[region])
+        {
+            if (m_nodes[node].tile == tile) { return node; }
+        }
+
+        Node node;
+        node.tile = tile;
+        node.region = region;
+        m_nodes.push_back(node);
+        m_regionNodes[region].push_back((int)m_nodes.size() - 1);
+        return (int)m_nodes.size() - 1;
+    }
+
+    void addChoke(int a, int b)
+    {
+        const int nodeA = addNode(a);
+        const int nodeB = addNode(b);
+
+        Edge edge;
+        edge.cost = 1;
+        edge.node = nodeB;
+        m_nodes[nodeA].edges.push_back(edge);
+        edge.node = nodeA;
+        m_nodes[nodeB].edges.push_back(edge);
+    }
+
+    // walks along one region border, (x, y) + step * i is the tile on the near side and
+    // + across is the tile on the far side
+    void findChokes(int x, int y, Direction step, Direction across, int length)
+    {
+        int runStart = -1;
+
+        for (int i = 0; i <= length; i++)
+        {
+            const int nx = x + step.x * i, ny = y + step.y * i;
+            const bool open = i < length && m_walkable[index(nx, ny)] && m_walkable[index(nx + across.x, ny + across.y)];
+
+            if (open && runStart == -1) { runStart = i; }
+            if (open || runStart == -1) { continue; }
+
+            // short runs get one choke in the middle, long ones one at each end
+            const int runEnd = i - 1;
+            const int ends[2] = { runStart, runEnd };
+            const int middle = (runStart + runEnd) / 2;
+            const bool longRun = runEnd - runStart + 1 >= 6;
+
+            for (int e = 0; e < (longRun ? 2 : 1); e++)
+            {
+                const int at = longRun ? ends[e] : middle;
+                const int near = index(x + step.x * at, y + step.y * at);
+                addChoke(near, near + across.y * m_width + across.x);
+            }
+
+            runStart = -1;
+        }
+    }
+
+    // BFS from a tile which stays inside the given region, distances go in m_tileDist
+    void regionBFS(int start, int region, uint32_t stamp) const
+    {
+        static const Direction actions[4] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+        const int left = (region % m_regionsX) * m_regionSize, top = (region / m_regionsX) * m_regionSize;
+        const int right = std::min(left + m_regionSize, m_width), bottom = std::min(top + m_regionSize, m_height);
+
+        m_fringe.clear();
+        m_fringe.push_back(start);
+        m_tileStamp[start] = stamp;
+        m_tileDist[start] = 0;
+
+        for (size_t i = 0; i < m_fringe.size(); i++)
+        {
+            const int tile = m_fringe[i];
+            const int tx = tile % m_width, ty = tile / m_width;
+
+            for (const Direction & action : actions)
+            {
+                const int nx = tx + action.x, ny = ty + action.y;
+                if (nx < left || ny < top || nx >= right || ny >= bottom) { continue; }
+
+                const int next = index(nx, ny);
+                if (m_walkable[next] && m_tileStamp[next] != stamp)
+                {
+                    m_tileStamp[next] = stamp;
+                    m_tileDist[next] = m_tileDist[tile] + 1;
+                    m_fringe.push_back(next);
+                }
+            }
+        }
+    }
+
+    // distances from a tile to every choke of its region, -1 for the ones it can't reach inside it
+    void chokeDistances(int tile, std::vector<int> & dist) const
+    {
+        const int region = regionOf(tile);
+        const uint32_t stamp = nextStamp();
+        regionBFS(tile, region, stamp);
+
+        dist.clear();
+        for (int node : m_regionNodes[region])
+        {
+            const int chokeTile = m_nodes[node].tile;
+            dist.push_back(m_tileStamp[chokeTile] == stamp ? m_tileDist[chokeTile] : -1);
+        }
+    }
+
+public:
+
+    RegionGraph() {}
+
+    // walkable is a row-major width*height grid, non-zero where ground units can walk
+    RegionGraph(int width, int height, const std::vector<char> & walkable, int regionSize = DefaultRegionSize)
+    {
+        reset(width, height, walkable, regionSize);
+    }
+
+    // the graph over the StarDraftMap walkable tiles, this is what the offline tools use
+    RegionGraph(const StarDraftMap & map, int regionSize = DefaultRegionSize)
+    {
+        std::vector<char> walkable(map.width() * map.height(), 0);
+        for (size_t y = 0; y < map.height(); y++)
+        {
+            for (size_t x = 0; x < map.width(); x++)
+            {
+                walkable[y * map.width() + x] = map.isWalkable(x, y);
+            }
+        }
+
+        reset((int)map.width(), (int)map.height(), walkable, regionSize);
+    }
+
+    void reset(int width, int height, const std::vector<char> & walkable, int regionSize = DefaultRegionSize)
+    {
+        m_width = width;
+        m_height = height;
+        m_regionSize = std::max(2, regionSize);
+        m_regionsX = (width + m_regionSize - 1) / m_regionSize;
+        m_regionsY = (height + m_regionSize - 1) / m_regionSize;
+        m_walkable = walkable;
+        m_nodes.clear();
+        m_regionNodes.assign(m_regionsX * m_regionsY, std::vector<int>());
+        m_tileDist.assign(width * height, 0);
+        m_tileStamp.assign(width * height, 0);
+        m_stamp = 0;
+
+        // chokes across every vertical and horizontal region border
+        for (int rx = 1; rx < m_regionsX; rx++)
+        {
+            for (int ry = 0; ry < m_regionsY; ry++)
+            {
+                const int top = ry * m_regionSize;
+                findChokes(rx * m_regionSize - 1, top, {0, 1}, {1, 0}, std::min(m_regionSize, height - top));
+            }
+        }
+
+        for (int ry = 1; ry < m_regionsY; ry++)
+        {
+            for (int rx = 0; rx < m_regionsX; rx++)
+            {
+                const int left = rx * m_regionSize;
+                findChokes(left, ry * m_regionSize - 1, {1, 0}, {0, 1}, std::min(m_regionSize, width - left));
+            }
+        }
+
+        // precompute the distance between every pair of chokes in the same region
+        std::vector<int> dist;
+        for (size_t region = 0; region < m_regionNodes.size(); region++)
+        {
+            const std::vector<int> & nodes = m_regionNodes[region];
+
+            for (size_t a = 0; a < nodes.size(); a++)
+            {
+                chokeDistances(m_nodes[nodes[a]].tile, dist);
+
+                for (size_t b = 0; b < nodes.size(); b++)
+                {
+                    if (a == b || dist[b] < 0) { continue; }
+
+                    Edge edge;
+                    edge.node = nodes[b];
+                    edge.cost = dist[b];
+                    m_nodes[nodes[a]].edges.push_back(edge);
+                }
+            }
+        }
+
+        m_nodeDist.assign(m_nodes.size(), 0);
+        m_nodeStamp.assign(m_nodes.size(), 0);
+    }
+
+    inline int width() const
+    {
+        return m_width;
+    }
+
+    inline int height() const
+    {
+        return m_height;
+    }
+
+    inline size_t numNodes() const
+    {
+        return m_nodes.size();
+    }
+
+    inline bool isWalkable(int x, int y) const
+    {
+        return isValid(x, y) && m_walkable[index(x, y)];
+    }
+
+    // ground distance in tiles through the graph, or -1 if there is no path
+    int getDistance(int sx, int sy, int dx, int dy) const
+    {
+        if (!isWalkable(sx, sy) || !isWalkable(dx, dy)) { return (sx == dx && sy == dy && isValid(sx, sy)) ? 0 : -1; }
+
+        const int source = index(sx, sy), dest = index(dx, dy);
+        const int sourceRegion = regionOf(source), destRegion = regionOf(dest);
+        int best = -1;
+
+        // inside one region the direct path is a candidate, a path around through other regions may still be shorter
+        if (sourceRegion == destRegion)
+        {
+            const uint32_t stamp = nextStamp();
+            regionBFS(source, sourceRegion, stamp);
+            if (m_tileStamp[dest] == stamp)
+            {
+                best = m_tileDist[dest];
+                if (best == manhattan(source, dest)) { return best; }
+            }
+        }
+
+        chokeDistances(source, m_sourceDist);
+        chokeDistances(dest, m_destDist);
+
+        // A* over the chokes, starting from every choke the source reaches with its BFS distance
+        typedef std::pair<int, int> Entry;
+        const std::greater<Entry> order;
+        const uint32_t stamp = nextStamp();
+        const std::vector<int> & sourceNodes = m_regionNodes[sourceRegion];
+        const std::vector<int> & destNodes = m_regionNodes[destRegion];
+        m_open.clear();
+
+        for (size_t n = 0; n < sourceNodes.size(); n++)
+        {
+            if (m_sourceDist[n] < 0) { continue; }
+
+            m_nodeStamp[sourceNodes[n]] = stamp;
+            m_nodeDist[sourceNodes[n]] = m_sourceDist[n];
+            m_open.push_back({m_sourceDist[n] + manhattan(m_nodes[sourceNodes[n]].tile, dest), sourceNodes[n]});
+        }
+
+        std::make_heap(m_open.begin(), m_open.end(), order);
+
+        while (!m_open.empty())
+        {
+            std::pop_heap(m_open.begin(), m_open.end(), order);
+            const Entry top = m_open.back();
+            m_open.pop_back();
+
+            // the heuristic never overestimates, nothing left in the queue can beat the best path
+            if (best >= 0 && top.first >= best) { break; }
+
+            const Node & node = m_nodes[top.second];
+            const int g = m_nodeDist[top.second];
+            if (top.first > g + manhattan(node.tile, dest)) { continue; }
+
+            if (node.region == destRegion)
+            {
+                for (size_t n = 0; n < destNodes.size(); n++)
+                {
+                    if (destNodes[n] == top.second && m_destDist[n] >= 0 && (best < 0 || g + m_destDist[n] < best))
+                    {
+                        best = g + m_destDist[n];
+                    }
+                }
+            }
+
+            for (const Edge & edge : node.edges)
+            {
+                const int cost = g + edge.cost;
+                if (m_nodeStamp[edge.node] != stamp || cost < m_nodeDist[edge.node])
+                {
+                    m_nodeStamp[edge.node] = stamp;
+                    m_nodeDist[edge.node] = cost;
+                    m_open.push_back({cost + manhattan(m_nodes[edge.node].tile, dest), edge.node});
+                    std::push_heap(m_open.begin(), m_open.end(), order);
+                }
+            }
+        }
+
+        return best;
+    }
+
+    // the exact ground distance, an A* over the tiles that never expands a tile which can't beat
+    // the graph distance, or -1 if there is no path
+    int getExactDistance(int sx, int sy, int dx, int dy) const
+    {
+        static const Direction actions[4] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+        const int bound = getDistance(sx, sy, dx, dy);
+        if (bound <= 0) { return bound; }
+
+        const int source = index(sx, sy), dest = index(dx, dy);
+        if (bound == manhattan(source, dest)) { return bound; }
+
+        // the f costs of a 4-directional grid A* with the manhattan heuristic only take the values
+        // manhattan(source, dest) + 2k, so the open list is a bucket per k
+        const int base = manhattan(source, dest);
+        std::vector<std::vector<int>> buckets((bound - base) / 2 + 1);
+        const uint32_t stamp = nextStamp();
+
+        m_tileStamp[source] = stamp;
+        m_tileDist[source] = 0;
+        buckets[0].push_back(source);
+
+        for (size_t b = 0; b < buckets.size(); b++)
+        {
+            // the last bucket in a bucket is expanded first, which heads deeper along ties
+            while (!buckets[b].empty())
+            {
+                const int tile = buckets[b].back();
+                buckets[b].pop_back();
+
+                const int g = m_tileDist[tile];
+                if (g + manhattan(tile, dest) != base + 2 * (int)b) { continue; }
+                if (tile == dest) { return g; }
+
+                const int tx = tile % m_width, ty = tile / m_width;
+                for (const Direction & action : actions)
+                {
+                    const int nx = tx + action.x, ny = ty + action.y;
+                    if (!isValid(nx, ny)) { continue; }
+
+                    const int next = index(nx, ny);
+                    if (!m_walkable[next] || (m_tileStamp[next] == stamp && m_tileDist[next] <= g + 1)) { continue; }
+
+                    const int f = g + 1 + manhattan(next, dest);
+                    if (f > bound) { continue; }
+
+                    m_tileStamp[next] = stamp;
+                    m_tileDist[next] = g + 1;
+                    buckets[(f - base) / 2].push_back(next);
+                }
+            }
+        }
+
+        return bound;
+    }
+};
@@ -1,4 +1,6 @@
 #pragma once
 
 #include "StarDraftMap.hpp"
-#include "BaseBorderFinder.hpp"
\ No newline at end of file
+#include "BaseBorderFinder.hpp"
+#include "DistanceAtlas.hpp"
+#include "RegionGraph.hpp"
\ No newline at end of file
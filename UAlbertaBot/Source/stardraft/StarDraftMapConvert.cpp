@@ -0,0 +1,120 @@
+// Converts StarDraftMap text files (MapTools::saveMapToFile) to the binary StarDraftMapFile format.
+// Built as its own executable from this file alone, it is not part of the bot.
+//
+// Usage: StarDraftMapConvert mapFile.txt [mapFile.txt ...]
+//
+// Each map is written next to its text file with the .txt replaced by .sdm, then mapped back and
+// compared tile by tile with the text version. Load times of both formats are reported.
+
+#include "StarDraftMapFile.hpp"
+
+#include <chrono>
+#include <iostream>
+
+static double MillisecondsSince(const std::chrono::steady_clock::time_point & start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string BinaryFileName(const std::string & textFile)
+{
+    const size_t dot = textFile.rfind(".txt");
+    return (dot != std::string::npos && dot + 4 == textFile.size() ? textFile.substr(0, dot) : textFile) + ".sdm";
+}
+
+// the walk tiles of a text loaded map hold '0' / '1' characters
+static bool TextWalkable(char walk)
+{
+    return walk != 0 && walk != '0';
+}
+
+static bool SameMap(const StarDraftMap & map, const StarDraftMapView & view)
+{
+    if (map.width() != view.width() || map.height() != view.height()
+        || map.startTiles().size() != view.numStartTiles()
+        || map.resourceTiles().size() != view.numResourceTiles())
+    {
+        return false;
+    }
+
+    for (size_t y = 0; y < map.height(); y++)
+    {
+        for (size_t x = 0; x < map.width(); x++)
+        {
+            if (map.get(x, y) != view.get(x, y)) { return false; }
+        }
+    }
+
+    for (size_t y = 0; y < 4 * map.height(); y++)
+    {
+        for (size_t x = 0; x < 4 * map.width(); x++)
+        {
+            if (TextWalkable(map.getWalk(x, y)) != (view.getWalk(x, y) != 0)) { return false; }
+        }
+    }
+
+    for (size_t i = 0; i < view.numStartTiles(); i++)
+    {
+        if (map.startTiles()[i].x != view.startTiles()[i].x || map.startTiles()[i].y != view.startTiles()[i].y) { return false; }
+    }
+
+    const BaseBorderFinder borders(map);
+    if (borders.getBaseBorders().size() != view.numBaseBorders()) { return false; }
+
+    for (size_t i = 0; i < view.numBaseBorders(); i++)
+    {
+        const BaseBorder & a = borders.getBaseBorders()[i];
+        const BaseBorder & b = view.baseBorders()[i];
+        if (a.left != b.left || a.right != b.right || a.top != b.top || a.bottom != b.bottom) { return false; }
+    }
+
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: StarDraftMapConvert mapFile.txt [mapFile.txt ...]\n";
+        return 1;
+    }
+
+    int failed = 0;
+    double textMS = 0, binaryMS = 0;
+
+    for (int a = 1; a < argc; a++)
+    {
+        const std::string textFile = argv[a];
+        const std::string binaryFile = BinaryFileName(textFile);
+
+        auto start = std::chrono::steady_clock::now();
+        const StarDraftMap map(textFile);
+        textMS += MillisecondsSince(start);
+
+        if (map.width() == 0 || !StarDraftMapFile::Write(map, binaryFile))
+        {
+            std::cerr << textFile << ": couldn't convert\n";
+            failed++;
+            continue;
+        }
+
+        start = std::chrono::steady_clock::now();
+        MappedStarDraftMap mapped(binaryFile);
+        binaryMS += MillisecondsSince(start);
+
+        if (!mapped.isOpen() || !SameMap(map, mapped.view()))
+        {
+            std::cerr << textFile << ": " << binaryFile << " doesn't match the text map\n";
+            failed++;
+            continue;
+        }
+
+        std::cout << binaryFile << ": " << map.width() << "x" << map.height() << ", " << mapped.view().numSectors() << " sectors, "
+                  << mapped.view().numBaseBorders() << " bases\n";
+    }
+
+    std::cout << "Text load:   " << textMS << " ms\n";
+    std::cout << "Binary open: " << binaryMS << " ms\n";
+
+    return failed == 0 ? 0 : 1;
+}
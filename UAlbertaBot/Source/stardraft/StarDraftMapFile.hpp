@@ -0,0 +1,480 @@
+#pragma once
+
+#include "StarDraftMap.hpp"
+#include "BaseBorderFinder.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Binary StarDraftMap format, made to be memory mapped and read in place with StarDraftMapView
+// so tools which load many maps skip the text parse entirely. Along with the tiles it stores the
+// ground connectivity sectors and the BaseBorderFinder base borders, which would otherwise be
+// recomputed on every load.
+//
+// File layout (little endian, every section starts on an 8 byte boundary):
+//   Header
+//   char     build[width * height]           row-major TileType values
+//   char     walk[4*width * 4*height]        row-major, 1 where walkable
+//   uint16   sectors[width * height]         row-major, 0 where not walkable, otherwise the
+//                                            4-connected walkable region the tile belongs to
+//   Tile     startTiles[numStartTiles]
+//   Tile     resourceTiles[numResourceTiles] in StarDraftMap::resourceTiles order
+//   BaseBorder baseBorders[numBaseBorders]
+namespace StarDraftMapFile
+{
+    struct Header
+    {
+        char     magic[4]           = {'S', 'D', 'M', 'F'};
+        uint32_t version            = 1;
+        uint32_t width              = 0;
+        uint32_t height             = 0;
+        uint32_t numStartTiles      = 0;
+        uint32_t numResourceTiles   = 0;
+        uint32_t numBaseBorders     = 0;
+        uint32_t numSectors         = 0;
+        uint64_t buildOffset        = 0;
+        uint64_t walkOffset         = 0;
+        uint64_t sectorOffset       = 0;
+        uint64_t startOffset        = 0;
+        uint64_t resourceOffset     = 0;
+        uint64_t borderOffset       = 0;
+        uint64_t fileSize           = 0;
+    };
+
+    static_assert(sizeof(Header) == 88, "StarDraftMapFile header layout changed");
+    static_assert(sizeof(Tile) == 8 && sizeof(BaseBorder) == 16, "StarDraftMapFile tile layout changed");
+
+    inline uint64_t Padded(uint64_t bytes)
+    {
+        return (bytes + 7) & ~(uint64_t)7;
+    }
+
+    // labels the 4-connected regions of walkable tiles, the same moves DistanceAtlas searches with
+    inline uint32_t ComputeSectors(const StarDraftMap & map, std::vector<uint16_t> & sectors)
+    {
+        const int width = (int)map.width(), height = (int)map.height();
+        const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+
+        sectors.assign((size_t)width * height, 0);
+        std::vector<Tile> fringe;
+        uint32_t numSectors = 0;
+
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                if (sectors[y * width + x] != 0 || !map.isWalkable(x, y)) { continue; }
+
+                // labels past the uint16 range are folded into the last one, no real map gets close
+                numSectors = std::min<uint32_t>(numSectors + 1, 0xFFFF);
+                sectors[y * width + x] = (uint16_t)numSectors;
+                fringe.clear();
+                fringe.push_back({x, y});
+
+                for (size_t i = 0; i < fringe.size(); i++)
+                {
+                    for (int a = 0; a < 4; a++)
+                    {
+                        const Tile next = {fringe[i].x + dx[a], fringe[i].y + dy[a]};
+                        if (map.isValid(next.x, next.y) && sectors[next.y * width + next.x] == 0 && map.isWalkable(next.x, next.y))
+                        {
+                            sectors[next.y * width + next.x] = (uint16_t)numSectors;
+                            fringe.push_back(next);
+                        }
+                    }
+                }
+            }
+        }
+
+        return numSectors;
+    }
+
+    // writes the map, its sectors and its base borders to path
+    inline bool Write(const StarDraftMap & map, const std::string & path)
+    {
+        const size_t width = map.width(), height = map.height();
+        const BaseBorderFinder borders(map);
+
+        Header header;
+        header.width            = (uint32_t)width;
+        header.height           = (uint32_t)height;
+        header.numStartTiles    = (uint32_t)map.startTiles().size();
+        header.numResourceTiles = (uint32_t)map.resourceTiles().size();
+        header.numBaseBorders   = (uint32_t)borders.getBaseBorders().size();
+        header.buildOffset      = Padded(sizeof(Header));
+        header.walkOffset       = Padded(header.buildOffset + width * height);
+        header.sectorOffset     = Padded(header.walkOffset + 16 * width * height);
+        header.startOffset      = Padded(header.sectorOffset + 2 * width * height);
+        header.resourceOffset   = Padded(header.startOffset + sizeof(Tile) * header.numStartTiles);
+        header.borderOffset     = Padded(header.resourceOffset + sizeof(Tile) * header.numResourceTiles);
+        header.fileSize         = Padded(header.borderOffset + sizeof(BaseBorder) * header.numBaseBorders);
+
+        std::vector<uint16_t> sectors;
+        header.numSectors = ComputeSectors(map, sectors);
+
+        std::vector<char> data((size_t)header.fileSize, 0);
+        memcpy(&data[0], &header, sizeof(Header));
+
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                data[header.buildOffset + y * width + x] = map.get(x, y);
+            }
+        }
+
+        // the text format stores walk tiles as '0' / '1' characters, both of which would read as walkable
+        for (size_t y = 0; y < 4 * height; y++)
+        {
+            for (size_t x = 0; x < 4 * width; x++)
+            {
+                const char walk = map.getWalk(x, y);
+                data[header.walkOffset + y * 4 * width + x] = (walk != 0 && walk != '0') ? 1 : 0;
+            }
+        }
+
+        if (!sectors.empty())
+        {
+            memcpy(&data[header.sectorOffset], sectors.data(), 2 * sectors.size());
+        }
+
+        if (header.numStartTiles > 0)
+        {
+            memcpy(&data[header.startOffset], map.startTiles().data(), sizeof(Tile) * header.numStartTiles);
+        }
+
+        if (header.numResourceTiles > 0)
+        {
+            memcpy(&data[header.resourceOffset], map.resourceTiles().data(), sizeof(Tile) * header.numResourceTiles);
+        }
+
+        if (header.numBaseBorders > 0)
+        {
+            memcpy(&data[header.borderOffset], borders.getBaseBorders().data(), sizeof(BaseBorder) * header.numBaseBorders);
+        }
+
+        FILE * file = fopen(path.c_str(), "wb");
+        if (!file) { return false; }
+
+        const bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+        return (fclose(file) == 0) && ok;
+    }
+}
+
+// Read-only StarDraftMap over StarDraftMapFile data held in memory, usually a MappedStarDraftMap.
+// Nothing is copied, the data must stay valid and 8 byte aligned while the view is used.
+class StarDraftMapView
+{
+    const char *                        m_data = nullptr;
+    const StarDraftMapFile::Header *    m_header = nullptr;
+
+    template <class T>
+    inline const T * section(uint64_t offset) const
+    {
+        return reinterpret_cast<const T *>(m_data + offset);
+    }
+
+    inline size_t index(int x, int y) const
+    {
+        return (size_t)y * m_header->width + (size_t)x;
+    }
+
+public:
+
+    StarDraftMapView() {}
+
+    StarDraftMapView(const void * data, size_t size)
+    {
+        reset(data, size);
+    }
+
+    // returns false and leaves the view empty if the data isn't a complete map of this version
+    bool reset(const void * data, size_t size)
+    {
+        m_data = nullptr;
+        m_header = nullptr;
+
+        const StarDraftMapFile::Header expected;
+        const StarDraftMapFile::Header * header = reinterpret_cast<const StarDraftMapFile::Header *>(data);
+        if (!data || size < sizeof(StarDraftMapFile::Header)
+            || memcmp(header->magic, expected.magic, 4) != 0
+            || header->version != expected.version
+            || header->fileSize > size)
+        {
+            return false;
+        }
+
+        // check the sections are where Write puts them, so a corrupt header can't point past the data
+        const uint64_t tiles = (uint64_t)header->width * header->height;
+        const bool layoutOk = header->buildOffset >= sizeof(StarDraftMapFile::Header)
+            && header->walkOffset       >= header->buildOffset + tiles
+            && header->sectorOffset     >= header->walkOffset + 16 * tiles
+            && header->startOffset      >= header->sectorOffset + 2 * tiles
+            && header->resourceOffset   >= header->startOffset + sizeof(Tile) * header->numStartTiles
+            && header->borderOffset     >= header->resourceOffset + sizeof(Tile) * header->numResourceTiles
+            && header->fileSize         >= header->borderOffset + sizeof(BaseBorder) * header->numBaseBorders
+            && (header->sectorOffset % 8) == 0 && (header->startOffset % 8) == 0
+            && (header->resourceOffset % 8) == 0 && (header->borderOffset % 8) == 0;
+
+        if (!layoutOk) { return false; }
+
+        m_data = reinterpret_cast<const char *>(data);
+        m_header = header;
+        return true;
+    }
+
+    inline bool isLoaded() const
+    {
+        return m_header != nullptr;
+    }
+
+    inline size_t width() const
+    {
+        return m_header ? m_header->width : 0;
+    }
+
+    inline size_t height() const
+    {
+        return m_header ? m_header->height : 0;
+    }
+
+    inline bool isValid(int x, int y) const
+    {
+        return (x >= 0) && (x < (int)width()) && (y >= 0) && (y < (int)height());
+    }
+
+    inline char get(int x, int y) const
+    {
+        return section<char>(m_header->buildOffset)[index(x, y)];
+    }
+
+    inline char getWalk(int x, int y) const
+    {
+        return section<char>(m_header->walkOffset)[(size_t)y * 4 * m_header->width + (size_t)x];
+    }
+
+    inline bool isWalkable(int x, int y) const
+    {
+        const char tile = get(x, y);
+        return (tile == TileType::Walk) || (tile == TileType::BuildAll) || (tile == TileType::NoDepot);
+    }
+
+    inline bool canBuild(int x, int y) const
+    {
+        const char tile = get(x, y);
+        return (tile == TileType::BuildAll) || (tile == TileType::NoDepot);
+    }
+
+    inline bool canBuildDepot(int x, int y) const
+    {
+        return get(x, y) == TileType::BuildAll;
+    }
+
+    inline bool isMineral(int x, int y) const
+    {
+        return get(x, y) == TileType::Mineral;
+    }
+
+    inline bool isGas(int x, int y) const
+    {
+        return get(x, y) == TileType::Gas;
+    }
+
+    inline bool isResource(int x, int y) const
+    {
+        return isMineral(x, y) || isGas(x, y);
+    }
+
+    // 0 if x, y isn't walkable, two tiles with the same non-zero sector are connected by ground
+    inline uint16_t getSector(int x, int y) const
+    {
+        return section<uint16_t>(m_header->sectorOffset)[index(x, y)];
+    }
+
+    inline size_t numSectors() const
+    {
+        return m_header ? m_header->numSectors : 0;
+    }
+
+    inline bool isConnected(int x1, int y1, int x2, int y2) const
+    {
+        const uint16_t sector = getSector(x1, y1);
+        return sector != 0 && sector == getSector(x2, y2);
+    }
+
+    inline const Tile * startTiles() const
+    {
+        return section<Tile>(m_header->startOffset);
+    }
+
+    inline size_t numStartTiles() const
+    {
+        return m_header ? m_header->numStartTiles : 0;
+    }
+
+    inline const Tile * resourceTiles() const
+    {
+        return section<Tile>(m_header->resourceOffset);
+    }
+
+    inline size_t numResourceTiles() const
+    {
+        return m_header ? m_header->numResourceTiles : 0;
+    }
+
+    inline const BaseBorder * baseBorders() const
+    {
+        return section<BaseBorder>(m_header->borderOffset);
+    }
+
+    inline size_t numBaseBorders() const
+    {
+        return m_header ? m_header->numBaseBorders : 0;
+    }
+
+    // copies the tiles into a StarDraftMap, for code which needs one rather than a view
+    StarDraftMap toStarDraftMap() const
+    {
+        StarDraftMap map(width(), height());
+
+        // set in resource tile order so the copy lists its resources exactly like the original
+        for (size_t i = 0; i < numResourceTiles(); i++)
+        {
+            map.set(resourceTiles()[i].x, resourceTiles()[i].y, get(resourceTiles()[i].x, resourceTiles()[i].y));
+        }
+
+        for (size_t y = 0; y < height(); y++)
+        {
+            for (size_t x = 0; x < width(); x++)
+            {
+                if (!isResource(x, y)) { map.set(x, y, get(x, y)); }
+            }
+        }
+
+        for (size_t y = 0; y < 4 * height(); y++)
+        {
+            for (size_t x = 0; x < 4 * width(); x++)
+            {
+                map.setWalk(x, y, getWalk(x, y) != 0);
+            }
+        }
+
+        for (size_t i = 0; i < numStartTiles(); i++)
+        {
+            map.addStartTile(startTiles()[i].x, startTiles()[i].y);
+        }
+
+        return map;
+    }
+};
+
+// A StarDraftMapFile mapped read-only into memory. The pages are only read in as tiles are
+// touched, so opening a map costs about the same whatever its size.
+class MappedStarDraftMap
+{
+    const void *        m_data = nullptr;
+    size_t              m_size = 0;
+    StarDraftMapView    m_view;
+
+#ifdef WIN32
+    HANDLE              m_file = INVALID_HANDLE_VALUE;
+    HANDLE              m_mapping = nullptr;
+#endif
+
+public:
+
+    MappedStarDraftMap() {}
+
+    MappedStarDraftMap(const std::string & path)
+    {
+        open(path);
+    }
+
+    ~MappedStarDraftMap()
+    {
+        close();
+    }
+
+    MappedStarDraftMap(const MappedStarDraftMap &) = delete;
+    MappedStarDraftMap & operator = (const MappedStarDraftMap &) = delete;
+
+    // returns false if the file can't be mapped or isn't a StarDraftMapFile
+    bool open(const std::string & path)
+    {
+        close();
+
+#ifdef WIN32
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) { return false; }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) { close(); return false; }
+
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        m_data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        m_size = (size_t)size.QuadPart;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { return false; }
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void * data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            m_data = data == MAP_FAILED ? nullptr : data;
+            m_size = (size_t)info.st_size;
+        }
+
+        // the mapping keeps the file alive on its own
+        ::close(fd);
+#endif
+
+        if (!m_data || !m_view.reset(m_data, m_size))
+        {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void close()
+    {
+        m_view = StarDraftMapView();
+
+#ifdef WIN32
+        if (m_data) { UnmapViewOfFile(m_data); }
+        if (m_mapping) { CloseHandle(m_mapping); }
+        if (m_file != INVALID_HANDLE_VALUE) { CloseHandle(m_file); }
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data) { munmap(const_cast<void *>(m_data), m_size); }
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    inline bool isOpen() const
+    {
+        return m_view.isLoaded();
+    }
+
+    inline const StarDraftMapView & view() const
+    {
+        return m_view;
+    }
+};